@@ -0,0 +1,337 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+/**
+ * @file AnytimeDStarPlanner.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class plans with Anytime D*, lowering the inflation of the heuristic
+ * pass by pass until the path is optimal.
+ * 
+ */
+
+#include "AnytimeDStarPlanner.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+/**
+ * @brief Constructor. The default schedule finds a first path with the
+ *        heuristic inflated by 3 and ends at the optimal one.
+ * @param map_ptr the map with its goal and start set
+ * @return none
+ */
+AnytimeDStarPlanner::AnytimeDStarPlanner(Map *map_ptr)
+    : map_ptr(map_ptr),
+      openlist(map_ptr->GetSize().first, map_ptr->GetSize().second),
+      start(map_ptr->GetStart()),
+      schedule({3.0, 2.0, 1.5, 1.2, 1.0}),
+      epsilon(schedule.front()),
+      bound_epsilon(std::numeric_limits<double>::infinity()) {
+    auto size = map_ptr->GetSize();
+    // one past the index of the last cell of the map
+    auto end_index = map_ptr->CellIndex(
+        std::make_pair(size.first - 1, size.second - 1)) + 1;
+    closed_pass.Assign(end_index, 0);
+}
+
+/**
+ * @brief Set the epsilon of each pass. The next pass starts over from the
+ *        first one.
+ * @param new_schedule strictly decreasing values ending at 1
+ * @return none
+ */
+void AnytimeDStarPlanner::SetEpsilonSchedule(
+        const std::vector<double> &new_schedule) {
+    if (new_schedule.empty() || new_schedule.back() != 1.0)
+        throw std::invalid_argument(
+            "AnytimeDStarPlanner: schedule must end at 1");
+    for (std::size_t i = 1; i < new_schedule.size(); ++i) {
+        if (!(new_schedule[i] < new_schedule[i - 1]))
+            throw std::invalid_argument(
+                "AnytimeDStarPlanner: schedule must decrease");
+    }
+    schedule = new_schedule;
+    schedule_step = 0;
+    optimal = false;
+}
+
+/**
+ * @brief Get the epsilon of each pass.
+ * @return the schedule
+ */
+const std::vector<double> &AnytimeDStarPlanner::EpsilonSchedule() const {
+    return schedule;
+}
+
+/**
+ * @brief Put the goal in the open list and start the schedule over.
+ * @return none
+ */
+void AnytimeDStarPlanner::Initialize() {
+    schedule_step = 0;
+    epsilon = schedule.front();
+    bound_epsilon = std::numeric_limits<double>::infinity();
+    optimal = false;
+    inconsistent.clear();
+    iterations.clear();
+    auto goal_index = map_ptr->CellIndex(map_ptr->GetGoal());
+    map_ptr->UpdateCellRhs(goal_index, 0.0);
+    openlist.Insert(map_ptr->CalculateCellKey(goal_index, epsilon),
+                    map_ptr->GetGoal());
+}
+
+/**
+ * @brief Run one pass at the next epsilon of the schedule. Its path costs
+ *        at most epsilon times the optimal cost.
+ * @return false if the path is already optimal and nothing changed
+ */
+bool AnytimeDStarPlanner::ImprovePath() {
+    if (optimal) return false;
+    auto begin_time = std::chrono::steady_clock::now();
+    epsilon = schedule[schedule_step];
+    PreparePass();
+    auto start_index = map_ptr->CellIndex(start);
+    std::size_t expansions = 0;
+    while (!openlist.Empty() &&
+           (openlist.Top().first <
+                map_ptr->CalculateCellKey(start_index, epsilon) ||
+            map_ptr->CurrentCellRhs(start_index) !=
+                map_ptr->CurrentCellG(start_index))) {
+        auto index = map_ptr->CellIndex(openlist.Pop().second);
+        ++expansions;
+        if (map_ptr->CurrentCellG(index) > map_ptr->CurrentCellRhs(index)) {
+            // Overconsistent: the cell is settled for the rest of the pass
+            map_ptr->UpdateCellG(index, map_ptr->CurrentCellRhs(index));
+            closed_pass.Set(index, pass);
+            map_ptr->ForEachNeighbor(index, [this](const Neighbor &neighbor) {
+                UpdateState(neighbor.index);
+            });
+        } else {
+            map_ptr->UpdateCellG(index, map_ptr->infinity_cost);
+            UpdateState(index);
+            map_ptr->ForEachNeighbor(index, [this](const Neighbor &neighbor) {
+                UpdateState(neighbor.index);
+            });
+        }
+    }
+    std::chrono::duration<double, std::micro> pass_time =
+        std::chrono::steady_clock::now() - begin_time;
+    iterations.push_back(AnytimeIteration{
+        epsilon, expansions, pass_time.count(),
+        map_ptr->CurrentCellG(start_index)});
+    bound_epsilon = epsilon;
+    if (schedule_step + 1 < schedule.size())
+        ++schedule_step;
+    else
+        optimal = true;
+    return true;
+}
+
+/**
+ * @brief Run the passes left in the schedule, down to the optimal path.
+ * @return none
+ */
+void AnytimeDStarPlanner::ComputeShortestPath() {
+    while (ImprovePath()) {}
+}
+
+/**
+ * @brief Run passes until the path is optimal or the deadline has passed.
+ *        A pass is never cut short, and one always runs if the path is not
+ *        optimal, so that the start has a path to follow.
+ * @param deadline the time no new pass starts after
+ * @return none
+ */
+void AnytimeDStarPlanner::ComputeShortestPath(
+        const std::chrono::steady_clock::time_point &deadline) {
+    do {
+        if (!ImprovePath()) return;
+    } while (std::chrono::steady_clock::now() < deadline);
+}
+
+/**
+ * @brief Move the start of the search to the robot's new position. The
+ *        next pass settles it at the current epsilon.
+ * @param new_start the position of the robot
+ * @return none
+ */
+void AnytimeDStarPlanner::MoveStart(const std::pair<int, int> &new_start) {
+    if (new_start == start) return;
+    start = new_start;
+    optimal = false;
+}
+
+/**
+ * @brief Apply a batch of changed cells as DStarLitePlanner::ApplyChanges
+ *        does, and start the schedule over so that the repair finds a path
+ *        fast before it improves it again.
+ * @param changes cells that became blocked or free
+ * @return if any cell really changed
+ */
+bool AnytimeDStarPlanner::ApplyChanges(
+        const std::vector<CellChange> &changes) {
+    auto is_changed = false;
+    affected_vertices.clear();
+    for (auto const &change : changes) {
+        auto index = map_ptr->CellIndex(change.position);
+        if (map_ptr->Blocked(index) == change.blocked) continue;
+        is_changed = true;
+        if (change.blocked) {
+            map_ptr->UpdateStatusCode(index, Map::kObstacle);
+            map_ptr->UpdateCellG(index, map_ptr->infinity_cost);
+            map_ptr->UpdateCellRhs(index, map_ptr->infinity_cost);
+            if (openlist.Find(change.position))
+                openlist.Remove(change.position);
+            map_ptr->ForEachNeighbor(index, [this](const Neighbor &neighbor) {
+                affected_vertices.push_back(neighbor.index);
+            });
+        } else {
+            map_ptr->UpdateStatusCode(index, Map::kFree);
+            affected_vertices.push_back(index);
+        }
+    }
+    if (!is_changed) return false;
+
+    std::sort(affected_vertices.begin(), affected_vertices.end());
+    auto unique_end = std::unique(affected_vertices.begin(),
+                                  affected_vertices.end());
+    for (auto vertex = affected_vertices.begin(); vertex != unique_end;
+         ++vertex) {
+        if (!map_ptr->Blocked(*vertex)) UpdateState(*vertex);
+    }
+    schedule_step = 0;
+    bound_epsilon = std::numeric_limits<double>::infinity();
+    optimal = false;
+    return true;
+}
+
+/**
+ * @brief Find the next position from the current start, the neighbor with
+ *        the smallest cost plus g-value.
+ * @return next position in the path, the start if there is none
+ */
+std::pair<int, int> AnytimeDStarPlanner::NextMove() {
+    if (start == map_ptr->GetGoal()) return start;
+    auto center = map_ptr->CellIndex(start);
+    auto next_index = center;
+    auto cheapest_cost = map_ptr->infinity_cost;
+    map_ptr->ForEachNeighbor(center, [&](const Neighbor &neighbor) {
+        auto cost = CostTraits<double>::Add(
+            neighbor.cost, map_ptr->CurrentCellG(neighbor.index));
+        if (cost < cheapest_cost) {
+            cheapest_cost = cost;
+            next_index = neighbor.index;
+        }
+    });
+    return map_ptr->CellPosition(next_index);
+}
+
+/**
+ * @brief Get the epsilon the current path is bounded by.
+ * @return the epsilon of the last pass, infinity if there is no pass since
+ *         the map changed
+ */
+double AnytimeDStarPlanner::Epsilon() const {
+    return bound_epsilon;
+}
+
+/**
+ * @brief Check whether the path is optimal: the last pass ran at the end of
+ *        the schedule and nothing changed since.
+ * @return true if the path is optimal
+ */
+bool AnytimeDStarPlanner::Optimal() const {
+    return optimal;
+}
+
+/**
+ * @brief Get the current start of the search.
+ * @return the position of the start
+ */
+std::pair<int, int> AnytimeDStarPlanner::CurrentStart() const {
+    return start;
+}
+
+/**
+ * @brief Get the passes run since Initialize, with their epsilon, their
+ *        expansions, their time and the cost of their path.
+ * @return the passes in order
+ */
+const std::vector<AnytimeIteration> &AnytimeDStarPlanner::Iterations() const {
+    return iterations;
+}
+
+/**
+ * @brief Update the rhs-value of a cell and put it where it belongs: in the
+ *        open list if it is inconsistent, or in the inconsistent list if it
+ *        was already closed in this pass.
+ * @param index the index of the cell in the map
+ * @return none
+ */
+void AnytimeDStarPlanner::UpdateState(const int &index) {
+    if (index != map_ptr->CellIndex(map_ptr->GetGoal())) {
+        auto min_rhs = map_ptr->infinity_cost;
+        map_ptr->ForEachNeighbor(index, [&](const Neighbor &neighbor) {
+            auto temp_rhs = CostTraits<double>::Add(
+                neighbor.cost, map_ptr->CurrentCellG(neighbor.index));
+            if (temp_rhs < min_rhs) min_rhs = temp_rhs;
+        });
+        map_ptr->UpdateCellRhs(index, min_rhs);
+    }
+    auto vertex = map_ptr->CellPosition(index);
+    if (openlist.Find(vertex)) openlist.Remove(vertex);
+    if (map_ptr->CurrentCellG(index) == map_ptr->CurrentCellRhs(index)) return;
+    if (closed_pass[index] != pass)
+        openlist.Insert(map_ptr->CalculateCellKey(index, epsilon), vertex);
+    else
+        inconsistent.push_back(index);
+}
+
+/**
+ * @brief Start a pass: move the start of the search, open the cells that
+ *        became inconsistent after they were closed, key the open list with
+ *        the epsilon of the pass and close no cell.
+ * @return none
+ */
+void AnytimeDStarPlanner::PreparePass() {
+    if (map_ptr->GetStart() != start) map_ptr->UpdateStart(start);
+    ++pass;
+    for (auto const &node : openlist.Nodes()) {
+        openlist.UpdateKey(
+            map_ptr->CalculateCellKey(map_ptr->CellIndex(node.second),
+                                      epsilon),
+            node.second);
+    }
+    for (auto const &index : inconsistent) {
+        auto vertex = map_ptr->CellPosition(index);
+        if (map_ptr->Blocked(index) || openlist.Find(vertex) ||
+            map_ptr->CurrentCellG(index) == map_ptr->CurrentCellRhs(index))
+            continue;
+        openlist.Insert(map_ptr->CalculateCellKey(index, epsilon), vertex);
+    }
+    inconsistent.clear();
+}
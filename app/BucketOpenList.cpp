@@ -0,0 +1,383 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file BucketOpenList.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class saves candidate nodes to search in buckets of small indexed
+ * heaps, one bucket per range of the first component of the key.
+ * 
+ */
+
+#include "BucketOpenList.h"
+#include <cmath>
+
+/**
+ * @brief Constructor for a map of known size. Locations of nodes are then
+ *        kept in a paged table instead of a hash table.
+ * @param height the size of the map
+ * @param width the size of the map
+ * @return none
+ */
+BucketOpenList::BucketOpenList(const int &height, const int &width) {
+    grid_width = width;
+    dense_location.Assign(static_cast<std::size_t>(height) * width,
+                          Location{-1, -1});
+}
+
+/**
+ * @brief Inset a node in the open list. A node that is already in the list
+ *        only gets its key updated.
+ * @param new_key the priority of the node to be added
+ * @param new_node the position of the node
+ * @return none
+ */
+void BucketOpenList::Insert(const Key &new_key,
+                            const std::pair<int, int> &new_node) {
+    if (LocationOf(new_node).bucket >= 0) {
+        UpdateKey(new_key, new_node);
+        return;
+    }
+    Add(std::make_tuple(new_key, new_node.first, new_node.second));
+    ++node_num;
+}
+
+/**
+ * @brief Inset a node with a one-component key, used as both components.
+ * @param new_key the priority of the node to be added
+ * @param new_node the position of the node
+ * @return none
+ */
+void BucketOpenList::Insert(const double &new_key,
+                            const std::pair<int, int> &new_node) {
+    Insert(std::make_pair(new_key, new_key), new_node);
+}
+
+/**
+ * @brief Update the key of node in the open list. A node whose key stays in
+ *        its bucket is only sifted in the bucket's heap.
+ * @param new_key the new priority of the node
+ * @param position the position of the node
+ * @return none
+ */
+void BucketOpenList::UpdateKey(const Key &new_key,
+                               const std::pair<int, int> &position) {
+    auto location = LocationOf(position);
+    if (location.bucket < 0) return;
+    auto &heap = Heap(location.bucket);
+    if (BucketOf(new_key) != location.bucket) {
+        Take(location);
+        Add(std::make_tuple(new_key, position.first, position.second));
+        SkipEmptyBuckets();
+        return;
+    }
+    auto old_key = std::get<0>(heap[location.slot]);
+    std::get<0>(heap[location.slot]) = new_key;
+    if (new_key < old_key)
+        SiftUp(location.bucket, location.slot);
+    else
+        SiftDown(location.bucket, location.slot);
+}
+
+/**
+ * @brief Update the key of node with a one-component key.
+ * @param new_key the new priority of the node
+ * @param position the position of the node
+ * @return none
+ */
+void BucketOpenList::UpdateKey(const double &new_key,
+                               const std::pair<int, int> &position) {
+    UpdateKey(std::make_pair(new_key, new_key), position);
+}
+
+/**
+ * @brief Remove a node from the open list.
+ * @param node a node's position
+ * @return none
+ */
+void BucketOpenList::Remove(const std::pair<int, int> &node) {
+    auto location = LocationOf(node);
+    if (location.bucket < 0) return;
+    Take(location);
+    --node_num;
+    SkipEmptyBuckets();
+}
+
+/**
+ * @brief Get the node with the smallest key: the top of the lowest
+ *        non-empty bucket.
+ * @return the top node's priority in searching and its position
+ */
+std::pair<Key, std::pair<int, int>> BucketOpenList::Top() const {
+    const auto &top = Heap(min_bucket).front();
+    return std::make_pair(std::get<0>(top),
+                          std::make_pair(std::get<1>(top), std::get<2>(top)));
+}
+
+/**
+ * @brief Get the node on the top of the open list and remove it.
+ * @return the top node's priority in searching and its position
+ */
+std::pair<Key, std::pair<int, int>> BucketOpenList::Pop() {
+    auto top_node = Top();
+    Remove(top_node.second);
+    return top_node;
+}
+
+/**
+ * @brief Find if a node is in the open list.
+ * @return true if the node exsit and false if not
+ */
+bool BucketOpenList::Find(const std::pair<int, int> &node_to_find) const {
+    return LocationOf(node_to_find).bucket >= 0;
+}
+
+/**
+ * @brief Check if there is no node in the open list.
+ * @return true if the open list is empty
+ */
+bool BucketOpenList::Empty() const { return node_num == 0; }
+
+/**
+ * @brief Get the number of nodes in the open list.
+ * @return the number of nodes
+ */
+std::size_t BucketOpenList::Size() const { return node_num; }
+
+/**
+ * @brief Get the number of regular buckets allocated so far.
+ * @return the number of buckets, not counting the overflow heap
+ */
+std::size_t BucketOpenList::BucketNum() const { return buckets.size(); }
+
+/**
+ * @brief Get every node of the open list, in an order that inserting them
+ *        again rebuilds the list cheaply.
+ * @return the keys and the positions of the nodes
+ */
+std::vector<std::pair<Key, std::pair<int, int>>> BucketOpenList::Nodes() const {
+    std::vector<std::pair<Key, std::pair<int, int>>> nodes;
+    nodes.reserve(node_num);
+    for (auto const &bucket : buckets) {
+        for (auto const &node : bucket)
+            nodes.emplace_back(std::get<0>(node),
+                               std::make_pair(std::get<1>(node),
+                                              std::get<2>(node)));
+    }
+    for (auto const &node : overflow)
+        nodes.emplace_back(std::get<0>(node),
+                           std::make_pair(std::get<1>(node),
+                                          std::get<2>(node)));
+    return nodes;
+}
+
+/**
+ * @brief Get the bucket of a key from its first component. Keys that are
+ *        negative, too large or not finite clamp to the first bucket or
+ *        the overflow heap.
+ * @param key the key of a node
+ * @return the index of the bucket
+ */
+int BucketOpenList::BucketOf(const Key &key) {
+    auto scaled = key.first * kResolution;
+    if (!(scaled < kMaxBucketNum)) return kOverflowBucket;
+    if (scaled < 0) return 0;
+    return static_cast<int>(scaled);
+}
+
+/**
+ * @brief Get the heap of a bucket.
+ * @param bucket the index of the bucket, or kOverflowBucket
+ * @return the heap of the bucket
+ */
+std::vector<BucketOpenList::Node> &BucketOpenList::Heap(const int &bucket) {
+    return bucket == kOverflowBucket ? overflow : buckets[bucket];
+}
+
+/**
+ * @brief Get the heap of a bucket.
+ * @param bucket the index of the bucket, or kOverflowBucket
+ * @return the heap of the bucket
+ */
+const std::vector<BucketOpenList::Node> &BucketOpenList::Heap(
+        const int &bucket) const {
+    return bucket == kOverflowBucket ? overflow : buckets[bucket];
+}
+
+/**
+ * @brief Get the location of a node.
+ * @param position the position of the node
+ * @return the location, with a bucket of -1 if the node is not in the list
+ */
+BucketOpenList::Location BucketOpenList::LocationOf(
+        const std::pair<int, int> &position) const {
+    if (grid_width > 0)
+        return dense_location[static_cast<std::size_t>(position.first) *
+                              grid_width + position.second];
+    auto found = sparse_location.find(
+        (static_cast<long long>(position.first) << 32) ^
+        static_cast<unsigned int>(position.second));
+    return found == sparse_location.end() ? Location{-1, -1} : found->second;
+}
+
+/**
+ * @brief Record the location of a node.
+ * @param position the position of the node
+ * @param location the bucket and the slot of the node
+ * @return none
+ */
+void BucketOpenList::SetLocation(const std::pair<int, int> &position,
+                                 const Location &location) {
+    if (grid_width > 0)
+        dense_location.Set(static_cast<std::size_t>(position.first) *
+                           grid_width + position.second, location);
+    else
+        sparse_location[(static_cast<long long>(position.first) << 32) ^
+                        static_cast<unsigned int>(position.second)] = location;
+}
+
+/**
+ * @brief Forget the location of a node that leaves the list.
+ * @param position the position of the node
+ * @return none
+ */
+void BucketOpenList::ClearLocation(const std::pair<int, int> &position) {
+    if (grid_width > 0)
+        dense_location.Set(static_cast<std::size_t>(position.first) *
+                           grid_width + position.second, Location{-1, -1});
+    else
+        sparse_location.erase((static_cast<long long>(position.first) << 32) ^
+                              static_cast<unsigned int>(position.second));
+}
+
+/**
+ * @brief Put a node in the heap of its bucket. The cursor moves down when
+ *        the key is below every key in the list.
+ * @param node the key and the position of the node
+ * @return none
+ */
+void BucketOpenList::Add(const Node &node) {
+    auto bucket = BucketOf(std::get<0>(node));
+    if (bucket != kOverflowBucket &&
+        bucket >= static_cast<int>(buckets.size()))
+        buckets.resize(bucket + 1);
+    if (node_num == 0 || bucket < min_bucket) min_bucket = bucket;
+    auto &heap = Heap(bucket);
+    heap.push_back(node);
+    auto slot = static_cast<int>(heap.size()) - 1;
+    SetLocation(std::make_pair(std::get<1>(node), std::get<2>(node)),
+                Location{bucket, slot});
+    SiftUp(bucket, slot);
+}
+
+/**
+ * @brief Take a node out of the heap of its bucket. The cursor is left for
+ *        the caller to move.
+ * @param location the bucket and the slot of the node
+ * @return none
+ */
+void BucketOpenList::Take(const Location &location) {
+    auto &heap = Heap(location.bucket);
+    auto removed = heap[location.slot];
+    ClearLocation(std::make_pair(std::get<1>(removed), std::get<2>(removed)));
+    auto last = heap.back();
+    heap.pop_back();
+    if (location.slot == static_cast<int>(heap.size())) return;
+    // Fill the hole with the last node and restore the heap around it.
+    Place(location.bucket, last, location.slot);
+    if (last < removed)
+        SiftUp(location.bucket, location.slot);
+    else
+        SiftDown(location.bucket, location.slot);
+}
+
+/**
+ * @brief Move the cursor up past the buckets left empty, on to the
+ *        overflow heap past the last one.
+ * @return none
+ */
+void BucketOpenList::SkipEmptyBuckets() {
+    auto bucket_num = static_cast<int>(buckets.size());
+    while (min_bucket < bucket_num && buckets[min_bucket].empty())
+        ++min_bucket;
+    if (min_bucket == bucket_num) min_bucket = kOverflowBucket;
+}
+
+/**
+ * @brief Put a node in a slot of a bucket and record its new location.
+ * @param bucket the bucket of the node
+ * @param node the key and the position of the node
+ * @param slot the slot in the bucket's heap
+ * @return none
+ */
+void BucketOpenList::Place(const int &bucket, const Node &node,
+                           const int &slot) {
+    Heap(bucket)[slot] = node;
+    SetLocation(std::make_pair(std::get<1>(node), std::get<2>(node)),
+                Location{bucket, slot});
+}
+
+/**
+ * @brief Move a node toward the top of its bucket until its parent is not
+ *        larger.
+ * @param bucket the bucket of the node
+ * @param slot the slot of the node
+ * @return none
+ */
+void BucketOpenList::SiftUp(const int &bucket, int slot) {
+    auto &heap = Heap(bucket);
+    auto node = heap[slot];
+    while (slot > 0) {
+        auto parent = (slot - 1) / 2;
+        if (!(node < heap[parent])) break;
+        Place(bucket, heap[parent], slot);
+        slot = parent;
+    }
+    Place(bucket, node, slot);
+}
+
+/**
+ * @brief Move a node toward the bottom of its bucket until its children are
+ *        not smaller.
+ * @param bucket the bucket of the node
+ * @param slot the slot of the node
+ * @return none
+ */
+void BucketOpenList::SiftDown(const int &bucket, int slot) {
+    auto &heap = Heap(bucket);
+    auto node = heap[slot];
+    auto size = static_cast<int>(heap.size());
+    while (2 * slot + 1 < size) {
+        auto child = 2 * slot + 1;
+        if (child + 1 < size && heap[child + 1] < heap[child]) ++child;
+        if (!(heap[child] < node)) break;
+        Place(bucket, heap[child], slot);
+        slot = child;
+    }
+    Place(bucket, node, slot);
+}
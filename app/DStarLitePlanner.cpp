@@ -0,0 +1,896 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file DStarLitePlanner.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class performs the D* Lite algorithm on a map: it computes the
+ * shortest path from the goal, repairs it incrementally when cells of the
+ * map change and tells where the robot should move next. It never prints:
+ * an optional PlannerObserver hears of replans, steps and discoveries.
+ * Built with DSTARLITE_STATS, it also counts its work in PlannerStats.
+ * 
+ */
+
+#include "DStarLitePlanner.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include "Snapshot.h"
+
+/**
+ * @brief Constructor.
+ * @param map_ptr the pointer of the map, which must outlive the planner
+ * @return none
+ */
+template <typename OpenListType, typename MapType>
+BasicDStarLitePlanner<OpenListType, MapType>::BasicDStarLitePlanner(
+        MapType *map_ptr)
+    : map_ptr(map_ptr),
+      openlist(map_ptr->GetSize().first, map_ptr->GetSize().second),
+      start(map_ptr->GetStart()) {}
+
+/**
+ * @brief Give cells a cost to the goal of their own, as if one edge led from
+ *        each of them to the goal. Their rhs-values never exceed it. Call it
+ *        before Initialize.
+ * @param costs the frontier cells and their costs to the goal
+ * @return none
+ */
+template <typename OpenListType, typename MapType>
+void BasicDStarLitePlanner<OpenListType, MapType>::SetFrontier(
+        const std::vector<FrontierCost> &costs) {
+    auto size = map_ptr->GetSize();
+    // one past the index of the last cell of the map
+    auto end_index = map_ptr->CellIndex(
+        std::make_pair(size.first - 1, size.second - 1)) + 1;
+    frontier.clear();
+    frontier_cost.Assign(end_index, map_ptr->infinity_cost);
+    for (auto const &cell : costs) {
+        auto index = map_ptr->CellIndex(cell.position);
+        frontier.push_back(index);
+        frontier_cost.Set(index, CostTraits<CostType>::FromDouble(cell.cost));
+    }
+}
+
+/**
+ * @brief Initialize the map and the open list
+ * @return none
+ */
+template <typename OpenListType, typename MapType>
+void BasicDStarLitePlanner<OpenListType, MapType>::Initialize() {
+    // One lookahead cost of the goal must be zero
+    auto goal_rhs = 0.0;
+    map_ptr->UpdateCellRhs(map_ptr->GetGoal(), goal_rhs);
+    // Insert the goal to open list
+    auto new_key = map_ptr->CalculateCellKey(map_ptr->GetGoal());
+    openlist.Insert(new_key, map_ptr->GetGoal());
+    DSTARLITE_STAT(++stats.openlist_inserts);
+    // Frontier cells start from their own cost to the goal
+    for (auto const &index : frontier) {
+        if (map_ptr->Blocked(index) ||
+            index == map_ptr->CellIndex(map_ptr->GetGoal()))
+            continue;
+        map_ptr->UpdateCellRhs(index, frontier_cost[index]);
+        openlist.Insert(map_ptr->CalculateCellKey(index),
+                        map_ptr->CellPosition(index));
+        DSTARLITE_STAT(++stats.openlist_inserts);
+    }
+}
+
+/**
+ * @brief Compute the shortest path from the current start
+ * @return none
+ */
+template <typename OpenListType, typename MapType>
+void BasicDStarLitePlanner<OpenListType, MapType>::ComputeShortestPath() {
+    ComputeShortestPath(SearchBudget());
+}
+
+/**
+ * @brief Compute the shortest path from the current start within a budget.
+ *        The open list, the g-values and the rhs-values are left as they
+ *        are when the budget runs out, so the next call resumes exactly
+ *        where this one stopped. Every call makes some progress, however
+ *        small the budget.
+ * @param budget the number of expansions and the deadline of this call
+ * @return kPartial if the budget ran out first, kConverged otherwise
+ */
+template <typename OpenListType, typename MapType>
+SearchStatus BasicDStarLitePlanner<OpenListType, MapType>::ComputeShortestPath(
+        const SearchBudget &budget) {
+    // the clock is read once per this many expansions
+    const std::size_t kDeadlineInterval = 16;
+    auto has_deadline =
+        budget.deadline != std::chrono::steady_clock::time_point::max();
+    std::size_t iterations = 0;
+    converged = true;
+#ifdef DSTARLITE_STATS
+    auto begin_time = std::chrono::steady_clock::now();
+    auto expansions_before = stats.expansions;
+    auto touched_before = stats.update_vertex_calls;
+#endif
+    SyncStart();
+    auto start_index = map_ptr->CellIndex(start);
+    settled_robot_num = 0;
+    while (!openlist.Empty() &&
+           (!Settled(start_index, openlist.Top().first) ||
+            !RobotsSettled(openlist.Top().first))) {
+        if (iterations > 0 &&
+            ((budget.max_expansions > 0 &&
+              iterations >= budget.max_expansions) ||
+             (has_deadline && iterations % kDeadlineInterval == 0 &&
+              std::chrono::steady_clock::now() >= budget.deadline))) {
+            converged = false;
+            break;
+        }
+        ++iterations;
+        auto key_and_node = openlist.Top();
+        auto node = key_and_node.second;
+        auto index = map_ptr->CellIndex(node);
+
+        auto old_key = key_and_node.first;
+        auto new_key = map_ptr->CalculateCellKey(index);
+
+        if (old_key < new_key) {
+            // The key was computed before the start moved
+            DSTARLITE_STAT(++stats.stale_key_expansions);
+            DSTARLITE_STAT(++stats.openlist_updates);
+            openlist.UpdateKey(new_key, node);
+        } else if (map_ptr->CurrentCellG(index) >
+                   map_ptr->CurrentCellRhs(index)) {
+            DSTARLITE_STAT(++stats.expansions);
+            DSTARLITE_STAT(++stats.overconsistent_expansions);
+            DSTARLITE_STAT(++stats.openlist_removes);
+            DSTARLITE_STAT(++stats.neighbor_scans);
+            map_ptr->UpdateCellG(index, map_ptr->CurrentCellRhs(index));
+            openlist.Remove(node);
+            map_ptr->ForEachNeighbor(index, [this](const Neighbor &neighbor) {
+                UpdateVertex(neighbor.index);
+            });
+        } else {
+            DSTARLITE_STAT(++stats.expansions);
+            DSTARLITE_STAT(++stats.underconsistent_expansions);
+            DSTARLITE_STAT(++stats.neighbor_scans);
+            map_ptr->UpdateCellG(index, map_ptr->infinity_cost);
+            UpdateVertex(index);
+            map_ptr->ForEachNeighbor(index, [this](const Neighbor &neighbor) {
+                UpdateVertex(neighbor.index);
+            });
+        }
+    }
+#ifdef DSTARLITE_STATS
+    std::chrono::duration<double, std::micro> replan_time =
+        std::chrono::steady_clock::now() - begin_time;
+    ++stats.replans;
+    stats.last_replan_expansions = stats.expansions - expansions_before;
+    stats.last_replan_touched_cells =
+        stats.update_vertex_calls - touched_before;
+    stats.replan_latency_us.Record(replan_time.count());
+    stats.touched_cells_per_replan.Record(
+        static_cast<double>(stats.last_replan_touched_cells));
+#endif
+    if (!converged) return SearchStatus::kPartial;
+    if (observer != nullptr &&
+        ShouldNotify(&replan_event_num, observer_options.replan_every))
+        observer->OnReplan(*map_ptr, start);
+    return SearchStatus::kConverged;
+}
+
+/**
+ * @brief Check whether the last ComputeShortestPath finished its search.
+ * @return false if it ran out of budget
+ */
+template <typename OpenListType, typename MapType>
+bool BasicDStarLitePlanner<OpenListType, MapType>::Converged() const {
+    return converged;
+}
+
+/**
+ * @brief Update node of interest
+ * @param vertex the position of the node
+ * @return none
+ */
+template <typename OpenListType, typename MapType>
+void BasicDStarLitePlanner<OpenListType, MapType>::UpdateVertex(
+        const std::pair<int, int> &vertex) {
+    UpdateVertex(map_ptr->CellIndex(vertex));
+}
+
+/**
+ * @brief Update node of interest
+ * @param index the index of the node in the map
+ * @return none
+ */
+template <typename OpenListType, typename MapType>
+void BasicDStarLitePlanner<OpenListType, MapType>::UpdateVertex(
+        const int &index) {
+    DSTARLITE_STAT(++stats.update_vertex_calls);
+    if (index != map_ptr->CellIndex(map_ptr->GetGoal())) {
+        auto min_rhs = ComputeMinRhs(index);
+        if (!frontier.empty())
+            min_rhs = std::min(min_rhs, frontier_cost[index]);
+        map_ptr->UpdateCellRhs(index, min_rhs);
+    }
+    auto vertex = map_ptr->CellPosition(index);
+    auto is_open = openlist.Find(vertex);
+    if (map_ptr->CurrentCellG(index) != map_ptr->CurrentCellRhs(index)) {
+        if (is_open) {
+            DSTARLITE_STAT(++stats.openlist_updates);
+            openlist.UpdateKey(map_ptr->CalculateCellKey(index), vertex);
+        } else {
+            DSTARLITE_STAT(++stats.openlist_inserts);
+            openlist.Insert(map_ptr->CalculateCellKey(index), vertex);
+            DSTARLITE_STAT(stats.max_openlist_size = std::max(
+                stats.max_openlist_size, openlist.Size()));
+        }
+    } else if (is_open) {
+        DSTARLITE_STAT(++stats.openlist_removes);
+        openlist.Remove(vertex);
+    }
+}
+
+/**
+ * @brief Find the numimum rhs of amoung node's neighbors.
+ * @param vertex the position of the node
+ * @return minimum rhs 
+ */
+template <typename OpenListType, typename MapType>
+typename MapType::Cost
+BasicDStarLitePlanner<OpenListType, MapType>::ComputeMinRhs(
+        const std::pair<int, int> &vertex) {
+    return ComputeMinRhs(map_ptr->CellIndex(vertex));
+}
+
+/**
+ * @brief Find the numimum rhs of amoung node's neighbors.
+ * @param index the index of the node in the map
+ * @return minimum rhs 
+ */
+template <typename OpenListType, typename MapType>
+typename MapType::Cost
+BasicDStarLitePlanner<OpenListType, MapType>::ComputeMinRhs(
+        const int &index) {
+    DSTARLITE_STAT(++stats.neighbor_scans);
+    auto min_rhs = map_ptr->infinity_cost;
+    map_ptr->ForEachNeighbor(index, [this, &min_rhs](const Neighbor &neighbor) {
+        auto temp_rhs = CostTraits<CostType>::Add(
+            neighbor.cost, map_ptr->CurrentCellG(neighbor.index));
+        if (temp_rhs < min_rhs) min_rhs = temp_rhs;
+    });
+    return min_rhs;
+}
+
+/**
+ * @brief Move the start of the search to the robot's new position. Keys are
+ *        only brought up to date when the map changes.
+ * @param new_start the position of the robot
+ * @return none
+ */
+template <typename OpenListType, typename MapType>
+void BasicDStarLitePlanner<OpenListType, MapType>::MoveStart(
+        const std::pair<int, int> &new_start) {
+    start = new_start;
+    if (observer != nullptr &&
+        ShouldNotify(&step_event_num, observer_options.step_every))
+        observer->OnStep(*map_ptr, start);
+}
+
+/**
+ * @brief Apply a batch of changed cells and update the affected nodes. All
+ *        cells change first; each affected node is then updated once, even
+ *        when the neighborhoods of several changed cells overlap. Call
+ *        ComputeShortestPath afterwards to repair the path.
+ * @param changes cells that became blocked or free
+ * @return if any cell really changed
+ */
+template <typename OpenListType, typename MapType>
+bool BasicDStarLitePlanner<OpenListType, MapType>::ApplyChanges(
+        const std::vector<CellChange> &changes) {
+#ifdef DSTARLITE_STATS
+    auto begin_time = std::chrono::steady_clock::now();
+#endif
+    auto is_changed = false;
+    // the changes that really happened, only kept for an observer
+    std::vector<CellChange> applied;
+    affected_vertices.clear();
+    for (auto const &change : changes) {
+        auto index = map_ptr->CellIndex(change.position);
+        if (map_ptr->Blocked(index) == change.blocked) continue;
+
+        // Move the start of the search before the first key is updated
+        if (!is_changed) SyncStart();
+        is_changed = true;
+        DSTARLITE_STAT(++stats.changed_cells);
+        if (observer != nullptr) applied.push_back(change);
+
+        if (change.blocked) {
+            // Edges into the cell become infinite: the cell leaves the search
+            // and its neighbors look for another successor
+            map_ptr->UpdateStatusCode(index, MapType::kObstacle);
+            map_ptr->UpdateCellG(index, map_ptr->infinity_cost);
+            map_ptr->UpdateCellRhs(index, map_ptr->infinity_cost);
+            if (openlist.Find(change.position)) {
+                DSTARLITE_STAT(++stats.openlist_removes);
+                openlist.Remove(change.position);
+            }
+            DSTARLITE_STAT(++stats.neighbor_scans);
+            map_ptr->ForEachNeighbor(index, [this](const Neighbor &neighbor) {
+                affected_vertices.push_back(neighbor.index);
+            });
+        } else {
+            // Edges into the cell become finite: only the cell itself has a
+            // new rhs, its neighbors follow once it is expanded
+            map_ptr->UpdateStatusCode(index, MapType::kFree);
+            affected_vertices.push_back(index);
+            // Jumps over the cell open between its neighbors as well
+            if (MapType::kJumps) {
+                DSTARLITE_STAT(++stats.neighbor_scans);
+                map_ptr->ForEachNeighbor(
+                    index, [this](const Neighbor &neighbor) {
+                        affected_vertices.push_back(neighbor.index);
+                    });
+            }
+        }
+    }
+
+    // Update every affected node once; cells blocked later in the batch are
+    // already out of the search
+    std::sort(affected_vertices.begin(), affected_vertices.end());
+    auto unique_end = std::unique(affected_vertices.begin(),
+                                  affected_vertices.end());
+    DSTARLITE_STAT(stats.duplicate_vertices +=
+                   affected_vertices.end() - unique_end);
+    for (auto vertex = affected_vertices.begin(); vertex != unique_end;
+         ++vertex) {
+        if (!map_ptr->Blocked(*vertex)) UpdateVertex(*vertex);
+    }
+#ifdef DSTARLITE_STATS
+    std::chrono::duration<double, std::micro> batch_time =
+        std::chrono::steady_clock::now() - begin_time;
+    ++stats.change_batches;
+    stats.change_batch_latency_us.Record(batch_time.count());
+#endif
+    if (is_changed && observer != nullptr &&
+        ShouldNotify(&change_event_num, observer_options.change_every))
+        observer->OnObstacleDiscovered(*map_ptr, applied);
+    return is_changed;
+}
+
+/**
+ * @brief Apply a batch of terrain changes. Only the moves into a changed
+ *        cell change cost, so only its neighbors can get another rhs: one
+ *        whose cheapest move went through the cell when it became slower,
+ *        or one for which the cell became the cheapest way when it became
+ *        faster. Those are updated once each; call ComputeShortestPath
+ *        afterwards to repair the path.
+ * @param changes cells with their new terrain levels
+ * @return if any cell really changed
+ */
+template <typename OpenListType, typename MapType>
+bool BasicDStarLitePlanner<OpenListType, MapType>::ApplyTerrainChanges(
+        const std::vector<TerrainChange> &changes) {
+#ifdef DSTARLITE_STATS
+    auto begin_time = std::chrono::steady_clock::now();
+#endif
+    auto is_changed = false;
+    affected_vertices.clear();
+    for (auto const &change : changes) {
+        auto index = map_ptr->CellIndex(change.position);
+        auto old_terrain = map_ptr->CurrentTerrain(index);
+        if (old_terrain == change.terrain) continue;
+
+        // Move the start of the search before the first key is updated
+        if (!is_changed) SyncStart();
+        is_changed = true;
+        DSTARLITE_STAT(++stats.changed_cells);
+        auto cell_g = map_ptr->CurrentCellG(index);
+        // Moves into a blocked or unreached cell stay infinite
+        if (map_ptr->Blocked(index) || cell_g == map_ptr->infinity_cost) {
+            map_ptr->UpdateTerrain(index, change.terrain);
+            continue;
+        }
+
+        DSTARLITE_STAT(++stats.neighbor_scans);
+        if (change.terrain > old_terrain) {
+            // A neighbor loses its rhs if its cheapest move was into the cell
+            map_ptr->ForEachPredecessor(index, [&](const Neighbor &neighbor) {
+                if (map_ptr->CurrentCellRhs(neighbor.index) ==
+                    CostTraits<CostType>::Add(neighbor.cost, cell_g))
+                    affected_vertices.push_back(neighbor.index);
+            });
+            map_ptr->UpdateTerrain(index, change.terrain);
+        } else {
+            // A neighbor gains a lower rhs if the cell is now its cheapest
+            map_ptr->UpdateTerrain(index, change.terrain);
+            map_ptr->ForEachPredecessor(index, [&](const Neighbor &neighbor) {
+                if (CostTraits<CostType>::Add(neighbor.cost, cell_g) <
+                    map_ptr->CurrentCellRhs(neighbor.index))
+                    affected_vertices.push_back(neighbor.index);
+            });
+        }
+    }
+
+    // Update every affected node once, on the terrain of the whole batch
+    std::sort(affected_vertices.begin(), affected_vertices.end());
+    auto unique_end = std::unique(affected_vertices.begin(),
+                                  affected_vertices.end());
+    DSTARLITE_STAT(stats.duplicate_vertices +=
+                   affected_vertices.end() - unique_end);
+    for (auto vertex = affected_vertices.begin(); vertex != unique_end;
+         ++vertex)
+        UpdateVertex(*vertex);
+#ifdef DSTARLITE_STATS
+    std::chrono::duration<double, std::micro> batch_time =
+        std::chrono::steady_clock::now() - begin_time;
+    ++stats.change_batches;
+    stats.change_batch_latency_us.Record(batch_time.count());
+#endif
+    return is_changed;
+}
+
+/**
+ * @brief Set the terrain of a rectangle of cells in one batch, such as a
+ *        congested aisle of a congestion map.
+ * @param corner a corner of the rectangle
+ * @param opposite_corner the opposite corner; cells outside the map are
+ *        left out
+ * @param terrain the terrain level, from 0 to 255
+ * @return if any cell really changed
+ */
+template <typename OpenListType, typename MapType>
+bool BasicDStarLitePlanner<OpenListType, MapType>::UpdateRegionTerrain(
+        const std::pair<int, int> &corner,
+        const std::pair<int, int> &opposite_corner, const int &terrain) {
+    if (terrain < 0 || terrain > 255)
+        throw std::invalid_argument("DStarLitePlanner: terrain out of range");
+    auto size = map_ptr->GetSize();
+    auto top = std::max(std::min(corner.first, opposite_corner.first), 0);
+    auto bottom = std::min(std::max(corner.first, opposite_corner.first),
+                           size.first - 1);
+    auto left = std::max(std::min(corner.second, opposite_corner.second), 0);
+    auto right = std::min(std::max(corner.second, opposite_corner.second),
+                          size.second - 1);
+    std::vector<TerrainChange> changes;
+    auto level = static_cast<std::uint8_t>(terrain);
+    for (int i = top; i <= bottom; ++i) {
+        for (int j = left; j <= right; ++j)
+            changes.push_back(TerrainChange{std::make_pair(i, j), level});
+    }
+    return ApplyTerrainChanges(changes);
+}
+
+/**
+ * @brief Find hidden obstacles within the sensor radius of the robot and
+ *        recognize them as obstacles, all in one batch
+ * @param current_position robot's current position
+ * @return if there are hidden obstacle around
+ */
+template <typename OpenListType, typename MapType>
+bool BasicDStarLitePlanner<OpenListType, MapType>::DetectHiddenObstacle(
+        const std::pair<int, int> &current_position) {
+    std::vector<int> hidden_indices;
+    DSTARLITE_STAT(++stats.neighbor_scans);
+    map_ptr->Hidden().FindSetInWindow(current_position, sensor_radius,
+                                      &hidden_indices);
+    std::vector<CellChange> changes;
+    auto center = map_ptr->CellIndex(current_position);
+    for (auto const &index : hidden_indices) {
+        if (index != center)
+            changes.push_back(CellChange{map_ptr->CellPosition(index), true});
+    }
+    return ApplyChanges(changes);
+}
+
+/**
+ * @brief Find next position with minimum g-value plus travel cost. While a
+ *        bounded search has work left, this is a best effort: the larger of
+ *        the g-value and the rhs-value of a neighbor stands in for its
+ *        g-value.
+ * @param current_position the position of the current node
+ * @return next position in the shortest path, or the current position if
+ *         it is the goal or the goal is not reachable
+ */
+template <typename OpenListType, typename MapType>
+std::pair<int, int>
+BasicDStarLitePlanner<OpenListType, MapType>::ComputeNextPotision(
+        const std::pair<int, int> &current_position) {
+    if (current_position == map_ptr->GetGoal()) return current_position;
+    auto center = map_ptr->CellIndex(current_position);
+    auto next_index = center;
+    auto cheaest_cost = map_ptr->infinity_cost;
+    DSTARLITE_STAT(++stats.neighbor_scans);
+    map_ptr->ForEachNeighbor(center, [&](const Neighbor &neighbor) {
+        auto estimate = map_ptr->CurrentCellG(neighbor.index);
+        // an unfinished repair may not have raised a stale g-value yet
+        if (!converged)
+            estimate = std::max(estimate,
+                                map_ptr->CurrentCellRhs(neighbor.index));
+        auto cost = CostTraits<CostType>::Add(neighbor.cost, estimate);
+        if (cost < cheaest_cost) {
+            cheaest_cost = cost;
+            next_index = neighbor.index;
+        }
+    });
+    return map_ptr->CellPosition(next_index);
+}
+
+/**
+ * @brief Find next position from the current start of the search
+ * @return next position in the shortest path
+ */
+template <typename OpenListType, typename MapType>
+std::pair<int, int> BasicDStarLitePlanner<OpenListType, MapType>::NextMove() {
+    return ComputeNextPotision(start);
+}
+
+/**
+ * @brief Register a robot heading to the goal. ComputeShortestPath then
+ *        runs until the cells of all robots are settled, so one search
+ *        serves the whole fleet.
+ * @param position the position of the robot
+ * @return the id of the robot
+ */
+template <typename OpenListType, typename MapType>
+int BasicDStarLitePlanner<OpenListType, MapType>::AddRobot(
+        const std::pair<int, int> &position) {
+    robots.emplace_back(position);
+    return static_cast<int>(robots.size()) - 1;
+}
+
+/**
+ * @brief Move a registered robot. Unlike the start, robots do not change
+ *        keys, so they can move freely between replans.
+ * @param robot_id the id given by AddRobot
+ * @param new_position the new position of the robot
+ * @return none
+ */
+template <typename OpenListType, typename MapType>
+void BasicDStarLitePlanner<OpenListType, MapType>::MoveRobot(
+        const int &robot_id, const std::pair<int, int> &new_position) {
+    robots.at(robot_id).Move(new_position);
+    if (observer != nullptr &&
+        ShouldNotify(&step_event_num, observer_options.step_every))
+        observer->OnStep(*map_ptr, new_position);
+}
+
+/**
+ * @brief Get the position of a registered robot.
+ * @param robot_id the id given by AddRobot
+ * @return the position of the robot
+ */
+template <typename OpenListType, typename MapType>
+std::pair<int, int>
+BasicDStarLitePlanner<OpenListType, MapType>::RobotPosition(
+        const int &robot_id) const {
+    return robots.at(robot_id).CurrentPosition();
+}
+
+/**
+ * @brief Get the number of registered robots.
+ * @return the number of robots
+ */
+template <typename OpenListType, typename MapType>
+int BasicDStarLitePlanner<OpenListType, MapType>::RobotNum() const {
+    return static_cast<int>(robots.size());
+}
+
+/**
+ * @brief Find the next position of every registered robot, reading only the
+ *        neighbors of each robot from the shared search.
+ * @return next positions in the order of the robot ids
+ */
+template <typename OpenListType, typename MapType>
+std::vector<std::pair<int, int>>
+BasicDStarLitePlanner<OpenListType, MapType>::NextMoves() {
+    std::vector<std::pair<int, int>> next_positions;
+    next_positions.reserve(robots.size());
+    for (auto const &robot : robots)
+        next_positions.push_back(ComputeNextPotision(robot.CurrentPosition()));
+    return next_positions;
+}
+
+/**
+ * @brief Set how far the robot senses hidden obstacles.
+ * @param radius the number of cells between the robot and the edge of the
+ *        square it senses, 1 for its eight neighbors
+ * @return none
+ */
+template <typename OpenListType, typename MapType>
+void BasicDStarLitePlanner<OpenListType, MapType>::SetSensorRadius(
+        const int &radius) {
+    if (radius < 0)
+        throw std::invalid_argument("DStarLitePlanner: negative radius");
+    sensor_radius = radius;
+}
+
+/**
+ * @brief Get how far the robot senses hidden obstacles.
+ * @return the sensor radius
+ */
+template <typename OpenListType, typename MapType>
+int BasicDStarLitePlanner<OpenListType, MapType>::SensorRadius() const {
+    return sensor_radius;
+}
+
+/**
+ * @brief Write the map and the state of the search to a snapshot: the open
+ *        list, whether it converged, the start, the sensor radius, the
+ *        robots and the frontier.
+ *        The file at the path is only replaced once the snapshot is whole.
+ * @param path the file to write
+ * @return none
+ */
+template <typename OpenListType, typename MapType>
+void BasicDStarLitePlanner<OpenListType, MapType>::SaveSnapshot(
+        const std::string &path) const {
+    SnapshotWriter writer(path);
+    map_ptr->WriteSnapshot(&writer);
+    auto &header = writer.Header();
+    header.planner_start[0] = start.first;
+    header.planner_start[1] = start.second;
+    header.sensor_radius = sensor_radius;
+    header.converged = converged ? 1 : 0;
+
+    std::vector<SnapshotNode> nodes;
+    for (auto const &node : openlist.Nodes()) {
+        nodes.push_back(SnapshotNode{{node.first.first, node.first.second},
+                                     {node.second.first, node.second.second},
+                                     0});
+    }
+    header.open_num = nodes.size();
+    header.open_offset =
+        writer.Append(nodes.data(), nodes.size() * sizeof(SnapshotNode));
+    std::vector<std::int32_t> positions;
+    for (auto const &robot : robots) {
+        positions.push_back(robot.CurrentPosition().first);
+        positions.push_back(robot.CurrentPosition().second);
+    }
+    header.robot_num = robots.size();
+    header.robots_offset = writer.Append(
+        positions.data(), positions.size() * sizeof(std::int32_t));
+    std::vector<SnapshotFrontier> cells;
+    for (auto const &index : frontier) {
+        auto position = map_ptr->CellPosition(index);
+        cells.push_back(SnapshotFrontier{
+            CostTraits<CostType>::ToDouble(frontier_cost[index]),
+            {position.first, position.second}});
+    }
+    header.frontier_num = cells.size();
+    header.frontier_offset =
+        writer.Append(cells.data(), cells.size() * sizeof(SnapshotFrontier));
+    writer.Finish();
+}
+
+/**
+ * @brief Restore the map and the search from a snapshot written by
+ *        SaveSnapshot with the same type of map. The next
+ *        ComputeShortestPath goes on from the saved open list, so a search
+ *        that was done does no work at all. The observer and the statistics
+ *        are kept; the heuristic is the map's own.
+ * @param path the file to read
+ * @return none
+ */
+template <typename OpenListType, typename MapType>
+void BasicDStarLitePlanner<OpenListType, MapType>::LoadSnapshot(
+        const std::string &path) {
+    SnapshotReader reader(path);
+    auto const &header = reader.Header();
+    auto nodes = reader.At<const SnapshotNode>(header.open_offset,
+                                               header.open_num);
+    auto positions = reader.At<const std::int32_t>(header.robots_offset,
+                                                   2 * header.robot_num);
+    auto cells = reader.At<const SnapshotFrontier>(header.frontier_offset,
+                                                   header.frontier_num);
+    auto inside = [&header](const std::int32_t *position) {
+        return position[0] >= 0 && position[0] < header.height &&
+               position[1] >= 0 && position[1] < header.width;
+    };
+    bool corrupt = !inside(header.planner_start);
+    for (std::uint64_t k = 0; k < header.open_num; ++k)
+        corrupt = corrupt || !inside(nodes[k].position);
+    for (std::uint64_t k = 0; k < header.robot_num; ++k)
+        corrupt = corrupt || !inside(positions + 2 * k);
+    for (std::uint64_t k = 0; k < header.frontier_num; ++k)
+        corrupt = corrupt || !inside(cells[k].position);
+    if (corrupt)
+        throw std::runtime_error("DStarLitePlanner: corrupt snapshot " + path);
+    map_ptr->ReadSnapshot(reader);
+
+    auto size = map_ptr->GetSize();
+    openlist = OpenListType(size.first, size.second);
+    // nodes come in the order of the open list, so each insert is cheap
+    for (std::uint64_t k = 0; k < header.open_num; ++k) {
+        openlist.Insert(Key(nodes[k].key[0], nodes[k].key[1]),
+                        std::make_pair(nodes[k].position[0],
+                                       nodes[k].position[1]));
+    }
+    start = std::make_pair(header.planner_start[0], header.planner_start[1]);
+    sensor_radius = header.sensor_radius;
+    converged = header.converged != 0;
+    robots.clear();
+    for (std::uint64_t k = 0; k < header.robot_num; ++k)
+        AddRobot(std::make_pair(positions[2 * k], positions[2 * k + 1]));
+    std::vector<FrontierCost> costs;
+    for (std::uint64_t k = 0; k < header.frontier_num; ++k) {
+        costs.push_back(FrontierCost{
+            std::make_pair(cells[k].position[0], cells[k].position[1]),
+            cells[k].cost});
+    }
+    frontier.clear();
+    if (!costs.empty()) SetFrontier(costs);
+    settled_robot_num = 0;
+    affected_vertices.clear();
+}
+
+/**
+ * @brief Set the observer of the planner's events.
+ * @param new_observer the observer, which must outlive the planner, or
+ *        nullptr to run headless
+ * @param options how often each kind of event is passed on
+ * @return none
+ */
+template <typename OpenListType, typename MapType>
+void BasicDStarLitePlanner<OpenListType, MapType>::SetObserver(
+        ObserverType *new_observer, const ObserverOptions &options) {
+    observer = new_observer;
+    observer_options = options;
+    replan_event_num = 0;
+    step_event_num = 0;
+    change_event_num = 0;
+}
+
+/**
+ * @brief Get the current start of the search.
+ * @return the position of the start
+ */
+template <typename OpenListType, typename MapType>
+std::pair<int, int>
+BasicDStarLitePlanner<OpenListType, MapType>::CurrentStart() const {
+    return start;
+}
+
+/**
+ * @brief Get the open list of the search.
+ * @return the open list
+ */
+template <typename OpenListType, typename MapType>
+const OpenListType &
+BasicDStarLitePlanner<OpenListType, MapType>::CurrentOpenList() const {
+    return openlist;
+}
+
+/**
+ * @brief Get the counters and histograms of the planner. They stay zero
+ *        unless the library is built with DSTARLITE_STATS.
+ * @return the statistics
+ */
+template <typename OpenListType, typename MapType>
+const PlannerStats &
+BasicDStarLitePlanner<OpenListType, MapType>::Stats() const {
+    return stats;
+}
+
+/**
+ * @brief Reset all counters and histograms.
+ * @return none
+ */
+template <typename OpenListType, typename MapType>
+void BasicDStarLitePlanner<OpenListType, MapType>::ResetStats() {
+    stats = PlannerStats();
+}
+
+/**
+ * @brief Let the map compute keys from the current start, adding the distance
+ *        moved since the last replan to the key modifier.
+ * @return none
+ */
+template <typename OpenListType, typename MapType>
+void BasicDStarLitePlanner<OpenListType, MapType>::SyncStart() {
+    if (map_ptr->GetStart() != start) map_ptr->UpdateStart(start);
+}
+
+/**
+ * @brief Check whether a node is settled: consistent and not after the top
+ *        of the open list, so that its g-value is the cost to the goal.
+ * @param index the index of the node in the map
+ * @param top_key the smallest key of the open list
+ * @return true if the node is settled
+ */
+template <typename OpenListType, typename MapType>
+bool BasicDStarLitePlanner<OpenListType, MapType>::Settled(
+        const int &index, const Key &top_key) const {
+    return !(top_key < map_ptr->CalculateCellKey(index)) &&
+           map_ptr->CurrentCellRhs(index) == map_ptr->CurrentCellG(index);
+}
+
+/**
+ * @brief Check whether the cells of all registered robots are settled. A
+ *        settled node stays settled while the search goes on, so each call
+ *        resumes at the first robot not yet seen settled.
+ * @param top_key the smallest key of the open list
+ * @return true if all robots are settled
+ */
+template <typename OpenListType, typename MapType>
+bool BasicDStarLitePlanner<OpenListType, MapType>::RobotsSettled(
+        const Key &top_key) {
+    while (settled_robot_num < robots.size() &&
+           Settled(map_ptr->CellIndex(
+                       robots[settled_robot_num].CurrentPosition()),
+                   top_key))
+        ++settled_robot_num;
+    return settled_robot_num == robots.size();
+}
+
+/**
+ * @brief Count an event and tell if the observer should hear of it.
+ * @param event_num_ptr the pointer of the count of this kind of event
+ * @param every pass on every n-th event, or none for 0
+ * @return true if the event is passed on
+ */
+template <typename OpenListType, typename MapType>
+bool BasicDStarLitePlanner<OpenListType, MapType>::ShouldNotify(
+        int *event_num_ptr, const int &every) const {
+    if (every <= 0) return false;
+    *event_num_ptr = (*event_num_ptr + 1) % every;
+    return *event_num_ptr == 0;
+}
+
+template class BasicDStarLitePlanner<OpenList, BasicMap<double, FourConnected>>;
+template class BasicDStarLitePlanner<
+    OpenList, BasicMap<double, EightConnected>>;
+template class BasicDStarLitePlanner<
+    OpenList, BasicMap<double, SixteenConnected>>;
+template class BasicDStarLitePlanner<OpenList, BasicMap<float, FourConnected>>;
+template class BasicDStarLitePlanner<OpenList, BasicMap<float, EightConnected>>;
+template class BasicDStarLitePlanner<
+    OpenList, BasicMap<float, SixteenConnected>>;
+template class BasicDStarLitePlanner<
+    OpenList, BasicMap<FixedCost, FourConnected>>;
+template class BasicDStarLitePlanner<
+    OpenList, BasicMap<FixedCost, EightConnected>>;
+template class BasicDStarLitePlanner<
+    OpenList, BasicMap<FixedCost, SixteenConnected>>;
+template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<double, FourConnected>>;
+template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<double, EightConnected>>;
+template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<double, SixteenConnected>>;
+template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<float, FourConnected>>;
+template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<float, EightConnected>>;
+template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<float, SixteenConnected>>;
+template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<FixedCost, FourConnected>>;
+template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<FixedCost, EightConnected>>;
+template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<FixedCost, SixteenConnected>>;
@@ -0,0 +1,201 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file EventTrace.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class reads and writes event traces one line at a time.
+ * 
+ */
+
+#include "EventTrace.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include "MovingAiImporter.h"
+
+namespace {
+bool Inside(const std::pair<int, int> &position,
+            const std::pair<int, int> &size) {
+    return position.first >= 0 && position.first < size.first &&
+           position.second >= 0 && position.second < size.second;
+}
+}  // namespace
+
+/**
+ * @brief Read a trace.
+ * @param input the stream at the first line of the trace
+ * @return the trace
+ */
+EventTrace EventTrace::Read(std::istream &input) {
+    EventTrace trace;
+    trace.map_size = std::make_pair(0, 0);
+    trace.goal = std::make_pair(-1, -1);
+    trace.start = std::make_pair(-1, -1);
+    bool version_read = false;
+    int line_number = 0;
+    std::string line;
+    auto fail = [&line_number](const std::string &what) {
+        throw std::runtime_error("EventTrace: line " +
+                                 std::to_string(line_number) + ": " + what);
+    };
+    auto read_position = [&](std::istringstream *fields_ptr) {
+        std::pair<int, int> position;
+        if (!(*fields_ptr >> position.first >> position.second) ||
+            !Inside(position, trace.map_size))
+            fail("bad position");
+        return position;
+    };
+
+    while (std::getline(input, line)) {
+        ++line_number;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::istringstream fields(line);
+        std::string word;
+        if (!(fields >> word) || word[0] == '#') continue;
+        if (!version_read) {
+            int version = 0;
+            if (word != "dstarlite-trace" || !(fields >> version) ||
+                version != 1)
+                fail("not a trace of version 1");
+            version_read = true;
+        } else if (word == "size") {
+            if (!(fields >> trace.map_size.first >> trace.map_size.second) ||
+                trace.map_size.first <= 0 || trace.map_size.second <= 0)
+                fail("bad size");
+        } else if (word == "map") {
+            fields >> std::ws;
+            std::getline(fields, trace.map_file);
+            if (trace.map_file.empty()) fail("missing map file");
+        } else if (word == "goal") {
+            trace.goal = read_position(&fields);
+        } else if (word == "start") {
+            trace.start = read_position(&fields);
+        } else {
+            std::int64_t time_us = 0;
+            std::istringstream time_field(word);
+            if (!(time_field >> time_us) || !time_field.eof())
+                fail("unknown record " + word);
+            if (!Inside(trace.goal, trace.map_size) ||
+                !Inside(trace.start, trace.map_size))
+                fail("event before the size, the goal and the start");
+            if (!trace.events.empty() &&
+                time_us < trace.events.back().time_us)
+                fail("time goes back");
+            if (trace.events.empty() ||
+                time_us != trace.events.back().time_us)
+                trace.events.push_back(
+                    TraceEvent{time_us, false, trace.start, {}});
+            auto &event = trace.events.back();
+            std::string kind;
+            fields >> kind;
+            if (kind == "pose") {
+                event.moved = true;
+                event.pose = read_position(&fields);
+            } else if (kind == "block" || kind == "free") {
+                auto first_change = event.changes.size();
+                while (fields >> std::ws && !fields.eof()) {
+                    event.changes.push_back(
+                        CellChange{read_position(&fields), kind == "block"});
+                }
+                if (event.changes.size() == first_change)
+                    fail("no cells to " + kind);
+            } else {
+                fail("unknown event " + kind);
+            }
+            if (fields >> word) fail("extra field " + word);
+        }
+    }
+    if (!version_read || !Inside(trace.goal, trace.map_size) ||
+        !Inside(trace.start, trace.map_size))
+        throw std::runtime_error("EventTrace: incomplete trace");
+    return trace;
+}
+
+/**
+ * @brief Read a trace from a file. A relative map file is taken relative
+ *        to the directory of the trace.
+ * @param path the file to read
+ * @return the trace
+ */
+EventTrace EventTrace::Read(const std::string &path) {
+    std::ifstream input(path);
+    if (!input) throw std::runtime_error("EventTrace: cannot open " + path);
+    auto trace = Read(input);
+    auto slash = path.rfind('/');
+    if (!trace.map_file.empty() && trace.map_file[0] != '/' &&
+        slash != std::string::npos)
+        trace.map_file = path.substr(0, slash + 1) + trace.map_file;
+    return trace;
+}
+
+/**
+ * @brief Write the trace in the format Read takes. Events that neither move
+ *        the robot nor change a cell are left out.
+ * @param output the stream to write to
+ * @return none
+ */
+void EventTrace::Write(std::ostream &output) const {
+    output << "dstarlite-trace 1\n"
+           << "size " << map_size.first << " " << map_size.second << "\n";
+    if (!map_file.empty()) output << "map " << map_file << "\n";
+    output << "goal " << goal.first << " " << goal.second << "\n"
+           << "start " << start.first << " " << start.second << "\n";
+    for (auto const &event : events) {
+        if (event.moved)
+            output << event.time_us << " pose " << event.pose.first << " "
+                   << event.pose.second << "\n";
+        // runs of blocked or freed cells share a line, keeping their order
+        for (std::size_t k = 0; k < event.changes.size(); ++k) {
+            auto blocked = event.changes[k].blocked;
+            if (k == 0 || event.changes[k - 1].blocked != blocked)
+                output << (k == 0 ? "" : "\n") << event.time_us
+                       << (blocked ? " block" : " free");
+            output << " " << event.changes[k].position.first << " "
+                   << event.changes[k].position.second;
+        }
+        if (!event.changes.empty()) output << "\n";
+    }
+}
+
+/**
+ * @brief Get the obstacles the map of the trace starts with.
+ * @return the obstacles, from the map file or none
+ */
+OccupancyGrid EventTrace::LoadObstacles() const {
+    if (map_file.empty())
+        return OccupancyGrid(map_size.first, map_size.second);
+    bool text_map = map_file.size() > 4 &&
+                    map_file.substr(map_file.size() - 4) == ".map";
+    auto grid = text_map ? MovingAiImporter::ReadMap(map_file)
+                         : OccupancyGrid::Open(map_file);
+    if (grid.GetSize() != map_size)
+        throw std::runtime_error("EventTrace: map of another size " +
+                                 map_file);
+    return grid;
+}
@@ -0,0 +1,889 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file HierarchicalPlanner.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class plans with D* Lite on a graph of cluster entrances and refines
+ * the moves inside the cluster of the robot.
+ * 
+ */
+
+#include "HierarchicalPlanner.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+namespace {
+const double kInfinity = std::numeric_limits<double>::infinity();
+// runs of facing free cells at least this long get an entrance at each end
+const int kWideEntrance = 6;
+// the borders of a cluster, to its right, lower, lower-right and lower-left
+// neighbor; the last two are the single cell where four clusters meet
+const int kBorderSides = 4;
+const int kRightBorder = 0;
+const int kLowerBorder = 1;
+const int kLowerRightBorder = 2;
+const int kLowerLeftBorder = 3;
+}  // namespace
+
+/**
+ * @brief Constructor.
+ * @param map_ptr the pointer of the map, which must outlive the planner
+ * @param cluster_size the height and the width of a cluster
+ * @return none
+ */
+HierarchicalPlanner::HierarchicalPlanner(Map *map_ptr,
+                                         const int &cluster_size)
+    : map_ptr(map_ptr), cluster_size(cluster_size),
+      start(map_ptr->GetStart()) {
+    if (cluster_size < 2)
+        throw std::invalid_argument("HierarchicalPlanner: cluster too small");
+}
+
+/**
+ * @brief Build the abstract graph and insert the goal to the open list
+ * @return none
+ */
+void HierarchicalPlanner::Initialize() {
+    auto size = map_ptr->GetSize();
+    cluster_rows = (size.first + cluster_size - 1) / cluster_size;
+    cluster_cols = (size.second + cluster_size - 1) / cluster_size;
+    auto cluster_num = cluster_rows * cluster_cols;
+    cluster_nodes.assign(cluster_num, std::vector<int>());
+    border_nodes.assign(kBorderSides * cluster_num, std::vector<int>());
+    for (int border = 0; border < kBorderSides * cluster_num; ++border)
+        BuildBorder(border);
+    goal_node = AddNode(map_ptr->GetGoal());
+    start_node = AddNode(start);
+    for (int cluster = 0; cluster < cluster_num; ++cluster)
+        RebuildIntraEdges(cluster);
+
+    // One lookahead cost of the goal must be zero
+    rhs[goal_node] = 0.0;
+    openlist.Insert(CalculateKey(goal_node), std::make_pair(goal_node, 0));
+    DSTARLITE_STAT(++stats.openlist_inserts);
+}
+
+/**
+ * @brief Compute the shortest path on the abstract graph from the start
+ * @return none
+ */
+void HierarchicalPlanner::ComputeShortestPath() {
+    DSTARLITE_STAT(++stats.replans);
+    while (!openlist.Empty() &&
+           (openlist.Top().first < CalculateKey(start_node) ||
+            rhs[start_node] != g[start_node])) {
+        auto key_and_node = openlist.Top();
+        auto node = key_and_node.second;
+        auto id = node.first;
+        auto new_key = CalculateKey(id);
+
+        if (key_and_node.first < new_key) {
+            DSTARLITE_STAT(++stats.stale_key_expansions);
+            DSTARLITE_STAT(++stats.openlist_updates);
+            openlist.UpdateKey(new_key, node);
+            continue;
+        }
+        DSTARLITE_STAT(++stats.expansions);
+        if (g[id] > rhs[id]) {
+            DSTARLITE_STAT(++stats.overconsistent_expansions);
+            DSTARLITE_STAT(++stats.openlist_removes);
+            g[id] = rhs[id];
+            openlist.Remove(node);
+        } else {
+            DSTARLITE_STAT(++stats.underconsistent_expansions);
+            g[id] = kInfinity;
+            UpdateVertex(id);
+        }
+        // every edge has one the other way: successors are also
+        // predecessors
+        for (auto const &edge : nodes[id].intra) UpdateVertex(edge.to);
+        for (auto const &edge : nodes[id].inter) UpdateVertex(edge.to);
+    }
+}
+
+/**
+ * @brief Move the start to the robot's new position and connect it to the
+ *        nodes of its cluster. The start is a node of the graph, so the
+ *        search is repaired right away.
+ * @param new_start the position of the robot
+ * @return none
+ */
+void HierarchicalPlanner::MoveStart(const std::pair<int, int> &new_start) {
+    if (new_start == start) return;
+    key_modifier += map_ptr->ComputeHeuristic(start, new_start);
+    start = new_start;
+    std::vector<int> touched;
+    RemoveNode(start_node, &touched);
+    start_node = AddNode(start);
+    ConnectNode(start_node);
+    for (auto const &edge : nodes[start_node].intra)
+        touched.push_back(edge.to);
+    touched.push_back(start_node);
+    UpdateVertices(&touched);
+    ComputeShortestPath();
+}
+
+/**
+ * @brief Apply a batch of changed cells: rebuild the borders and clusters
+ *        they touch and update every affected node once. Call
+ *        ComputeShortestPath afterwards to repair the path.
+ * @param changes cells that became blocked or free
+ * @return if any cell really changed
+ */
+bool HierarchicalPlanner::ApplyChanges(
+     const std::vector<CellChange> &changes) {
+    std::vector<int> affected_clusters;
+    std::vector<int> affected_borders;
+    for (auto const &change : changes) {
+        auto index = map_ptr->CellIndex(change.position);
+        if (map_ptr->Blocked(index) == change.blocked) continue;
+        DSTARLITE_STAT(++stats.changed_cells);
+        map_ptr->UpdateStatusCode(index,
+                                  change.blocked ? Map::kObstacle : Map::kFree);
+        MarkChangedCell(change.position, &affected_clusters,
+                        &affected_borders);
+    }
+    return RepairClusters(&affected_clusters, &affected_borders);
+}
+
+/**
+ * @brief Apply a batch of terrain changes: the costs cached in the clusters
+ *        and on the borders they touch are computed again, and every
+ *        affected node is updated once. Call ComputeShortestPath afterwards
+ *        to repair the path.
+ * @param changes cells with their new terrain levels
+ * @return if any cell really changed
+ */
+bool HierarchicalPlanner::ApplyTerrainChanges(
+     const std::vector<TerrainChange> &changes) {
+    std::vector<int> affected_clusters;
+    std::vector<int> affected_borders;
+    for (auto const &change : changes) {
+        auto index = map_ptr->CellIndex(change.position);
+        if (map_ptr->CurrentTerrain(index) == change.terrain) continue;
+        DSTARLITE_STAT(++stats.changed_cells);
+        map_ptr->UpdateTerrain(index, change.terrain);
+        MarkChangedCell(change.position, &affected_clusters,
+                        &affected_borders);
+    }
+    return RepairClusters(&affected_clusters, &affected_borders);
+}
+
+/**
+ * @brief Mark the cluster of a changed cell and the borders that may cross
+ *        next to it.
+ * @param cell the position of the changed cell
+ * @param clusters_ptr the pointer of the clusters to rebuild
+ * @param borders_ptr the pointer of the borders to rebuild
+ * @return none
+ */
+void HierarchicalPlanner::MarkChangedCell(const std::pair<int, int> &cell,
+                                          std::vector<int> *clusters_ptr,
+                                          std::vector<int> *borders_ptr) {
+    clusters_ptr->push_back(ClusterOf(cell));
+    // A crossing uses the cell if it starts or ends there, or if the cell is
+    // beside a diagonal one: any border between the clusters around the
+    // cell may change
+    auto size = map_ptr->GetSize();
+    std::vector<int> nearby;
+    for (int row = cell.first - 1; row <= cell.first + 1; ++row) {
+        for (int col = cell.second - 1; col <= cell.second + 1; ++col) {
+            if (row >= 0 && row < size.first && col >= 0 && col < size.second)
+                nearby.push_back(ClusterOf(std::make_pair(row, col)));
+        }
+    }
+    for (auto const &cluster : nearby) {
+        for (auto const &other : nearby) {
+            if (cluster >= other) continue;
+            auto border = BorderBetween(cluster, other);
+            if (border >= 0) borders_ptr->push_back(border);
+        }
+    }
+}
+
+/**
+ * @brief Rebuild the marked borders and clusters, and update every node
+ *        they touch once.
+ * @param clusters_ptr the pointer of the changed clusters
+ * @param borders_ptr the pointer of the changed borders
+ * @return if anything was marked
+ */
+bool HierarchicalPlanner::RepairClusters(std::vector<int> *clusters_ptr,
+                                         std::vector<int> *borders_ptr) {
+    auto &affected_clusters = *clusters_ptr;
+    auto &affected_borders = *borders_ptr;
+    DSTARLITE_STAT(++stats.change_batches);
+    if (affected_clusters.empty()) {
+        last_repaired_cluster_num = 0;
+        return false;
+    }
+
+    // Entrances of changed borders are placed again
+    std::vector<int> touched;
+    std::sort(affected_borders.begin(), affected_borders.end());
+    affected_borders.erase(std::unique(affected_borders.begin(),
+                                       affected_borders.end()),
+                           affected_borders.end());
+    for (auto const &border : affected_borders) {
+        ClearBorder(border, &touched);
+        BuildBorder(border);
+        affected_clusters.push_back(border / kBorderSides);
+        affected_clusters.push_back(BorderNeighbor(border));
+    }
+
+    // Costs inside changed clusters are computed again
+    std::sort(affected_clusters.begin(), affected_clusters.end());
+    affected_clusters.erase(std::unique(affected_clusters.begin(),
+                                        affected_clusters.end()),
+                            affected_clusters.end());
+    for (auto const &cluster : affected_clusters) {
+        RebuildIntraEdges(cluster);
+        touched.insert(touched.end(), cluster_nodes[cluster].begin(),
+                       cluster_nodes[cluster].end());
+    }
+    last_repaired_cluster_num = static_cast<int>(affected_clusters.size());
+    UpdateVertices(&touched);
+    return true;
+}
+
+/**
+ * @brief Find hidden obstacles within the sensor radius of the robot and
+ *        recognize them as obstacles, all in one batch
+ * @param current_position robot's current position
+ * @return if there are hidden obstacle around
+ */
+bool HierarchicalPlanner::DetectHiddenObstacle(
+     const std::pair<int, int> &current_position) {
+    std::vector<int> hidden_indices;
+    map_ptr->Hidden().FindSetInWindow(current_position, sensor_radius,
+                                      &hidden_indices);
+    std::vector<CellChange> changes;
+    auto center = map_ptr->CellIndex(current_position);
+    for (auto const &index : hidden_indices) {
+        if (index != center)
+            changes.push_back(CellChange{map_ptr->CellPosition(index), true});
+    }
+    return ApplyChanges(changes);
+}
+
+/**
+ * @brief Set how far the robot senses hidden obstacles.
+ * @param radius the number of cells between the robot and the edge of the
+ *        square it senses
+ * @return none
+ */
+void HierarchicalPlanner::SetSensorRadius(const int &radius) {
+    if (radius < 0)
+        throw std::invalid_argument("HierarchicalPlanner: negative radius");
+    sensor_radius = radius;
+}
+
+/**
+ * @brief Find the next position of the robot: towards the first node of the
+ *        abstract path, along the search from the start inside its cluster.
+ * @return next position, or the current position if the goal is not
+ *         reachable
+ */
+std::pair<int, int> HierarchicalPlanner::NextMove() {
+    for (auto const &id : AbstractNodePath()) {
+        auto const &node = nodes[id];
+        if (node.cell == start) continue;
+        if (node.cluster != nodes[start_node].cluster) return node.cell;
+        // walk the parents back to the cell right after the start
+        auto origin = LocalIndex(node.cluster, start);
+        auto local = LocalIndex(node.cluster, node.cell);
+        while (start_parent[local] != origin) local = start_parent[local];
+        int first_row, first_col, end_row, end_col;
+        ClusterBounds(node.cluster, &first_row, &first_col, &end_row,
+                      &end_col);
+        auto width = end_col - first_col;
+        return std::make_pair(first_row + local / width,
+                              first_col + local % width);
+    }
+    return start;
+}
+
+/**
+ * @brief Get the cells of the nodes on the abstract path.
+ * @return cells from the start to the goal, or to where the path breaks
+ */
+std::vector<std::pair<int, int>> HierarchicalPlanner::AbstractPath() const {
+    std::vector<std::pair<int, int>> cells;
+    for (auto const &id : AbstractNodePath()) cells.push_back(nodes[id].cell);
+    return cells;
+}
+
+/**
+ * @brief Refine the abstract path into neighboring cells.
+ * @return cells from the start to the goal, or to where the path breaks
+ */
+std::vector<std::pair<int, int>> HierarchicalPlanner::RefinePath() {
+    auto node_path = AbstractNodePath();
+    std::vector<std::pair<int, int>> cells;
+    for (std::size_t i = 0; i < node_path.size(); ++i) {
+        auto const &node = nodes[node_path[i]];
+        if (i == 0) {
+            cells.push_back(node.cell);
+            continue;
+        }
+        auto const &previous = nodes[node_path[i - 1]];
+        if (node.cell == previous.cell) continue;
+        if (node.cluster != previous.cluster) {
+            cells.push_back(node.cell);
+            continue;
+        }
+        // the segment inside a cluster, walked back from its end
+        LocalSearch(node.cluster, previous.cell);
+        int first_row, first_col, end_row, end_col;
+        ClusterBounds(node.cluster, &first_row, &first_col, &end_row,
+                      &end_col);
+        auto width = end_col - first_col;
+        std::vector<std::pair<int, int>> segment;
+        auto origin = LocalIndex(node.cluster, previous.cell);
+        for (auto local = LocalIndex(node.cluster, node.cell);
+             local != origin; local = local_parent[local])
+            segment.push_back(std::make_pair(first_row + local / width,
+                                             first_col + local % width));
+        cells.insert(cells.end(), segment.rbegin(), segment.rend());
+    }
+    return cells;
+}
+
+/**
+ * @brief Get the cost of the abstract path.
+ * @return the g-value of the start, infinity without a path
+ */
+double HierarchicalPlanner::PathCost() const { return g[start_node]; }
+
+/**
+ * @brief Get the current start of the search.
+ * @return the position of the start
+ */
+std::pair<int, int> HierarchicalPlanner::CurrentStart() const {
+    return start;
+}
+
+/**
+ * @brief Get the size of the clusters.
+ * @return the height and the width of a cluster
+ */
+int HierarchicalPlanner::ClusterSize() const { return cluster_size; }
+
+/**
+ * @brief Get the number of nodes of the abstract graph.
+ * @return the number of live nodes
+ */
+std::size_t HierarchicalPlanner::AbstractNodeNum() const {
+    return nodes.size() - free_ids.size();
+}
+
+/**
+ * @brief Get the number of clusters rebuilt by the last batch of changes.
+ * @return the number of clusters
+ */
+int HierarchicalPlanner::LastRepairedClusterNum() const {
+    return last_repaired_cluster_num;
+}
+
+/**
+ * @brief Get the counters of the abstract search.
+ * @return the statistics
+ */
+const PlannerStats &HierarchicalPlanner::Stats() const { return stats; }
+
+/**
+ * @brief Get the cluster of a cell.
+ * @param cell the position of the cell
+ * @return the index of the cluster, row by row
+ */
+int HierarchicalPlanner::ClusterOf(const std::pair<int, int> &cell) const {
+    return (cell.first / cluster_size) * cluster_cols +
+           cell.second / cluster_size;
+}
+
+/**
+ * @brief Get the cells covered by a cluster.
+ * @param cluster the index of the cluster
+ * @param first_row_ptr the first row
+ * @param first_col_ptr the first column
+ * @param end_row_ptr the row after the last one
+ * @param end_col_ptr the column after the last one
+ * @return none
+ */
+void HierarchicalPlanner::ClusterBounds(const int &cluster,
+                                        int *first_row_ptr,
+                                        int *first_col_ptr, int *end_row_ptr,
+                                        int *end_col_ptr) const {
+    auto size = map_ptr->GetSize();
+    *first_row_ptr = (cluster / cluster_cols) * cluster_size;
+    *first_col_ptr = (cluster % cluster_cols) * cluster_size;
+    *end_row_ptr = std::min(*first_row_ptr + cluster_size, size.first);
+    *end_col_ptr = std::min(*first_col_ptr + cluster_size, size.second);
+}
+
+/**
+ * @brief Get the index of a cell among the cells of its cluster.
+ * @param cluster the index of the cluster
+ * @param cell the position of the cell
+ * @return the index, row by row inside the cluster
+ */
+int HierarchicalPlanner::LocalIndex(const int &cluster,
+                                    const std::pair<int, int> &cell) const {
+    int first_row, first_col, end_row, end_col;
+    ClusterBounds(cluster, &first_row, &first_col, &end_row, &end_col);
+    return (cell.first - first_row) * (end_col - first_col) +
+           cell.second - first_col;
+}
+
+/**
+ * @brief Add a node without edges, reusing the id of a removed node.
+ * @param cell the position of the node
+ * @return the id of the node
+ */
+int HierarchicalPlanner::AddNode(const std::pair<int, int> &cell) {
+    int id;
+    if (free_ids.empty()) {
+        id = static_cast<int>(nodes.size());
+        nodes.push_back(Node());
+        g.push_back(kInfinity);
+        rhs.push_back(kInfinity);
+    } else {
+        id = free_ids.back();
+        free_ids.pop_back();
+        g[id] = kInfinity;
+        rhs[id] = kInfinity;
+    }
+    auto &node = nodes[id];
+    node.cell = cell;
+    node.cluster = ClusterOf(cell);
+    node.alive = true;
+    node.intra.clear();
+    node.inter.clear();
+    cluster_nodes[node.cluster].push_back(id);
+    return id;
+}
+
+/**
+ * @brief Remove a node and every edge to it.
+ * @param id the id of the node
+ * @param touched_ptr the pointer of the nodes to update, the former
+ *        neighbors are appended
+ * @return none
+ */
+void HierarchicalPlanner::RemoveNode(const int &id,
+                                     std::vector<int> *touched_ptr) {
+    auto &node = nodes[id];
+    auto to_node = [id](const Edge &edge) { return edge.to == id; };
+    for (auto const &edge : node.intra) {
+        auto &edges = nodes[edge.to].intra;
+        edges.erase(std::remove_if(edges.begin(), edges.end(), to_node),
+                    edges.end());
+        touched_ptr->push_back(edge.to);
+    }
+    for (auto const &edge : node.inter) {
+        auto &edges = nodes[edge.to].inter;
+        edges.erase(std::remove_if(edges.begin(), edges.end(), to_node),
+                    edges.end());
+        touched_ptr->push_back(edge.to);
+    }
+    auto &members = cluster_nodes[node.cluster];
+    members.erase(std::remove(members.begin(), members.end(), id),
+                  members.end());
+    if (openlist.Find(std::make_pair(id, 0))) {
+        DSTARLITE_STAT(++stats.openlist_removes);
+        openlist.Remove(std::make_pair(id, 0));
+    }
+    node.alive = false;
+    node.intra.clear();
+    node.inter.clear();
+    free_ids.push_back(id);
+}
+
+/**
+ * @brief Get the border between two clusters.
+ * @param cluster the index of a cluster
+ * @param other the index of another cluster
+ * @return the index of the border, -1 if the clusters do not touch
+ */
+int HierarchicalPlanner::BorderBetween(const int &cluster,
+                                       const int &other) const {
+    auto first = std::min(cluster, other);
+    auto second = std::max(cluster, other);
+    for (int side = 0; side < kBorderSides; ++side) {
+        if (BorderNeighbor(kBorderSides * first + side) == second)
+            return kBorderSides * first + side;
+    }
+    return -1;
+}
+
+/**
+ * @brief Get the cluster on the other side of a border.
+ * @param border the index of the border
+ * @return the index of the cluster, -1 if the border is on the edge of the
+ *         map
+ */
+int HierarchicalPlanner::BorderNeighbor(const int &border) const {
+    auto cluster = border / kBorderSides;
+    auto side = border % kBorderSides;
+    auto row = cluster / cluster_cols + (side == kRightBorder ? 0 : 1);
+    auto col = cluster % cluster_cols +
+               (side == kLowerBorder ? 0 : side == kLowerLeftBorder ? -1 : 1);
+    if (row >= cluster_rows || col < 0 || col >= cluster_cols) return -1;
+    return row * cluster_cols + col;
+}
+
+/**
+ * @brief Add an entrance: a node on each side of a border and the edges of
+ *        the move between them.
+ * @param inside the cell in the cluster of the border
+ * @param outside the neighboring cell across the border
+ * @param border the index of the border
+ * @return none
+ */
+void HierarchicalPlanner::AddCrossing(const std::pair<int, int> &inside,
+                                      const std::pair<int, int> &outside,
+                                      const int &border) {
+    auto inside_node = AddNode(inside);
+    auto outside_node = AddNode(outside);
+    nodes[inside_node].inter.push_back(
+        Edge{outside_node, map_ptr->ComputeCost(inside, outside)});
+    nodes[outside_node].inter.push_back(
+        Edge{inside_node, map_ptr->ComputeCost(outside, inside)});
+    border_nodes[border].push_back(inside_node);
+    border_nodes[border].push_back(outside_node);
+}
+
+/**
+ * @brief Check whether a diagonal move is the only way between two cells:
+ *        both are free and both cells beside the move are blocked.
+ * @param from the position of one cell
+ * @param to the position of the diagonal neighbor
+ * @return true if only the diagonal move connects them
+ */
+bool HierarchicalPlanner::Squeezed(const std::pair<int, int> &from,
+                                   const std::pair<int, int> &to) const {
+    return !map_ptr->Blocked(map_ptr->CellIndex(from)) &&
+           !map_ptr->Blocked(map_ptr->CellIndex(to)) &&
+           map_ptr->Blocked(map_ptr->CellIndex(
+               std::make_pair(from.first, to.second))) &&
+           map_ptr->Blocked(map_ptr->CellIndex(
+               std::make_pair(to.first, from.second)));
+}
+
+/**
+ * @brief Place entrances on a border. On the right or lower border there is
+ *        one in the middle of each run of facing free cells, or one at each
+ *        end of a wide run, and one for each diagonal move no run covers;
+ *        on a corner, one for the diagonal move through it if nothing else
+ *        goes around.
+ * @param border the index of the border
+ * @return none
+ */
+void HierarchicalPlanner::BuildBorder(const int &border) {
+    if (BorderNeighbor(border) < 0) return;
+    auto cluster = border / kBorderSides;
+    auto side = border % kBorderSides;
+    int first_row, first_col, end_row, end_col;
+    ClusterBounds(cluster, &first_row, &first_col, &end_row, &end_col);
+    if (side == kLowerRightBorder || side == kLowerLeftBorder) {
+        auto right = side == kLowerRightBorder;
+        auto inside = std::make_pair(end_row - 1,
+                                     right ? end_col - 1 : first_col);
+        auto outside = std::make_pair(end_row,
+                                      right ? end_col : first_col - 1);
+        if (Squeezed(inside, outside)) AddCrossing(inside, outside, border);
+        return;
+    }
+
+    // cells along the border on this side and the step across it
+    auto lower = side == kLowerBorder;
+    auto line_begin = lower ? first_col : first_row;
+    auto line_end = lower ? end_col : end_row;
+    auto across = lower ? std::make_pair(1, 0) : std::make_pair(0, 1);
+    auto cell_at = [&](const int &offset) {
+        return lower ? std::make_pair(end_row - 1, offset)
+                     : std::make_pair(offset, end_col - 1);
+    };
+    auto across_from = [&](const std::pair<int, int> &inside) {
+        return std::make_pair(inside.first + across.first,
+                              inside.second + across.second);
+    };
+    auto facing = [&](const int &offset) {
+        auto inside = cell_at(offset);
+        return !map_ptr->Blocked(map_ptr->CellIndex(inside)) &&
+               !map_ptr->Blocked(map_ptr->CellIndex(across_from(inside)));
+    };
+    auto add_entrance = [&](const int &offset) {
+        auto inside = cell_at(offset);
+        AddCrossing(inside, across_from(inside), border);
+    };
+    for (int offset = line_begin; offset < line_end;) {
+        if (!facing(offset)) {
+            ++offset;
+            continue;
+        }
+        auto run_begin = offset;
+        while (offset < line_end && facing(offset)) ++offset;
+        auto run_last = offset - 1;
+        if (run_last - run_begin + 1 < kWideEntrance) {
+            add_entrance((run_begin + run_last) / 2);
+        } else {
+            add_entrance(run_begin);
+            add_entrance(run_last);
+        }
+    }
+    // a diagonal move with a free cell beside it is covered by a run, as
+    // the free cell faces one of its ends
+    for (int offset = line_begin; offset + 1 < line_end; ++offset) {
+        auto inside = cell_at(offset);
+        auto next_inside = cell_at(offset + 1);
+        if (Squeezed(inside, across_from(next_inside)))
+            AddCrossing(inside, across_from(next_inside), border);
+        if (Squeezed(next_inside, across_from(inside)))
+            AddCrossing(next_inside, across_from(inside), border);
+    }
+}
+
+/**
+ * @brief Remove the entrances on a border.
+ * @param border the index of the border
+ * @param touched_ptr the pointer of the nodes to update
+ * @return none
+ */
+void HierarchicalPlanner::ClearBorder(const int &border,
+                                      std::vector<int> *touched_ptr) {
+    auto &entrances = border_nodes[border];
+    for (auto const &id : entrances) RemoveNode(id, touched_ptr);
+    entrances.clear();
+}
+
+/**
+ * @brief Search the cheapest paths from a cell to all cells of its cluster
+ *        without leaving the cluster; results go to local_dist and
+ *        local_parent.
+ * @param cluster the index of the cluster
+ * @param source the position of the first cell
+ * @return none
+ */
+void HierarchicalPlanner::LocalSearch(const int &cluster,
+                                      const std::pair<int, int> &source) {
+    int first_row, first_col, end_row, end_col;
+    ClusterBounds(cluster, &first_row, &first_col, &end_row, &end_col);
+    auto width = end_col - first_col;
+    auto cell_num = static_cast<std::size_t>(end_row - first_row) * width;
+    local_dist.assign(cell_num, kInfinity);
+    local_parent.assign(cell_num, -1);
+
+    using Entry = std::pair<double, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>
+        frontier;
+    auto source_local = LocalIndex(cluster, source);
+    local_dist[source_local] = 0.0;
+    frontier.push(Entry(0.0, source_local));
+    while (!frontier.empty()) {
+        auto entry = frontier.top();
+        frontier.pop();
+        auto local = entry.second;
+        if (entry.first > local_dist[local]) continue;
+        auto index = map_ptr->CellIndex(std::make_pair(
+            first_row + local / width, first_col + local % width));
+        // the moves of the map, with the terrain of the cells they enter
+        map_ptr->ForEachNeighbor(index, [&](const Map::Neighbor &neighbor) {
+            auto next = map_ptr->CellPosition(neighbor.index);
+            if (next.first < first_row || next.first >= end_row ||
+                next.second < first_col || next.second >= end_col)
+                return;
+            auto next_local = (next.first - first_row) * width +
+                              next.second - first_col;
+            auto next_dist = entry.first + neighbor.cost;
+            if (next_dist < local_dist[next_local]) {
+                local_dist[next_local] = next_dist;
+                local_parent[next_local] = local;
+                frontier.push(Entry(next_dist, next_local));
+            }
+        });
+    }
+}
+
+/**
+ * @brief Compute the costs between every two nodes of a cluster again.
+ * @param cluster the index of the cluster
+ * @return none
+ */
+void HierarchicalPlanner::RebuildIntraEdges(const int &cluster) {
+    auto const &members = cluster_nodes[cluster];
+    for (auto const &id : members) nodes[id].intra.clear();
+    for (std::size_t i = 0; i < members.size(); ++i) {
+        auto id = members[i];
+        // the last node's edges are all known, unless it is the start,
+        // whose parents are needed for its moves
+        if (i + 1 == members.size() && id != start_node) break;
+        LocalSearch(cluster, nodes[id].cell);
+        if (id == start_node) start_parent = local_parent;
+        for (std::size_t j = i + 1; j < members.size(); ++j) {
+            auto other = members[j];
+            auto cost = local_dist[LocalIndex(cluster, nodes[other].cell)];
+            if (cost == kInfinity) continue;
+            nodes[id].intra.push_back(Edge{other, cost});
+            nodes[other].intra.push_back(
+                Edge{id, ReverseCost(id, other, cost)});
+        }
+    }
+}
+
+/**
+ * @brief Connect a new node to the other nodes of its cluster.
+ * @param id the id of the node
+ * @return none
+ */
+void HierarchicalPlanner::ConnectNode(const int &id) {
+    auto cluster = nodes[id].cluster;
+    LocalSearch(cluster, nodes[id].cell);
+    if (id == start_node) start_parent = local_parent;
+    for (auto const &other : cluster_nodes[cluster]) {
+        if (other == id) continue;
+        auto cost = local_dist[LocalIndex(cluster, nodes[other].cell)];
+        if (cost == kInfinity) continue;
+        nodes[id].intra.push_back(Edge{other, cost});
+        nodes[other].intra.push_back(Edge{id, ReverseCost(id, other, cost)});
+    }
+}
+
+/**
+ * @brief Get the cost of the way back between two nodes of a cluster. It
+ *        passes the same cells, but enters the first node instead of the
+ *        last, so only their terrains differ.
+ * @param from the id of the node the way starts at
+ * @param to the id of the node the way ends at
+ * @param cost the cost of the way from the first node to the second
+ * @return the cost of the way from the second node to the first
+ */
+double HierarchicalPlanner::ReverseCost(const int &from, const int &to,
+                                        const double &cost) const {
+    return cost + map_ptr->TerrainCost(map_ptr->CellIndex(nodes[from].cell)) -
+           map_ptr->TerrainCost(map_ptr->CellIndex(nodes[to].cell));
+}
+
+/**
+ * @brief Follow the cheapest successors from the start.
+ * @return ids of the nodes from the start to the goal, or to where the path
+ *         breaks
+ */
+std::vector<int> HierarchicalPlanner::AbstractNodePath() const {
+    std::vector<int> path = {start_node};
+    if (g[start_node] == kInfinity) return path;
+    // nodes sharing a cell are joined at no cost and may tie on g as well,
+    // so a node already on the path is never taken again
+    std::vector<bool> on_path(nodes.size(), false);
+    on_path[start_node] = true;
+    auto id = start_node;
+    while (id != goal_node) {
+        // on a tie the successor nearer to the goal wins
+        auto next_id = -1;
+        auto cheapest = std::make_pair(kInfinity, kInfinity);
+        for (auto const *edges : {&nodes[id].intra, &nodes[id].inter}) {
+            for (auto const &edge : *edges) {
+                if (on_path[edge.to]) continue;
+                auto candidate = std::make_pair(edge.cost + g[edge.to],
+                                                g[edge.to]);
+                if (candidate < cheapest) {
+                    cheapest = candidate;
+                    next_id = edge.to;
+                }
+            }
+        }
+        if (next_id < 0) break;
+        id = next_id;
+        on_path[id] = true;
+        path.push_back(id);
+    }
+    return path;
+}
+
+/**
+ * @brief Calculate the key of a node.
+ * @param id the id of the node
+ * @return the key
+ */
+Key HierarchicalPlanner::CalculateKey(const int &id) const {
+    auto value = std::min(g[id], rhs[id]);
+    return Key(value + map_ptr->ComputeHeuristic(start, nodes[id].cell) +
+               key_modifier, value);
+}
+
+/**
+ * @brief Update a node of the abstract graph
+ * @param id the id of the node
+ * @return none
+ */
+void HierarchicalPlanner::UpdateVertex(const int &id) {
+    DSTARLITE_STAT(++stats.update_vertex_calls);
+    if (id != goal_node) {
+        auto min_rhs = kInfinity;
+        for (auto const *edges : {&nodes[id].intra, &nodes[id].inter}) {
+            for (auto const &edge : *edges)
+                min_rhs = std::min(min_rhs, edge.cost + g[edge.to]);
+        }
+        rhs[id] = min_rhs;
+    }
+    auto node = std::make_pair(id, 0);
+    auto is_open = openlist.Find(node);
+    if (g[id] != rhs[id]) {
+        if (is_open) {
+            DSTARLITE_STAT(++stats.openlist_updates);
+            openlist.UpdateKey(CalculateKey(id), node);
+        } else {
+            DSTARLITE_STAT(++stats.openlist_inserts);
+            openlist.Insert(CalculateKey(id), node);
+            DSTARLITE_STAT(stats.max_openlist_size = std::max(
+                stats.max_openlist_size, openlist.Size()));
+        }
+    } else if (is_open) {
+        DSTARLITE_STAT(++stats.openlist_removes);
+        openlist.Remove(node);
+    }
+}
+
+/**
+ * @brief Update each live node of a list once.
+ * @param ids_ptr the pointer of the ids, sorted and emptied on return
+ * @return none
+ */
+void HierarchicalPlanner::UpdateVertices(std::vector<int> *ids_ptr) {
+    std::sort(ids_ptr->begin(), ids_ptr->end());
+    auto unique_end = std::unique(ids_ptr->begin(), ids_ptr->end());
+    DSTARLITE_STAT(stats.duplicate_vertices += ids_ptr->end() - unique_end);
+    for (auto id = ids_ptr->begin(); id != unique_end; ++id) {
+        if (nodes[*id].alive) UpdateVertex(*id);
+    }
+    ids_ptr->clear();
+}
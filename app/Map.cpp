@@ -31,11 +31,26 @@
  *
  * This class controls cells in the map and provides all infomation and 
  * all methods that related to the environment.
+ * Cells are stored in one contiguous row-major block: g-values, rhs-values
+ * and one-byte status codes live in separate arrays, obstacles and hidden
+ * obstacles in bit-packed occupancy grids. The block is padded with a border
+ * of obstacles. The g-values and rhs-values are of the cost type of the map;
+ * double, float and FixedCost maps are instantiated at the end.
  * 
  */
 
 #include "Map.h"
 #include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "Snapshot.h"
+
+template <typename CostType, typename Connectivity>
+constexpr int BasicMap<CostType, Connectivity>::kNeighborNum;
+template <typename CostType, typename Connectivity>
+constexpr int BasicMap<CostType, Connectivity>::kPadding;
+template <typename CostType, typename Connectivity>
+constexpr bool BasicMap<CostType, Connectivity>::kJumps;
 
 /**
  * @brief Constructor.
@@ -43,12 +58,43 @@
  * @param width the size of the map
  * @return none
  */
-Map::Map(const int &height, const int &width) {
-    std::vector<std::vector<Cell>> new_grid(
-        height,
-        std::vector<Cell>(width, Cell(infinity_cost)));
-    grid = new_grid;
-    map_size = std::make_pair(height, width);
+template <typename CostType, typename Connectivity>
+BasicMap<CostType, Connectivity>::BasicMap(const int &height, const int &width)
+    : obstacles(std::make_shared<OccupancyGrid>(height, width, true,
+                                                kPadding)),
+      hidden(height, width, false, kPadding) {
+    Initialize();
+}
+
+/**
+ * @brief Constructor, uses the occupancy grid as the obstacles of the map
+ * without copying it, so a grid mapped from a file stays mapped.
+ * @param occupancy the obstacles, set cells are blocked
+ * @return none
+ */
+template <typename CostType, typename Connectivity>
+BasicMap<CostType, Connectivity>::BasicMap(OccupancyGrid occupancy)
+    : obstacles(std::make_shared<OccupancyGrid>(std::move(occupancy))),
+      hidden(obstacles->GetSize().first, obstacles->GetSize().second, false,
+             kPadding) {
+    Initialize();
+}
+
+/**
+ * @brief Constructor, shares a read-only occupancy grid with other maps.
+ * Only the search values are allocated; the grid is copied the first time
+ * an obstacle of this map changes.
+ * @param base the obstacles, set cells are blocked
+ * @return none
+ */
+template <typename CostType, typename Connectivity>
+BasicMap<CostType, Connectivity>::BasicMap(
+        std::shared_ptr<const OccupancyGrid> base)
+    : obstacles(std::const_pointer_cast<OccupancyGrid>(base)),
+      obstacles_shared(true),
+      hidden(obstacles->GetSize().first, obstacles->GetSize().second, false,
+             kPadding) {
+    Initialize();
 }
 
 /**
@@ -57,12 +103,14 @@ Map::Map(const int &height, const int &width) {
  * @param hidden_obstacle a set of hidden obstackes's position
  * @return none
  */
-void Map::AddObstacle(const std::vector<std::pair<int, int>> &obstacle,
-                      const std::vector<std::pair<int, int>> &hidden_obstacle) {
+template <typename CostType, typename Connectivity>
+void BasicMap<CostType, Connectivity>::AddObstacle(
+        const std::vector<std::pair<int, int>> &obstacle,
+        const std::vector<std::pair<int, int>> &hidden_obstacle) {
     for (auto const &node : obstacle)
-        grid.at(node.first).at(node.second).UpdateStatus(obstacle_mark);
+        UpdateStatusCode(CheckedIndex(node), kObstacle);
     for (auto const &node : hidden_obstacle)
-        grid.at(node.first).at(node.second).UpdateStatus(unknown_mark);
+        UpdateStatusCode(CheckedIndex(node), kUnknown);
 }
 
 /**
@@ -70,24 +118,97 @@ void Map::AddObstacle(const std::vector<std::pair<int, int>> &obstacle,
  * @param new_goal the position of the goal
  * @return none
  */
-void Map::SetGoal(const std::pair<int, int> &new_goal) {
+template <typename CostType, typename Connectivity>
+void BasicMap<CostType, Connectivity>::SetGoal(
+        const std::pair<int, int> &new_goal) {
     goal = new_goal;
     UpdateCellStatus(new_goal, goal_mark);
 }
 
+/**
+ * @brief Set the start of the search and change cells's status.
+ * @param new_start the position of the start
+ * @return none
+ */
+template <typename CostType, typename Connectivity>
+void BasicMap<CostType, Connectivity>::SetStart(
+        const std::pair<int, int> &new_start) {
+    start = new_start;
+    key_modifier = 0.0;
+    UpdateCellStatus(new_start, start_mark);
+}
+
+/**
+ * @brief Move the start of the search before a replan. Keys already in the
+ *        open list stay valid lower bounds because the heuristic distance
+ *        moved is added to the key modifier (km).
+ * @param new_start the current position of the robot
+ * @return none
+ */
+template <typename CostType, typename Connectivity>
+void BasicMap<CostType, Connectivity>::UpdateStart(
+        const std::pair<int, int> &new_start) {
+    key_modifier += ComputeHeuristic(start, new_start);
+    start = new_start;
+}
+
+/**
+ * @brief Replace the default octile heuristic. The new heuristic must be
+ *        consistent with ComputeCost for the search to stay optimal.
+ * @param new_heuristic the heuristic, or an empty function for the default
+ * @return none
+ */
+template <typename CostType, typename Connectivity>
+void BasicMap<CostType, Connectivity>::SetHeuristic(
+        const HeuristicFunction &new_heuristic) {
+    heuristic = new_heuristic;
+}
+
+/**
+ * @brief Get the size of the map.
+ * @return the height and the width of the map
+ */
+template <typename CostType, typename Connectivity>
+std::pair<int, int> BasicMap<CostType, Connectivity>::GetSize() const {
+    return map_size;
+}
+
 /**
  * @brief Get the goal's position.
  * @return the position of the goal
  */
-std::pair<int, int> Map::GetGoal() const { return goal; }
+template <typename CostType, typename Connectivity>
+std::pair<int, int> BasicMap<CostType, Connectivity>::GetGoal() const {
+    return goal;
+}
+
+/**
+ * @brief Get the start's position.
+ * @return the position of the start
+ */
+template <typename CostType, typename Connectivity>
+std::pair<int, int> BasicMap<CostType, Connectivity>::GetStart() const {
+    return start;
+}
+
+/**
+ * @brief Get the key modifier (km) accumulated as the start moves.
+ * @return the key modifier
+ */
+template <typename CostType, typename Connectivity>
+double BasicMap<CostType, Connectivity>::GetKeyModifier() const {
+    return key_modifier;
+}
 
 /**
  * @brief Get the g-value of the cell with given position.
  * @param position the position of of the cell
  * @return cell's g-value
  */
-double Map::CurrentCellG(const std::pair<int, int> &position) const {
-    return grid.at(position.first).at(position.second).CurrentG();
+template <typename CostType, typename Connectivity>
+double BasicMap<CostType, Connectivity>::CurrentCellG(
+        const std::pair<int, int> &position) const {
+    return CostTraits<CostType>::ToDouble(g[CheckedIndex(position)]);
 }
 
 /**
@@ -95,17 +216,91 @@ double Map::CurrentCellG(const std::pair<int, int> &position) const {
  * @param position the position of of the cell
  * @return cell's rhs-value
  */
-double Map::CurrentCellRhs(const std::pair<int, int> &position) const {
-    return grid.at(position.first).at(position.second).CurrentRhs();
+template <typename CostType, typename Connectivity>
+double BasicMap<CostType, Connectivity>::CurrentCellRhs(
+        const std::pair<int, int> &position) const {
+    return CostTraits<CostType>::ToDouble(rhs[CheckedIndex(position)]);
 }
 
 /**
  * @brief Caculat the key (priority in search) of the cell with given position.
  * @param position the position of of the cell
- * @return the key value, which is the priority in next search
+ * @return the key [min(g, rhs) + h(start, s) + km; min(g, rhs)], which is
+ *         the priority in next search
+ */
+template <typename CostType, typename Connectivity>
+Key BasicMap<CostType, Connectivity>::CalculateCellKey(
+        const std::pair<int, int> &position) const {
+    auto min_value = std::min(CurrentCellG(position), CurrentCellRhs(position));
+    return std::make_pair(
+        min_value + ComputeHeuristic(start, position) + key_modifier,
+        min_value);
+}
+
+/**
+ * @brief Caculat the key of the cell with given index.
+ * @param index the index of of the cell
+ * @return the key [min(g, rhs) + h(start, s) + km; min(g, rhs)]
+ */
+template <typename CostType, typename Connectivity>
+Key BasicMap<CostType, Connectivity>::CalculateCellKey(const int &index) const {
+    auto min_value = CostTraits<CostType>::ToDouble(
+        std::min(g[index], rhs[index]));
+    return std::make_pair(
+        min_value + ComputeHeuristic(start, CellPosition(index)) + key_modifier,
+        min_value);
+}
+
+/**
+ * @brief Calculate the Anytime D* key of the cell with given index. Only an
+ *        overconsistent cell gets the inflated heuristic.
+ * @param index the index of the cell
+ * @param epsilon the inflation of the heuristic, at least 1
+ * @return the key [rhs + eps * h(start, s) + km; rhs] if g > rhs,
+ *         otherwise [g + h(start, s) + km; g]
+ */
+template <typename CostType, typename Connectivity>
+Key BasicMap<CostType, Connectivity>::CalculateCellKey(
+        const int &index, const double &epsilon) const {
+    auto heuristic_value = ComputeHeuristic(start, CellPosition(index));
+    if (g[index] > rhs[index]) {
+        auto rhs_value = CostTraits<CostType>::ToDouble(rhs[index]);
+        return std::make_pair(
+            rhs_value + epsilon * heuristic_value + key_modifier, rhs_value);
+    }
+    auto g_value = CostTraits<CostType>::ToDouble(g[index]);
+    return std::make_pair(g_value + heuristic_value + key_modifier, g_value);
+}
+
+/**
+ * @brief Estimate the cost between two positions. By default it is the
+ *        octile distance matching the transitional and diagonal costs.
+ * @param from_position the position to start from
+ * @param to_position the position to reach
+ * @return the estimated cost, never more than the real one
  */
-double Map::CalculateCellKey(const std::pair<int, int> &position) const {
-    return std::min(CurrentCellG(position), CurrentCellRhs(position));
+template <typename CostType, typename Connectivity>
+double BasicMap<CostType, Connectivity>::ComputeHeuristic(
+        const std::pair<int, int> &from_position,
+        const std::pair<int, int> &to_position) const {
+    if (heuristic) return heuristic(from_position, to_position);
+    auto rows = std::abs(from_position.first - to_position.first);
+    auto cols = std::abs(from_position.second - to_position.second);
+    auto along = std::max(rows, cols);
+    auto across = std::min(rows, cols);
+    // a diagonal step is never worth more than two transitional steps, and
+    // a knight step never more than a diagonal and a transitional one
+    auto diagonal_step = std::min(diagonal_cost, 2 * transitional_cost);
+    auto knight_step = std::min(knight_cost, diagonal_step + transitional_cost);
+    // each bound below charges no move more than it costs, so both are
+    // consistent; the second only counts where knight steps are cheap
+    auto octile = transitional_cost * along +
+                  std::min(diagonal_step - transitional_cost,
+                           knight_step - 2 * transitional_cost) *
+                      across;
+    auto knight = std::min(knight_step / 3, diagonal_step / 2) *
+                  (along + across);
+    return std::max(octile, knight);
 }
 
 /**
@@ -113,8 +308,50 @@ double Map::CalculateCellKey(const std::pair<int, int> &position) const {
  * @param position the position of of the cell
  * @return cell's status
  */
-std::string Map::CurrentCellStatus(const std::pair<int, int> &position) const {
-    return grid.at(position.first).at(position.second).CurrentStatus();
+template <typename CostType, typename Connectivity>
+std::string BasicMap<CostType, Connectivity>::CurrentCellStatus(
+        const std::pair<int, int> &position) const {
+    return status_marks[CurrentStatusCode(CheckedIndex(position))];
+}
+
+/**
+ * @brief Get the obstacles of the map, for example to save them to a file.
+ * @return the occupancy grid
+ */
+template <typename CostType, typename Connectivity>
+const OccupancyGrid &BasicMap<CostType, Connectivity>::Occupancy() const {
+    return *obstacles;
+}
+
+/**
+ * @brief Get the obstacles of the map to share them with other maps. Later
+ * changes of this map copy the grid first, so the shared one never changes.
+ * @return the occupancy grid
+ */
+template <typename CostType, typename Connectivity>
+std::shared_ptr<const OccupancyGrid>
+BasicMap<CostType, Connectivity>::SharedOccupancy() const {
+    return obstacles;
+}
+
+/**
+ * @brief Get the memory taken by the pages of per-cell values written so
+ *        far, which grows with the explored area.
+ * @return the size of the allocated pages in bytes
+ */
+template <typename CostType, typename Connectivity>
+std::size_t BasicMap<CostType, Connectivity>::AllocatedBytes() const {
+    return (g.AllocatedSize() + rhs.AllocatedSize()) * sizeof(CostType) +
+           status.AllocatedSize() + terrain.AllocatedSize();
+}
+
+/**
+ * @brief Get the hidden obstacles of the map, for window queries of sensors.
+ * @return the occupancy grid of hidden obstacles
+ */
+template <typename CostType, typename Connectivity>
+const OccupancyGrid &BasicMap<CostType, Connectivity>::Hidden() const {
+    return hidden;
 }
 
 /**
@@ -123,9 +360,10 @@ std::string Map::CurrentCellStatus(const std::pair<int, int> &position) const {
  * @param new_g new estamated distance to the goal
  * @return none
  */
-void Map::UpdateCellG(const std::pair<int, int> &position,
-                      const double &new_g) {
-    grid.at(position.first).at(position.second).UpdateG(new_g);
+template <typename CostType, typename Connectivity>
+void BasicMap<CostType, Connectivity>::UpdateCellG(
+        const std::pair<int, int> &position, const double &new_g) {
+    g.Set(CheckedIndex(position), CostTraits<CostType>::FromDouble(new_g));
 }
 
 /**
@@ -134,9 +372,11 @@ void Map::UpdateCellG(const std::pair<int, int> &position,
  * @param new_rhs one step lookahead values based on the g-values
  * @return none
  */
-void Map::UpdateCellRhs(const std::pair<int, int> &position,
-                        const double &new_rhs) {
-    grid.at(position.first).at(position.second).UpdateRhs(new_rhs);
+template <typename CostType, typename Connectivity>
+void BasicMap<CostType, Connectivity>::UpdateCellRhs(
+        const std::pair<int, int> &position, const double &new_rhs) {
+    rhs.Set(CheckedIndex(position),
+            CostTraits<CostType>::FromDouble(new_rhs));
 }
 
 /**
@@ -145,9 +385,11 @@ void Map::UpdateCellRhs(const std::pair<int, int> &position,
  * @param new_status a mark that represent the new status of the cell
  * @return none
  */
-void Map::UpdateCellStatus(const std::pair<int, int> &position,
-                           const std::string &new_status) {
-    grid.at(position.first).at(position.second).UpdateStatus(new_status);
+template <typename CostType, typename Connectivity>
+void BasicMap<CostType, Connectivity>::UpdateCellStatus(
+        const std::pair<int, int> &position, const std::string &new_status) {
+    UpdateStatusCode(CheckedIndex(position),
+                     static_cast<Status>(StatusCode(new_status)));
 }
 
 /**
@@ -155,46 +397,82 @@ void Map::UpdateCellStatus(const std::pair<int, int> &position,
  * @param position the position of of the cell
  * @return none
  */
-void Map::SetInfiityCellG(const std::pair<int, int> &position) {
-    UpdateCellG(position, infinity_cost);
+template <typename CostType, typename Connectivity>
+void BasicMap<CostType, Connectivity>::SetInfiityCellG(
+        const std::pair<int, int> &position) {
+    g.Set(CheckedIndex(position), infinity_cost);
 }
 
 /**
- * @brief Compust the cost of from current node to next node.
+ * @brief Compust the cost of from current node to next node, the terrain
+ *        of the next node included.
  * @param current_position current position of of the cell
  * @param next_position next position of of the cell
- * @return cost to travel
+ * @return cost to travel, infinity if the next node is blocked or not a
+ *         neighbor, or if the move jumps over an obstacle
+ */
+template <typename CostType, typename Connectivity>
+double BasicMap<CostType, Connectivity>::ComputeCost(
+        const std::pair<int, int> &current_position,
+        const std::pair<int, int> &next_position) {
+    auto infinity = CostTraits<CostType>::ToDouble(infinity_cost);
+    if (!Availability(next_position)) return infinity;
+    auto rows = next_position.first - current_position.first;
+    auto cols = next_position.second - current_position.second;
+    for (int k = 0; k < kNeighborNum; ++k) {
+        if (Connectivity::Row(k) != rows || Connectivity::Col(k) != cols)
+            continue;
+        if (Connectivity::Jumps(k) && !Passable(CellIndex(current_position), k))
+            return infinity;
+        return CostTraits<CostType>::ToDouble(
+                neighbor_cost[k] + TerrainCost(CellIndex(next_position)));
+    }
+    return infinity;
+}
+
+/**
+ * @brief Get the terrain level of the cell with given position.
+ * @param position the position of of the cell
+ * @return the terrain level, 0 for the cheapest
+ */
+template <typename CostType, typename Connectivity>
+int BasicMap<CostType, Connectivity>::CurrentCellTerrain(
+        const std::pair<int, int> &position) const {
+    return terrain[CheckedIndex(position)];
+}
+
+/**
+ * @brief Set the terrain level of the cell with given position. A planner
+ *        already searching the map must hear of it through
+ *        ApplyTerrainChanges.
+ * @param position the position of of the cell
+ * @param new_terrain the terrain level, from 0 to 255
+ * @return none
  */
-double Map::ComputeCost(const std::pair<int, int> &current_position,
-                        const std::pair<int, int> &next_position) {
-    if (!Availability(next_position)) return infinity_cost;
-    if (std::abs(current_position.first - next_position.first) +
-        std::abs(current_position.second - next_position.second) == 1)
-        return transitional_cost;
-    if (std::abs(current_position.first - next_position.first) +
-        std::abs(current_position.second - next_position.second) == 2)
-        return diagonal_cost;
-    else
-        return infinity_cost;
+template <typename CostType, typename Connectivity>
+void BasicMap<CostType, Connectivity>::UpdateCellTerrain(
+        const std::pair<int, int> &position, const int &new_terrain) {
+    if (new_terrain < 0 || new_terrain > 255)
+        throw std::invalid_argument("Map: terrain level out of range");
+    terrain.Set(CheckedIndex(position), static_cast<std::uint8_t>(new_terrain));
 }
 
 /**
- * @brief Find eight neighbos that are reachable: not a obstacle nor outside.
+ * @brief Find neighbos that are reachable: not a obstacle nor outside.
  * @param position current position of of the cell
- * @return a set of eight neighbors that are reachable
+ * @return a set of neighbors that are reachable
  */
-std::vector<std::pair<int, int>> Map::FindNeighbors(
-    const std::pair<int, int> & position) {
+template <typename CostType, typename Connectivity>
+std::vector<std::pair<int, int>>
+BasicMap<CostType, Connectivity>::FindNeighbors(
+        const std::pair<int, int> & position) {
     std::vector<std::pair<int, int>> neighbors = {};
-    std::vector<int> search_neighbor = {-1, 0, 1};
-    for (auto const &i : search_neighbor) {
-        for (auto const &j : search_neighbor) {
-            auto neighbor = std::make_pair(position.first + i,
-                                           position.second + j);
-            auto cost = ComputeCost(position, neighbor);
-            if (cost == transitional_cost || cost == diagonal_cost)
-                neighbors.push_back(neighbor);
-        }
+    for (int k = 0; k < kNeighborNum; ++k) {
+        auto neighbor = std::make_pair(position.first + Connectivity::Row(k),
+                                       position.second + Connectivity::Col(k));
+        if (Availability(neighbor) &&
+            (!Connectivity::Jumps(k) || Passable(CellIndex(position), k)))
+            neighbors.push_back(neighbor);
     }
     return neighbors;
 }
@@ -204,34 +482,114 @@ std::vector<std::pair<int, int>> Map::FindNeighbors(
  * @param position the position of next position
  * @return true if accessible and flase if not 
  */
-bool Map::Availability(const std::pair<int, int> & position) {
-    if (position.first < 0 || position.first >= map_size.first) return false;
-    if (position.second < 0 || position.second >= map_size.second) return false;
-    return grid.at(position.first).at(position.second).CurrentStatus()
-           != obstacle_mark;
+template <typename CostType, typename Connectivity>
+bool BasicMap<CostType, Connectivity>::Availability(
+        const std::pair<int, int> & position) {
+    if (!Inside(position)) return false;
+    return !Blocked(CellIndex(position));
+}
+
+/**
+ * @brief Write the map into a snapshot: its type and size, the goal, the
+ *        start and km in the header, the grids, the allocated pages and the
+ *        custom status marks in sections.
+ * @param writer the snapshot being written
+ * @return none
+ */
+template <typename CostType, typename Connectivity>
+void BasicMap<CostType, Connectivity>::WriteSnapshot(
+        SnapshotWriter *writer) const {
+    auto &header = writer->Header();
+    header.cost_size = sizeof(CostType);
+    header.cost_is_integer = std::numeric_limits<CostType>::is_integer;
+    header.neighbor_num = kNeighborNum;
+    header.padding = kPadding;
+    header.height = map_size.first;
+    header.width = map_size.second;
+    header.goal[0] = goal.first;
+    header.goal[1] = goal.second;
+    header.map_start[0] = start.first;
+    header.map_start[1] = start.second;
+    header.key_modifier = key_modifier;
+    header.obstacles_offset = writer->AppendGrid(*obstacles);
+    header.hidden_offset = writer->AppendGrid(hidden);
+    header.g_offset = writer->AppendPages(g);
+    header.rhs_offset = writer->AppendPages(rhs);
+    header.status_offset = writer->AppendPages(status);
+    header.terrain_offset = writer->AppendPages(terrain);
+    std::string marks;
+    for (std::size_t code = kRobot + 1; code < status_marks.size(); ++code)
+        marks += status_marks[code] + '\0';
+    header.marks_size = marks.size();
+    header.marks_offset = writer->Append(marks.data(), marks.size(), 1);
+}
+
+/**
+ * @brief Restore the map from a snapshot of a map of the same type. The
+ *        grids stay mapped and the pages stay borrowed from the snapshot,
+ *        so nothing per cell is copied or read before it is used.
+ * @param reader the snapshot
+ * @return none
+ */
+template <typename CostType, typename Connectivity>
+void BasicMap<CostType, Connectivity>::ReadSnapshot(
+        const SnapshotReader &reader) {
+    auto const &header = reader.Header();
+    if (header.cost_size != sizeof(CostType) ||
+        header.cost_is_integer != std::numeric_limits<CostType>::is_integer ||
+        header.neighbor_num != kNeighborNum || header.padding != kPadding)
+        throw std::runtime_error("Map: snapshot of another type of map");
+    auto new_obstacles = std::make_shared<OccupancyGrid>(
+        OccupancyGrid::Open(reader.Path(), header.obstacles_offset));
+    auto new_hidden =
+        OccupancyGrid::Open(reader.Path(), header.hidden_offset, false);
+    auto size = std::make_pair(header.height, header.width);
+    if (new_obstacles->GetSize() != size || new_hidden.GetSize() != size ||
+        new_obstacles->Padding() != kPadding ||
+        new_hidden.Padding() != kPadding)
+        throw std::runtime_error("Map: corrupt snapshot");
+    auto marks = reader.At<const char>(header.marks_offset, header.marks_size);
+
+    obstacles = std::move(new_obstacles);
+    obstacles_shared = false;
+    hidden = std::move(new_hidden);
+    Initialize();
+    reader.BorrowPages(header.g_offset, &g);
+    reader.BorrowPages(header.rhs_offset, &rhs);
+    reader.BorrowPages(header.status_offset, &status);
+    reader.BorrowPages(header.terrain_offset, &terrain);
+    for (std::uint64_t begin = 0, end = 0; end < header.marks_size; ++end) {
+        if (marks[end] != '\0') continue;
+        StatusCode(std::string(marks + begin, marks + end));
+        begin = end + 1;
+    }
+    goal = std::make_pair(header.goal[0], header.goal[1]);
+    start = std::make_pair(header.map_start[0], header.map_start[1]);
+    key_modifier = header.key_modifier;
 }
 
 /**
  *
  * @brief Visualize all g-values and rhs-values in the map on the terminal.
+ *        The output is flushed once at the end.
  *  
  */
-void Map::PrintValue() {
-    std::vector<std::string> lines(map_size.second, "-------------");
-    std::cout << "Value for shortest path:" << std::endl
-        << "(g, rhs): " << std::endl<< " -";
-    for (auto line : lines) std::cout << line;
-    std::cout << std::endl;
-    for (auto const &row : grid) {
+template <typename CostType, typename Connectivity>
+void BasicMap<CostType, Connectivity>::PrintValue() const {
+    std::string line = " -";
+    for (int j = 0; j < map_size.second; ++j) line += "-------------";
+    std::cout << "Value for shortest path:\n" << "(g, rhs): \n"
+              << line << '\n';
+    for (int i = 0; i < map_size.first; ++i) {
         std::cout << " | ";
-        for (auto const &cell : row) {
+        for (int j = 0; j < map_size.second; ++j) {
+            auto index = CellIndex(std::make_pair(i, j));
             std::cout << "(" << std::setfill(' ') << std::setw(3)
-                      << cell.CurrentG() << ", "  << std::setfill(' ')
-                      << std::setw(3) << cell.CurrentRhs() << ") | ";
+                      << CostTraits<CostType>::ToDouble(g[index]) << ", "
+                      << std::setfill(' ') << std::setw(3)
+                      << CostTraits<CostType>::ToDouble(rhs[index]) << ") | ";
         }
-        std::cout << std::endl << " -";
-        for (auto line : lines) std::cout << line;
-        std::cout << std::endl;
+        std::cout << '\n' << line << '\n';
     }
     std::cout << std::endl;
 }
@@ -239,25 +597,124 @@ void Map::PrintValue() {
 /**
  *
  * @brief Visualize the map and the path the robot has traveled on the terminal.
+ *        The output is flushed once at the end.
  *  
  */
-void Map::PrintResult() {
-    std::vector<std::string> lines(map_size.second, "----");
-    std::cout << "Result: " << std::endl
+template <typename CostType, typename Connectivity>
+void BasicMap<CostType, Connectivity>::PrintResult() const {
+    std::string line = " -";
+    for (int j = 0; j < map_size.second; ++j) line += "----";
+    std::cout << "Result: \n"
         << "start: " << start_mark << " goal: " << goal_mark << " robot: "
         << robot_mark << " obstacle: " << obstacle_mark << " unknown: "
-        << unknown_mark << std::endl;
-    std::cout << " -";
-    for (auto line : lines) std::cout << line;
-    std::cout << std::endl;
-    for (auto const &row : grid) {
+        << unknown_mark << '\n' << line << '\n';
+    for (int i = 0; i < map_size.first; ++i) {
         std::cout << " | ";
-        for (auto const &cell : row) {
-            std::cout << cell.CurrentStatus() << " | ";
+        for (int j = 0; j < map_size.second; ++j) {
+            std::cout << status_marks[CurrentStatusCode(
+                             CellIndex(std::make_pair(i, j)))]
+                      << " | ";
         }
-        std::cout << std::endl << " -";
-        for (auto line : lines) std::cout << line;
-        std::cout << std::endl;
+        std::cout << '\n' << line << '\n';
     }
     std::cout << std::endl;
 }
+
+/**
+ * @brief Check if the position is inside the map.
+ * @param position the position of of the cell
+ * @return true if inside and false if not
+ */
+template <typename CostType, typename Connectivity>
+bool BasicMap<CostType, Connectivity>::Inside(
+        const std::pair<int, int> &position) const {
+    return position.first >= 0 && position.first < map_size.first &&
+           position.second >= 0 && position.second < map_size.second;
+}
+
+/**
+ * @brief Get the index of the cell with given position, checking the range.
+ * @param position the position of of the cell
+ * @return the index of the cell in the row-major arrays
+ */
+template <typename CostType, typename Connectivity>
+int BasicMap<CostType, Connectivity>::CheckedIndex(
+        const std::pair<int, int> &position) const {
+    if (!Inside(position)) throw std::out_of_range("Map: position outside");
+    return CellIndex(position);
+}
+
+/**
+ * @brief Size the search values after the obstacle grid. Nothing is
+ *        allocated per cell until a value other than the default is set.
+ * @return none
+ */
+template <typename CostType, typename Connectivity>
+void BasicMap<CostType, Connectivity>::Initialize() {
+    if (obstacles->Padding() != kPadding)
+        throw std::invalid_argument("Map: border too narrow for the moves");
+    map_size = obstacles->GetSize();
+    row_stride = map_size.second + 2 * kPadding;
+    auto cell_num = static_cast<std::size_t>(map_size.first + 2 * kPadding) *
+                    row_stride;
+    g.Assign(cell_num, infinity_cost);
+    rhs.Assign(cell_num, infinity_cost);
+    // obstacles live in the grid; status codes only keep the other marks
+    status.Assign(cell_num, kFree);
+    terrain.Assign(cell_num, 0);
+    for (std::size_t level = 0; level < terrain_cost.size(); ++level)
+        terrain_cost[level] =
+            CostTraits<CostType>::FromDouble(level * terrain_step);
+    for (int k = 0; k < kNeighborNum; ++k) {
+        neighbor_offset[k] = Connectivity::Row(k) * row_stride +
+                             Connectivity::Col(k);
+        neighbor_cost[k] =
+            CostTraits<CostType>::FromDouble(Connectivity::Cost(k));
+        pass_offset[k] = Connectivity::PassRow(k) * row_stride +
+                         Connectivity::PassCol(k);
+    }
+    status_marks = {" ", obstacle_mark, unknown_mark,
+                    goal_mark, start_mark, robot_mark};
+}
+
+/**
+ * @brief Get the obstacles for writing, copying them first if they are
+ * shared with anything else.
+ * @return the occupancy grid owned by this map alone
+ */
+template <typename CostType, typename Connectivity>
+OccupancyGrid &BasicMap<CostType, Connectivity>::OwnedObstacles() {
+    if (obstacles_shared || obstacles.use_count() > 1) {
+        obstacles = std::make_shared<OccupancyGrid>(*obstacles);
+        obstacles_shared = false;
+    }
+    return *obstacles;
+}
+
+/**
+ * @brief Get the status code of a mark. Marks other than the predefined ones
+ *        get a new code the first time they are used.
+ * @param mark a mark that represent a status
+ * @return the status code
+ */
+template <typename CostType, typename Connectivity>
+std::uint8_t BasicMap<CostType, Connectivity>::StatusCode(
+        const std::string &mark) {
+    auto found = std::find(status_marks.begin(), status_marks.end(), mark);
+    if (found != status_marks.end())
+        return static_cast<std::uint8_t>(found - status_marks.begin());
+    if (status_marks.size() > UINT8_MAX)
+        throw std::length_error("Map: too many status marks");
+    status_marks.push_back(mark);
+    return static_cast<std::uint8_t>(status_marks.size() - 1);
+}
+
+template class BasicMap<double, FourConnected>;
+template class BasicMap<double, EightConnected>;
+template class BasicMap<double, SixteenConnected>;
+template class BasicMap<float, FourConnected>;
+template class BasicMap<float, EightConnected>;
+template class BasicMap<float, SixteenConnected>;
+template class BasicMap<FixedCost, FourConnected>;
+template class BasicMap<FixedCost, EightConnected>;
+template class BasicMap<FixedCost, SixteenConnected>;
@@ -0,0 +1,275 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file MapGenerator.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class fills maps of any size with procedural obstacles: random
+ * density, mazes, rooms and doors, and warehouse aisles. It also hides
+ * obstacles for the robot to discover. Used by the benchmark and the tests.
+ * 
+ */
+
+#include "MapGenerator.h"
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief Constructor.
+ * @param seed the seed of the random number generator
+ * @return none
+ */
+MapGenerator::MapGenerator(const unsigned int &seed) : generator(seed) {}
+
+/**
+ * @brief Block every cell with the same probability.
+ * @param map_ptr the pointer of the map
+ * @param density the probability of a cell to be an obstacle
+ * @return none
+ */
+void MapGenerator::RandomObstacles(Map *map_ptr, const double &density) {
+    std::bernoulli_distribution is_obstacle(density);
+    auto size = map_ptr->GetSize();
+    for (int i = 0; i < size.first; ++i) {
+        for (int j = 0; j < size.second; ++j) {
+            if (is_obstacle(generator)) Block(map_ptr, i, j);
+        }
+    }
+}
+
+/**
+ * @brief Carve a perfect maze with a randomized depth-first search. Walls
+ *        are one cell thick.
+ * @param map_ptr the pointer of the map
+ * @param corridor_width the width of the corridors
+ * @return none
+ */
+void MapGenerator::Maze(Map *map_ptr, const int &corridor_width) {
+    auto size = map_ptr->GetSize();
+    auto pitch = corridor_width + 1;
+    auto maze_height = (size.first - corridor_width) / pitch + 1;
+    auto maze_width = (size.second - corridor_width) / pitch + 1;
+    for (int i = 0; i < size.first; ++i) {
+        for (int j = 0; j < size.second; ++j) Block(map_ptr, i, j);
+    }
+    if (maze_height <= 0 || maze_width <= 0) return;
+
+    // clear the cells of the maze, rows [i, i + height), cols [j, j + width)
+    auto carve = [&](const int &row, const int &col,
+                     const int &height, const int &width) {
+        for (int i = row; i < std::min(row + height, size.first); ++i) {
+            for (int j = col; j < std::min(col + width, size.second); ++j)
+                Free(map_ptr, i, j);
+        }
+    };
+
+    std::vector<bool> visited(
+        static_cast<std::size_t>(maze_height) * maze_width, false);
+    std::vector<int> stack = {0};
+    visited[0] = true;
+    carve(0, 0, corridor_width, corridor_width);
+    const int kRows[4] = {-1, 1, 0, 0};
+    const int kCols[4] = {0, 0, -1, 1};
+    while (!stack.empty()) {
+        auto current = stack.back();
+        auto row = current / maze_width;
+        auto col = current % maze_width;
+        int candidates[4];
+        int candidate_num = 0;
+        for (int k = 0; k < 4; ++k) {
+            auto next_row = row + kRows[k];
+            auto next_col = col + kCols[k];
+            if (next_row < 0 || next_row >= maze_height ||
+                next_col < 0 || next_col >= maze_width) continue;
+            if (!visited[next_row * maze_width + next_col])
+                candidates[candidate_num++] = k;
+        }
+        if (candidate_num == 0) {
+            stack.pop_back();
+            continue;
+        }
+        std::uniform_int_distribution<int> pick(0, candidate_num - 1);
+        auto k = candidates[pick(generator)];
+        auto next_row = row + kRows[k];
+        auto next_col = col + kCols[k];
+        // the corridor cell and the wall between the two cells
+        carve(next_row * pitch, next_col * pitch,
+              corridor_width, corridor_width);
+        carve(std::min(row, next_row) * pitch +
+              (kRows[k] != 0 ? corridor_width : 0),
+              std::min(col, next_col) * pitch +
+              (kCols[k] != 0 ? corridor_width : 0),
+              kRows[k] != 0 ? 1 : corridor_width,
+              kCols[k] != 0 ? 1 : corridor_width);
+        visited[next_row * maze_width + next_col] = true;
+        stack.push_back(next_row * maze_width + next_col);
+    }
+}
+
+/**
+ * @brief Split the map into square rooms with one door in every wall
+ *        between two rooms.
+ * @param map_ptr the pointer of the map
+ * @param room_size the inner size of a room
+ * @param door_width the width of a door
+ * @return none
+ */
+void MapGenerator::RoomsAndDoors(Map *map_ptr, const int &room_size,
+                                 const int &door_width) {
+    auto size = map_ptr->GetSize();
+    auto pitch = room_size + 1;
+    auto door = std::min(door_width, room_size);
+    std::uniform_int_distribution<int> door_offset(0, room_size - door);
+    for (int i = 0; i < size.first; ++i) {
+        for (int j = 0; j < size.second; ++j) {
+            if (i % pitch == room_size || j % pitch == room_size)
+                Block(map_ptr, i, j);
+        }
+    }
+    // a door in every wall segment along the rows and along the columns
+    for (int wall = room_size; wall < size.first; wall += pitch) {
+        for (int room = 0; room < size.second; room += pitch) {
+            auto offset = room + door_offset(generator);
+            for (int j = offset; j < std::min(offset + door, size.second); ++j)
+                Free(map_ptr, wall, j);
+        }
+    }
+    for (int wall = room_size; wall < size.second; wall += pitch) {
+        for (int room = 0; room < size.first; room += pitch) {
+            auto offset = room + door_offset(generator);
+            for (int i = offset; i < std::min(offset + door, size.first); ++i)
+                Free(map_ptr, i, wall);
+        }
+    }
+}
+
+/**
+ * @brief Lay out rows of two-cell deep shelves separated by aisles, with
+ *        cross aisles between shelves.
+ * @param map_ptr the pointer of the map
+ * @param shelf_length the length of a shelf
+ * @param aisle_width the width of the aisles
+ * @return none
+ */
+void MapGenerator::WarehouseAisles(Map *map_ptr, const int &shelf_length,
+                                   const int &aisle_width) {
+    auto size = map_ptr->GetSize();
+    const int kShelfDepth = 2;
+    auto row_period = kShelfDepth + aisle_width;
+    auto col_period = shelf_length + aisle_width;
+    for (int i = 0; i < size.first; ++i) {
+        for (int j = 0; j < size.second; ++j) {
+            if (i % row_period >= aisle_width && j % col_period >= aisle_width)
+                Block(map_ptr, i, j);
+        }
+    }
+}
+
+/**
+ * @brief Fill the map with one of the layouts, using default parameters.
+ * @param map_ptr the pointer of the map
+ * @param kind "empty", "random", "maze", "rooms" or "warehouse"
+ * @return true if the kind of layout is known
+ */
+bool MapGenerator::Generate(Map *map_ptr, const std::string &kind) {
+    if (kind == "empty") return true;
+    if (kind == "random") {
+        RandomObstacles(map_ptr, 0.25);
+    } else if (kind == "maze") {
+        Maze(map_ptr, 2);
+    } else if (kind == "rooms") {
+        RoomsAndDoors(map_ptr, 30, 3);
+    } else if (kind == "warehouse") {
+        WarehouseAisles(map_ptr, 20, 3);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Turn free cells into hidden obstacles, which the robot only
+ *        discovers next to them.
+ * @param map_ptr the pointer of the map
+ * @param density the probability of a free cell to hide an obstacle
+ * @return none
+ */
+void MapGenerator::AddHiddenObstacles(Map *map_ptr, const double &density) {
+    std::bernoulli_distribution is_hidden(density);
+    auto size = map_ptr->GetSize();
+    for (int i = 0; i < size.first; ++i) {
+        for (int j = 0; j < size.second; ++j) {
+            auto index = map_ptr->CellIndex(std::make_pair(i, j));
+            if (map_ptr->CurrentStatusCode(index) == Map::kFree &&
+                is_hidden(generator))
+                map_ptr->UpdateStatusCode(index, Map::kUnknown);
+        }
+    }
+}
+
+/**
+ * @brief Free a square area, for example around the start or the goal.
+ * @param map_ptr the pointer of the map
+ * @param center the center of the area
+ * @param radius half of the side of the area
+ * @return none
+ */
+void MapGenerator::ClearArea(Map *map_ptr, const std::pair<int, int> &center,
+                             const int &radius) {
+    auto size = map_ptr->GetSize();
+    for (int i = std::max(0, center.first - radius);
+         i <= std::min(size.first - 1, center.first + radius); ++i) {
+        for (int j = std::max(0, center.second - radius);
+             j <= std::min(size.second - 1, center.second + radius); ++j)
+            Free(map_ptr, i, j);
+    }
+}
+
+/**
+ * @brief Make a cell an obstacle.
+ * @param map_ptr the pointer of the map
+ * @param row the row of the cell
+ * @param col the column of the cell
+ * @return none
+ */
+void MapGenerator::Block(Map *map_ptr, const int &row, const int &col) {
+    map_ptr->UpdateStatusCode(map_ptr->CellIndex(std::make_pair(row, col)),
+                              Map::kObstacle);
+}
+
+/**
+ * @brief Make a cell free.
+ * @param map_ptr the pointer of the map
+ * @param row the row of the cell
+ * @param col the column of the cell
+ * @return none
+ */
+void MapGenerator::Free(Map *map_ptr, const int &row, const int &col) {
+    map_ptr->UpdateStatusCode(map_ptr->CellIndex(std::make_pair(row, col)),
+                              Map::kFree);
+}
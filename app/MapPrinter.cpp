@@ -0,0 +1,58 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file MapPrinter.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This observer visualizes the map on the terminal: the values and the
+ * result after every replan, and the result after every step.
+ * 
+ */
+
+#include "MapPrinter.h"
+
+/**
+ * @brief Show the new computed shortest path.
+ * @param map the map
+ * @param start the start of the search
+ * @return none
+ */
+void MapPrinter::OnReplan(const Map &map, const std::pair<int, int> &) {
+    map.PrintValue();
+    map.PrintResult();
+}
+
+/**
+ * @brief Show the map after the robot moved.
+ * @param map the map
+ * @param position the new position of the robot
+ * @return none
+ */
+void MapPrinter::OnStep(const Map &map, const std::pair<int, int> &) {
+    map.PrintResult();
+}
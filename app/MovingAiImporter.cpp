@@ -0,0 +1,144 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file MovingAiImporter.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * These classes read the grid benchmarks of the Moving AI Lab one line at a
+ * time.
+ * 
+ */
+
+#include "MovingAiImporter.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+void StripCarriageReturn(std::string *line) {
+    if (!line->empty() && line->back() == '\r') line->pop_back();
+}
+}  // namespace
+
+/**
+ * @brief Read a .map file; out-of-bound cells, trees and water are blocked.
+ * @param input the stream positioned at the "type" line
+ * @return the occupancy grid, set cells are obstacles
+ */
+OccupancyGrid MovingAiImporter::ReadMap(std::istream &input) {
+    int height = 0;
+    int width = 0;
+    std::string line;
+    while (std::getline(input, line)) {
+        StripCarriageReturn(&line);
+        std::istringstream fields(line);
+        std::string name;
+        fields >> name;
+        if (name == "map") break;
+        if (name == "height") fields >> height;
+        else if (name == "width") fields >> width;
+        else if (name != "type" && !name.empty())
+            throw std::runtime_error("MovingAiImporter: bad header " + line);
+    }
+    if (!input || height <= 0 || width <= 0)
+        throw std::runtime_error("MovingAiImporter: missing map header");
+
+    OccupancyGrid grid(height, width);
+    for (int i = 0; i < height; ++i) {
+        if (!std::getline(input, line))
+            throw std::runtime_error("MovingAiImporter: missing map rows");
+        StripCarriageReturn(&line);
+        if (static_cast<int>(line.size()) < width)
+            throw std::runtime_error("MovingAiImporter: short map row");
+        int index = grid.CellIndex(std::make_pair(i, 0));
+        for (int j = 0; j < width; ++j, ++index)
+            if (!Passable(line[j])) grid.Set(index);
+    }
+    return grid;
+}
+
+/**
+ * @brief Read a .map file.
+ * @param path the file to read
+ * @return the occupancy grid, set cells are obstacles
+ */
+OccupancyGrid MovingAiImporter::ReadMap(const std::string &path) {
+    std::ifstream input(path);
+    if (!input)
+        throw std::runtime_error("MovingAiImporter: cannot open " + path);
+    return ReadMap(input);
+}
+
+/**
+ * @brief Check whether a terrain character of a .map file can be crossed.
+ * @param terrain the character
+ * @return true for ground and swamp
+ */
+bool MovingAiImporter::Passable(const char &terrain) {
+    return terrain == '.' || terrain == 'G' || terrain == 'S';
+}
+
+/**
+ * @brief Constructor, skips the version line if present.
+ * @param input the .scen stream
+ * @return none
+ */
+MovingAiScenarioReader::MovingAiScenarioReader(std::istream &input)
+    : input(input) {
+    if (input.peek() == 'v') {
+        std::string version;
+        std::getline(input, version);
+    }
+}
+
+/**
+ * @brief Read the next scenario.
+ * @param scenario the scenario to fill
+ * @return false at the end of the stream
+ */
+bool MovingAiScenarioReader::Next(MovingAiScenario *scenario) {
+    std::string line;
+    while (std::getline(input, line)) {
+        StripCarriageReturn(&line);
+        if (line.find_first_not_of(" \t") == std::string::npos) continue;
+        std::istringstream fields(line);
+        int width, height, start_x, start_y, goal_x, goal_y;
+        fields >> scenario->bucket >> scenario->map_name >> width >> height
+               >> start_x >> start_y >> goal_x >> goal_y
+               >> scenario->optimal_length;
+        if (!fields)
+            throw std::runtime_error("MovingAiScenarioReader: bad line " +
+                                     line);
+        // x is the column and y the row
+        scenario->map_size = std::make_pair(height, width);
+        scenario->start = std::make_pair(start_y, start_x);
+        scenario->goal = std::make_pair(goal_y, goal_x);
+        return true;
+    }
+    return false;
+}
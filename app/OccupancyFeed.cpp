@@ -0,0 +1,366 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file OccupancyFeed.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class shares an occupancy grid through a POSIX shared-memory object
+ * and turns the tiles written since the last poll into cell changes.
+ * 
+ */
+
+#include "OccupancyFeed.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "shared words need lock-free 64-bit atomics");
+
+namespace {
+const char kMagic[8] = {'D', 'S', 'L', 'F', 'E', 'E', 'D', '\0'};
+const std::uint32_t kVersion = 1;
+}  // namespace
+
+// fixed-size header at the start of the shared object; the words follow
+// right after it
+struct OccupancyFeed::Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t header_size;
+    std::int32_t height;
+    std::int32_t width;
+    std::uint64_t total_size;
+    // number of publishes so far
+    std::atomic<std::uint64_t> sequence;
+    std::uint8_t reserved[24];
+};
+static_assert(sizeof(std::atomic<std::uint64_t>) == 8,
+              "unexpected atomic layout");
+
+namespace {
+std::size_t TotalSize(const int &height, const int &width) {
+    std::size_t row_words = (width + 63) / 64;
+    std::size_t tile_num = ((height + OccupancyFeed::kTileSize - 1) /
+                            OccupancyFeed::kTileSize) * row_words;
+    return 64 + static_cast<std::size_t>(height) * row_words * 8 +
+           (tile_num + 63) / 64 * 8;
+}
+}  // namespace
+
+/**
+ * @brief Create the shared object of a feed, all cells clear. The object is
+ *        removed when the returned feed goes away.
+ * @param name the name of the object, such as "/occupancy"
+ * @param height the size of the map
+ * @param width the size of the map
+ * @return the feed, for writing and reading
+ */
+OccupancyFeed OccupancyFeed::Create(const std::string &name,
+                                    const int &height, const int &width) {
+    static_assert(sizeof(Header) == 64, "unexpected header layout");
+    if (height <= 0 || width <= 0)
+        throw std::invalid_argument("OccupancyFeed: empty map");
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        throw std::runtime_error("OccupancyFeed: cannot create " + name);
+    auto total_size = TotalSize(height, width);
+    if (ftruncate(fd, static_cast<off_t>(total_size)) != 0) {
+        close(fd);
+        shm_unlink(name.c_str());
+        throw std::runtime_error("OccupancyFeed: cannot size " + name);
+    }
+    auto feed = MapObject(name, fd, total_size, true);
+    // the object starts zeroed: no cell is set and no tile is dirty
+    feed.header->version = kVersion;
+    feed.header->header_size = sizeof(Header);
+    feed.header->height = height;
+    feed.header->width = width;
+    feed.header->total_size = total_size;
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(feed.header->magic, kMagic, sizeof(kMagic));
+    feed.Layout(height, width);
+    return feed;
+}
+
+/**
+ * @brief Attach to the shared object of a feed created by another process.
+ * @param name the name of the object
+ * @return the feed
+ */
+OccupancyFeed OccupancyFeed::Attach(const std::string &name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+        throw std::runtime_error("OccupancyFeed: cannot open " + name);
+    struct stat object_stat;
+    if (fstat(fd, &object_stat) != 0 ||
+        static_cast<std::size_t>(object_stat.st_size) < sizeof(Header)) {
+        close(fd);
+        throw std::runtime_error("OccupancyFeed: truncated object " + name);
+    }
+    auto feed = MapObject(name, fd,
+                          static_cast<std::size_t>(object_stat.st_size),
+                          false);
+    auto const &header = *feed.header;
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+        throw std::runtime_error("OccupancyFeed: not a feed " + name);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header.version != kVersion)
+        throw std::runtime_error("OccupancyFeed: unsupported version " + name);
+    if (header.header_size != sizeof(Header) || header.height <= 0 ||
+        header.width <= 0 ||
+        header.total_size != TotalSize(header.height, header.width) ||
+        header.total_size > feed.mapped_size)
+        throw std::runtime_error("OccupancyFeed: corrupt header " + name);
+    feed.Layout(header.height, header.width);
+    // changes published before attaching are all pending
+    feed.last_sequence = ~std::uint64_t(0);
+    return feed;
+}
+
+/**
+ * @brief Move constructor.
+ * @param other the feed to take over
+ * @return none
+ */
+OccupancyFeed::OccupancyFeed(OccupancyFeed &&other) noexcept {
+    *this = std::move(other);
+}
+
+/**
+ * @brief Move assignment.
+ * @param other the feed to take over
+ * @return this feed
+ */
+OccupancyFeed &OccupancyFeed::operator=(OccupancyFeed &&other) noexcept {
+    if (this == &other) return *this;
+    Release();
+    name = std::move(other.name);
+    owner = other.owner;
+    base = other.base;
+    mapped_size = other.mapped_size;
+    header = other.header;
+    words = other.words;
+    dirty = other.dirty;
+    height = other.height;
+    width = other.width;
+    row_words = other.row_words;
+    tile_cols = other.tile_cols;
+    dirty_num = other.dirty_num;
+    last_sequence = other.last_sequence;
+    other.owner = false;
+    other.base = nullptr;
+    return *this;
+}
+
+OccupancyFeed::~OccupancyFeed() { Release(); }
+
+/**
+ * @brief Get the size of the map.
+ * @return the height and the width
+ */
+std::pair<int, int> OccupancyFeed::GetSize() const {
+    return std::make_pair(height, width);
+}
+
+/**
+ * @brief Get the number of publishes so far.
+ * @return the sequence counter
+ */
+std::uint64_t OccupancyFeed::Sequence() const {
+    return header->sequence.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Check whether a cell is set in the shared grid.
+ * @param position the position of the cell
+ * @return true if the cell is blocked
+ */
+bool OccupancyFeed::Test(const std::pair<int, int> &position) const {
+    if (position.first < 0 || position.first >= height ||
+        position.second < 0 || position.second >= width)
+        throw std::out_of_range("OccupancyFeed: position outside");
+    auto word = Word(position.first, position.second / 64)
+                    .load(std::memory_order_relaxed);
+    return (word >> (position.second & 63)) & 1u;
+}
+
+/**
+ * @brief Block or free a cell and mark its tile dirty. Readers only see it
+ *        once it is published.
+ * @param position the position of the cell
+ * @param blocked whether the cell is blocked
+ * @return none
+ */
+void OccupancyFeed::Set(const std::pair<int, int> &position,
+                        const bool &blocked) {
+    if (position.first < 0 || position.first >= height ||
+        position.second < 0 || position.second >= width)
+        throw std::out_of_range("OccupancyFeed: position outside");
+    auto &word = Word(position.first, position.second / 64);
+    auto bit = std::uint64_t(1) << (position.second & 63);
+    if (blocked)
+        word.fetch_or(bit, std::memory_order_relaxed);
+    else
+        word.fetch_and(~bit, std::memory_order_relaxed);
+    // the cell is written before its tile is marked, so a reader that takes
+    // the mark also sees the cell
+    std::size_t tile = position.first / kTileSize * tile_cols +
+                       position.second / 64;
+    dirty[tile >> 6].fetch_or(std::uint64_t(1) << (tile & 63),
+                              std::memory_order_release);
+}
+
+/**
+ * @brief Publish the cells set so far to readers.
+ * @return none
+ */
+void OccupancyFeed::Publish() {
+    header->sequence.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * @brief Compare the tiles written since the last poll with the obstacles a
+ *        map knows. Nothing is read when nothing was published; otherwise
+ *        only the dirty tiles are, a word per row of a tile.
+ * @param known the obstacles of the map, of the size of the feed
+ * @param changes_ptr the pointer of the changes, replaced by the cells
+ *        whose occupancy differs from the map
+ * @return true if anything was published since the last poll
+ */
+bool OccupancyFeed::Poll(const OccupancyGrid &known,
+                         std::vector<CellChange> *changes_ptr) {
+    if (known.GetSize() != GetSize())
+        throw std::invalid_argument("OccupancyFeed: map of another size");
+    changes_ptr->clear();
+    auto sequence = header->sequence.load(std::memory_order_acquire);
+    if (sequence == last_sequence) return false;
+    last_sequence = sequence;
+    const std::uint64_t kAll = ~std::uint64_t(0);
+    for (std::size_t d = 0; d < dirty_num; ++d) {
+        if (dirty[d].load(std::memory_order_relaxed) == 0) continue;
+        auto tiles = dirty[d].exchange(0, std::memory_order_acq_rel);
+        while (tiles) {
+            auto tile = static_cast<int>(d * 64 + __builtin_ctzll(tiles));
+            tiles &= tiles - 1;
+            auto first_row = tile / tile_cols * kTileSize;
+            auto last_row = std::min(first_row + kTileSize, height);
+            auto word_col = tile % tile_cols;
+            auto first_col = word_col * 64;
+            auto mask = width - first_col >= 64
+                            ? kAll
+                            : kAll >> (64 - (width - first_col));
+            for (int i = first_row; i < last_row; ++i) {
+                auto word = Word(i, word_col).load(std::memory_order_relaxed);
+                auto diff = (word ^ known.Bits(known.CellIndex(
+                                        std::make_pair(i, first_col)))) &
+                            mask;
+                while (diff) {
+                    auto k = __builtin_ctzll(diff);
+                    diff &= diff - 1;
+                    changes_ptr->push_back(
+                        CellChange{std::make_pair(i, first_col + k),
+                                   static_cast<bool>((word >> k) & 1u)});
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Map a shared object.
+ * @param name the name of the object
+ * @param fd the descriptor of the object, closed here
+ * @param size the size of the object
+ * @param owner whether the feed removes the object when it goes away
+ * @return the feed, its cells not laid out yet
+ */
+OccupancyFeed OccupancyFeed::MapObject(const std::string &name,
+                                       const int &fd, const std::size_t &size,
+                                       const bool &owner) {
+    void *mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                        fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        if (owner) shm_unlink(name.c_str());
+        throw std::runtime_error("OccupancyFeed: cannot map " + name);
+    }
+    OccupancyFeed feed;
+    feed.name = name;
+    feed.owner = owner;
+    feed.base = mapped;
+    feed.mapped_size = size;
+    feed.header = static_cast<Header *>(mapped);
+    return feed;
+}
+
+/**
+ * @brief Find the words and the dirty bits of a map of the given size.
+ * @param new_height the size of the map
+ * @param new_width the size of the map
+ * @return none
+ */
+void OccupancyFeed::Layout(const int &new_height, const int &new_width) {
+    height = new_height;
+    width = new_width;
+    row_words = (width + 63) / 64;
+    tile_cols = row_words;
+    auto tile_num = static_cast<std::size_t>(
+        (height + kTileSize - 1) / kTileSize) * tile_cols;
+    dirty_num = (tile_num + 63) / 64;
+    words = reinterpret_cast<std::atomic<std::uint64_t> *>(
+        static_cast<char *>(base) + sizeof(Header));
+    dirty = words + static_cast<std::size_t>(height) * row_words;
+}
+
+/**
+ * @brief Unmap the object, and remove it if this feed created it.
+ * @return none
+ */
+void OccupancyFeed::Release() {
+    if (base != nullptr) munmap(base, mapped_size);
+    if (owner) shm_unlink(name.c_str());
+    base = nullptr;
+    owner = false;
+}
+
+/**
+ * @brief Get a word of the shared grid.
+ * @param row the row of the word
+ * @param word_col the column of the word, 64 cells each
+ * @return the word
+ */
+std::atomic<std::uint64_t> &OccupancyFeed::Word(const int &row,
+                                                const int &word_col) const {
+    return words[static_cast<std::size_t>(row) * row_words + word_col];
+}
@@ -0,0 +1,390 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file OccupancyGrid.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class holds one bit per cell of a map, stored in 64-bit words that
+ * are either owned or mapped from a binary file.
+ * 
+ */
+
+#include "OccupancyGrid.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+const char kMagic[8] = {'D', 'S', 'L', 'G', 'R', 'I', 'D', '\0'};
+const std::uint32_t kVersion = 1;
+
+// fixed-size header of the binary file; the words follow right after it,
+// so they are aligned to a cache line in the mapping
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t header_size;
+    std::int32_t height;
+    std::int32_t width;
+    std::uint64_t word_num;
+    // 0 in files written before the border could be wider, read as 1
+    std::int32_t padding;
+    std::uint8_t reserved[28];
+};
+static_assert(sizeof(FileHeader) == 64, "unexpected header layout");
+
+std::size_t WordNumFor(const int &height, const int &width,
+                       const int &padding) {
+    auto bit_num = static_cast<std::size_t>(height + 2 * padding) *
+                   (width + 2 * padding);
+    return (bit_num + 63) / 64;
+}
+}  // namespace
+
+/**
+ * @brief Constructor, all cells of the map are clear.
+ * @param height the size of the map
+ * @param width the size of the map
+ * @param border whether the border around the map is set
+ * @param padding the width of the border on each side
+ * @return none
+ */
+OccupancyGrid::OccupancyGrid(const int &height, const int &width,
+                             const bool &border, const int &padding)
+    : height(height), width(width), padding(padding),
+      row_stride(width + 2 * padding) {
+    if (height <= 0 || width <= 0)
+        throw std::invalid_argument("OccupancyGrid: empty map");
+    if (padding < 1)
+        throw std::invalid_argument("OccupancyGrid: no border");
+    word_num = WordNumFor(height, width, padding);
+    owned_words.assign(word_num, 0);
+    words = owned_words.data();
+    if (border) SetBorder();
+}
+
+/**
+ * @brief Copy constructor, the copy always owns its words.
+ * @param other the grid to copy
+ * @return none
+ */
+OccupancyGrid::OccupancyGrid(const OccupancyGrid &other)
+    : height(other.height), width(other.width), padding(other.padding),
+      row_stride(other.row_stride), word_num(other.word_num),
+      owned_words(other.words, other.words + other.word_num) {
+    words = owned_words.data();
+}
+
+/**
+ * @brief Move constructor.
+ * @param other the grid to move from
+ * @return none
+ */
+OccupancyGrid::OccupancyGrid(OccupancyGrid &&other) noexcept {
+    *this = std::move(other);
+}
+
+/**
+ * @brief Copy assignment, the copy always owns its words.
+ * @param other the grid to copy
+ * @return this grid
+ */
+OccupancyGrid &OccupancyGrid::operator=(const OccupancyGrid &other) {
+    if (this != &other) {
+        OccupancyGrid copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+/**
+ * @brief Move assignment.
+ * @param other the grid to move from
+ * @return this grid
+ */
+OccupancyGrid &OccupancyGrid::operator=(OccupancyGrid &&other) noexcept {
+    if (this != &other) {
+        Release();
+        height = other.height;
+        width = other.width;
+        padding = other.padding;
+        row_stride = other.row_stride;
+        word_num = other.word_num;
+        words = other.words;
+        // moving the vector keeps its buffer, so words stays valid
+        owned_words = std::move(other.owned_words);
+        mapped_base = other.mapped_base;
+        mapped_size = other.mapped_size;
+        other.words = nullptr;
+        other.word_num = 0;
+        other.mapped_base = nullptr;
+        other.mapped_size = 0;
+    }
+    return *this;
+}
+
+/**
+ * @brief Destructor, unmaps the file if any.
+ * @return none
+ */
+OccupancyGrid::~OccupancyGrid() { Release(); }
+
+/**
+ * @brief Map a grid saved by Save into memory without copying it.
+ * The mapping is private: changes made through Set or Clear stay in this
+ * process, the file is never written. A grid written by Write into a larger
+ * file, such as a planner snapshot, is opened at its offset there.
+ * The border in the file is not trusted, since the map reads neighbors
+ * without bounds checks: it is set or cleared again, writing only the bits
+ * that differ so that the pages of a sound file stay shared.
+ * @param path the file to open
+ * @param offset where the grid starts, a multiple of the memory page size
+ * @param border whether the cells around the map must be set
+ * @return the mapped grid
+ */
+OccupancyGrid OccupancyGrid::Open(const std::string &path,
+                                  const std::size_t &offset,
+                                  const bool &border) {
+    if (offset % static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) != 0)
+        throw std::runtime_error("OccupancyGrid: unaligned offset in " + path);
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("OccupancyGrid: cannot open " + path);
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 ||
+        static_cast<std::size_t>(file_stat.st_size) <
+            offset + sizeof(FileHeader)) {
+        close(fd);
+        throw std::runtime_error("OccupancyGrid: truncated file " + path);
+    }
+    auto file_size = static_cast<std::size_t>(file_stat.st_size) - offset;
+    void *base = mmap(nullptr, file_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE, fd, static_cast<off_t>(offset));
+    close(fd);
+    if (base == MAP_FAILED)
+        throw std::runtime_error("OccupancyGrid: cannot map " + path);
+
+    FileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    auto padding = header.padding == 0 ? 1 : header.padding;
+    const char *error = nullptr;
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+        error = "not an occupancy grid";
+    else if (header.version != kVersion)
+        error = "unsupported version";
+    else if (header.header_size != sizeof(FileHeader) || header.height <= 0 ||
+             header.width <= 0 || padding < 1 ||
+             header.word_num !=
+                 WordNumFor(header.height, header.width, padding))
+        error = "corrupt header";
+    else if (file_size < sizeof(FileHeader) + header.word_num * 8)
+        error = "truncated file";
+    if (error) {
+        munmap(base, file_size);
+        throw std::runtime_error(std::string("OccupancyGrid: ") + error +
+                                 " " + path);
+    }
+
+    OccupancyGrid grid;
+    grid.height = header.height;
+    grid.width = header.width;
+    grid.padding = padding;
+    grid.row_stride = header.width + 2 * padding;
+    grid.word_num = header.word_num;
+    grid.words = reinterpret_cast<std::uint64_t *>(
+        static_cast<char *>(base) + sizeof(FileHeader));
+    grid.mapped_base = base;
+    grid.mapped_size = file_size;
+    grid.MarkBorder(border);
+    return grid;
+}
+
+/**
+ * @brief Write the grid to a binary file that Open can map.
+ * @param path the file to write
+ * @return none
+ */
+void OccupancyGrid::Save(const std::string &path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    Write(&file);
+    if (!file) throw std::runtime_error("OccupancyGrid: cannot write " + path);
+}
+
+/**
+ * @brief Write the grid in the format of Save to a stream.
+ * @param stream the stream to write to
+ * @return none
+ */
+void OccupancyGrid::Write(std::ostream *stream) const {
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.header_size = sizeof(FileHeader);
+    header.height = height;
+    header.width = width;
+    header.word_num = word_num;
+    header.padding = padding;
+    stream->write(reinterpret_cast<const char *>(&header), sizeof(header));
+    stream->write(reinterpret_cast<const char *>(words), word_num * 8);
+}
+
+/**
+ * @brief Get the size of the map.
+ * @return the height and the width
+ */
+std::pair<int, int> OccupancyGrid::GetSize() const {
+    return std::make_pair(height, width);
+}
+
+/**
+ * @brief Get the width of the border around the map.
+ * @return the number of border cells on each side
+ */
+int OccupancyGrid::Padding() const { return padding; }
+
+/**
+ * @brief Check whether the words come from a mapped file.
+ * @return true if the grid is mapped
+ */
+bool OccupancyGrid::IsMapped() const { return mapped_base != nullptr; }
+
+/**
+ * @brief Count the set cells inside the map, the border excluded.
+ * @return the number of set cells
+ */
+std::size_t OccupancyGrid::CountSet() const {
+    std::size_t count = 0;
+    for (int i = 0; i < height; ++i)
+        for (int j = 0; j < width; ++j)
+            count += Test(CellIndex(std::make_pair(i, j)));
+    return count;
+}
+
+/**
+ * @brief Get the words, bit i of the grid is bit i % 64 of word i / 64.
+ * @return the first word
+ */
+const std::uint64_t *OccupancyGrid::Words() const { return words; }
+
+/**
+ * @brief Get the number of words.
+ * @return the number of words
+ */
+std::size_t OccupancyGrid::WordNum() const { return word_num; }
+
+/**
+ * @brief Find the set cells of a square window, clipped to the map. Each row
+ * of the window is read word by word: bits outside the row are masked off
+ * and the remaining set bits are visited lowest first.
+ * @param center the position at the center of the window
+ * @param radius the number of cells between the center and an edge
+ * @param indices_ptr the pointer of the indices to append to, in row-major
+ *        order
+ * @return none
+ */
+void OccupancyGrid::FindSetInWindow(const std::pair<int, int> &center,
+                                    const int &radius,
+                                    std::vector<int> *indices_ptr) const {
+    int first_row = std::max(center.first - radius, 0);
+    int last_row = std::min(center.first + radius, height - 1);
+    int first_col = std::max(center.second - radius, 0);
+    int last_col = std::min(center.second + radius, width - 1);
+    if (first_row > last_row || first_col > last_col) return;
+    const std::uint64_t kAll = ~std::uint64_t(0);
+    for (int i = first_row; i <= last_row; ++i) {
+        std::size_t begin = CellIndex(std::make_pair(i, first_col));
+        std::size_t last = CellIndex(std::make_pair(i, last_col));
+        std::size_t word_index = begin >> 6;
+        std::size_t last_word_index = last >> 6;
+        std::uint64_t word = words[word_index] & (kAll << (begin & 63));
+        while (true) {
+            if (word_index == last_word_index)
+                word &= kAll >> (63 - (last & 63));
+            while (word) {
+                indices_ptr->push_back(static_cast<int>(
+                    word_index * 64 + __builtin_ctzll(word)));
+                word &= word - 1;
+            }
+            if (word_index == last_word_index) break;
+            word = words[++word_index];
+        }
+    }
+}
+
+/**
+ * @brief Set every cell of the border around the map.
+ * @return none
+ */
+void OccupancyGrid::SetBorder() { MarkBorder(true); }
+
+/**
+ * @brief Set or clear every cell of the border around the map, writing
+ *        only the cells that differ.
+ * @param blocked true to set the cells, false to clear them
+ * @return none
+ */
+void OccupancyGrid::MarkBorder(const bool &blocked) {
+    auto mark = [this, &blocked](const int &index) {
+        if (Test(index) == blocked) return;
+        if (blocked)
+            Set(index);
+        else
+            Clear(index);
+    };
+    int padded_height = height + 2 * padding;
+    for (int i = 0; i < padded_height; ++i) {
+        if (i < padding || i >= height + padding) {
+            for (int j = 0; j < row_stride; ++j) mark(i * row_stride + j);
+            continue;
+        }
+        // only the sides of a row of the map
+        for (int j = 0; j < padding; ++j) {
+            mark(i * row_stride + j);
+            mark(i * row_stride + width + padding + j);
+        }
+    }
+}
+
+/**
+ * @brief Unmap the file or drop the owned words.
+ * @return none
+ */
+void OccupancyGrid::Release() {
+    if (mapped_base) munmap(mapped_base, mapped_size);
+    mapped_base = nullptr;
+    mapped_size = 0;
+    owned_words.clear();
+    owned_words.shrink_to_fit();
+    words = nullptr;
+    word_num = 0;
+}
@@ -30,25 +30,54 @@
  * @brief D* Lite Path Planning
  *
  * This class saves candidate nodes to search in minimum heap data structure.
+ * The heap is indexed: the slot of every node is tracked, so finding,
+ * re-keying and removing a node never scan the whole list.
  * 
  */
 
 #include "OpenList.h"
-#include <algorithm>
-#include <functional>
 
 /**
- * @brief Inset a node in the open list.
+ * @brief Constructor for a map of known size. Slots of nodes are then kept in
+ *        a paged table instead of a hash table.
+ * @param height the size of the map
+ * @param width the size of the map
+ * @return none
+ */
+OpenList::OpenList(const int &height, const int &width) {
+    grid_width = width;
+    dense_slot.Assign(static_cast<std::size_t>(height) * width, -1);
+}
+
+/**
+ * @brief Inset a node in the open list. A node that is already in the list
+ *        only gets its key updated.
  * @param new_key thepriority of the node to be added
  * @param new_node a candidate node's priority in searching and its position
  * @return none
  */
-void OpenList::Insert(const double &new_key,
+void OpenList::Insert(const Key &new_key,
                       const std::pair<int, int> &new_node) {
+    if (SlotOf(new_node) >= 0) {
+        UpdateKey(new_key, new_node);
+        return;
+    }
     priority_queue.push_back(std::make_tuple(
                              new_key, new_node.first, new_node.second));
-    std::push_heap(priority_queue.begin(),
-                   priority_queue.end(), std::greater<>());
+    auto slot = static_cast<int>(priority_queue.size()) - 1;
+    SetSlot(new_node, slot);
+    SiftUp(slot);
+}
+
+/**
+ * @brief Inset a node with a one-component key, used as both components.
+ * @param new_key thepriority of the node to be added
+ * @param new_node a candidate node's priority in searching and its position
+ * @return none
+ */
+void OpenList::Insert(const double &new_key,
+                      const std::pair<int, int> &new_node) {
+    Insert(std::make_pair(new_key, new_key), new_node);
 }
 
 /**
@@ -57,17 +86,27 @@ void OpenList::Insert(const double &new_key,
  * @param position a candidate node's new priority in searching and its position
  * @return none
  */
+void OpenList::UpdateKey(const Key &new_key,
+                         const std::pair<int, int> &position) {
+    auto slot = SlotOf(position);
+    if (slot < 0) return;
+    auto old_key = std::get<0>(priority_queue[slot]);
+    std::get<0>(priority_queue[slot]) = new_key;
+    if (new_key < old_key)
+        SiftUp(slot);
+    else
+        SiftDown(slot);
+}
+
+/**
+ * @brief Update the key of node with a one-component key.
+ * @param new_key thepriority of the node to be changed
+ * @param position a candidate node's new priority in searching and its position
+ * @return none
+ */
 void OpenList::UpdateKey(const double &new_key,
                          const std::pair<int, int> &position) {
-    for (auto &node : priority_queue) {
-        if (std::get<1>(node) == position.first &&
-            std::get<2>(node) == position.second) {
-            std::get<0>(node) = new_key;
-            break;
-        }
-    }
-    std::make_heap(priority_queue.begin(),
-                   priority_queue.end(), std::greater<>());
+    UpdateKey(std::make_pair(new_key, new_key), position);
 }
 
 /**
@@ -76,18 +115,26 @@ void OpenList::UpdateKey(const double &new_key,
  * @return none
  */
 void OpenList::Remove(const std::pair<int, int> &node) {
-    double min_key = -1.0;
-    UpdateKey(min_key, node);
-    std::pop_heap(priority_queue.begin(),
-                  priority_queue.end(), std::greater<>());
+    auto slot = SlotOf(node);
+    if (slot < 0) return;
+    ClearSlot(node);
+    auto last = priority_queue.back();
     priority_queue.pop_back();
+    if (slot == static_cast<int>(priority_queue.size())) return;
+    // Fill the hole with the last node and restore the heap around it.
+    auto removed = priority_queue[slot];
+    Place(last, slot);
+    if (last < removed)
+        SiftUp(slot);
+    else
+        SiftDown(slot);
 }
 
 /**
  * @brief Get the node on the top of the open list (a minimum heap).
  * @return the top node's priority in searching and its position
  */
-std::pair<double, std::pair<int, int>> OpenList::Top() const {
+std::pair<Key, std::pair<int, int>> OpenList::Top() const {
     auto key = std::get<0>(priority_queue.front());
     auto position = std::make_pair(std::get<1>(priority_queue.front()),
                                    std::get<2>(priority_queue.front()));
@@ -98,15 +145,10 @@ std::pair<double, std::pair<int, int>> OpenList::Top() const {
  * @brief Get the node on the top of the open list and romovee it.
  * @return the top node's priority in searching and its position
  */
-std::pair<double, std::pair<int, int>> OpenList::Pop() {
-    std::pop_heap(priority_queue.begin(),
-                  priority_queue.end(), std::greater<>());
-    auto top_node = priority_queue.back();
-    priority_queue.pop_back();
-    auto key = std::get<0>(top_node);
-    auto position = std::make_pair(std::get<1>(top_node),
-                                   std::get<2>(top_node));
-    return std::make_pair(key, position);
+std::pair<Key, std::pair<int, int>> OpenList::Pop() {
+    auto top_node = Top();
+    Remove(top_node.second);
+    return top_node;
 }
 
 /**
@@ -114,10 +156,124 @@ std::pair<double, std::pair<int, int>> OpenList::Pop() {
  * @return true if the node exsit and false if not
  */
 bool OpenList::Find(const std::pair<int, int> &node_to_find) const {
-    for (auto const &node : priority_queue) {
-        if (std::get<1>(node) == node_to_find.first &&
-            std::get<2>(node) == node_to_find.second)
-            return true;
+    return SlotOf(node_to_find) >= 0;
+}
+
+/**
+ * @brief Check if there is no node in the open list.
+ * @return true if the open list is empty
+ */
+bool OpenList::Empty() const { return priority_queue.empty(); }
+
+/**
+ * @brief Get the number of nodes in the open list.
+ * @return the number of nodes
+ */
+std::size_t OpenList::Size() const { return priority_queue.size(); }
+
+/**
+ * @brief Get every node of the open list, in an order that inserting them
+ *        again rebuilds the list cheaply.
+ * @return the keys and the positions of the nodes
+ */
+std::vector<std::pair<Key, std::pair<int, int>>> OpenList::Nodes() const {
+    std::vector<std::pair<Key, std::pair<int, int>>> nodes;
+    nodes.reserve(priority_queue.size());
+    for (auto const &node : priority_queue)
+        nodes.emplace_back(std::get<0>(node),
+                           std::make_pair(std::get<1>(node),
+                                          std::get<2>(node)));
+    return nodes;
+}
+
+/**
+ * @brief Get the slot of a node in the heap.
+ * @param position the position of the node
+ * @return the slot, or -1 if the node is not in the open list
+ */
+int OpenList::SlotOf(const std::pair<int, int> &position) const {
+    if (grid_width > 0)
+        return dense_slot[static_cast<std::size_t>(position.first) *
+                          grid_width + position.second];
+    auto found = sparse_slot.find(
+        (static_cast<long long>(position.first) << 32) ^
+        static_cast<unsigned int>(position.second));
+    return found == sparse_slot.end() ? -1 : found->second;
+}
+
+/**
+ * @brief Record the slot of a node in the heap.
+ * @param position the position of the node
+ * @param slot the slot of the node
+ * @return none
+ */
+void OpenList::SetSlot(const std::pair<int, int> &position, const int &slot) {
+    if (grid_width > 0)
+        dense_slot.Set(static_cast<std::size_t>(position.first) *
+                       grid_width + position.second, slot);
+    else
+        sparse_slot[(static_cast<long long>(position.first) << 32) ^
+                    static_cast<unsigned int>(position.second)] = slot;
+}
+
+/**
+ * @brief Forget the slot of a node that leaves the heap.
+ * @param position the position of the node
+ * @return none
+ */
+void OpenList::ClearSlot(const std::pair<int, int> &position) {
+    if (grid_width > 0)
+        dense_slot.Set(static_cast<std::size_t>(position.first) *
+                       grid_width + position.second, -1);
+    else
+        sparse_slot.erase((static_cast<long long>(position.first) << 32) ^
+                          static_cast<unsigned int>(position.second));
+}
+
+/**
+ * @brief Put a node in a slot and record its new slot.
+ * @param node the key and the position of the node
+ * @param slot the slot in the heap
+ * @return none
+ */
+void OpenList::Place(const std::tuple<Key, int, int> &node,
+                     const int &slot) {
+    priority_queue[slot] = node;
+    SetSlot(std::make_pair(std::get<1>(node), std::get<2>(node)), slot);
+}
+
+/**
+ * @brief Move a node toward the top until its parent is not larger.
+ * @param slot the slot of the node
+ * @return none
+ */
+void OpenList::SiftUp(int slot) {
+    auto node = priority_queue[slot];
+    while (slot > 0) {
+        auto parent = (slot - 1) / 2;
+        if (!(node < priority_queue[parent])) break;
+        Place(priority_queue[parent], slot);
+        slot = parent;
+    }
+    Place(node, slot);
+}
+
+/**
+ * @brief Move a node toward the bottom until its children are not smaller.
+ * @param slot the slot of the node
+ * @return none
+ */
+void OpenList::SiftDown(int slot) {
+    auto node = priority_queue[slot];
+    auto size = static_cast<int>(priority_queue.size());
+    while (2 * slot + 1 < size) {
+        auto child = 2 * slot + 1;
+        if (child + 1 < size &&
+            priority_queue[child + 1] < priority_queue[child])
+            ++child;
+        if (!(priority_queue[child] < node)) break;
+        Place(priority_queue[child], slot);
+        slot = child;
     }
-    return false;
+    Place(node, slot);
 }
@@ -0,0 +1,104 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file PlannerPool.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class answers many start-goal queries on one shared map at the same
+ * time.
+ * 
+ */
+
+#include "PlannerPool.h"
+#include "DStarLitePlanner.h"
+#include "Map.h"
+
+/**
+ * @brief Constructor.
+ * @param base the obstacles shared by all queries
+ * @param thread_num the number of threads
+ * @return none
+ */
+PlannerPool::PlannerPool(std::shared_ptr<const OccupancyGrid> base,
+                         const int &thread_num)
+    : base(std::move(base)), thread_pool(thread_num) {}
+
+/**
+ * @brief Answer queries in parallel.
+ * @param queries the starts and goals
+ * @return the results in the order of the queries
+ */
+std::vector<PathResult> PlannerPool::Solve(
+                        const std::vector<PathQuery> &queries) {
+    std::vector<PathResult> results(queries.size());
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        thread_pool.Submit([this, &queries, &results, i] {
+            results[i] = SolveOne(base, queries[i]);
+        });
+    }
+    thread_pool.Wait();
+    return results;
+}
+
+/**
+ * @brief Answer one query with its own search values on the shared map.
+ * @param base the obstacles
+ * @param query the start and the goal
+ * @return the shortest path, empty if the goal is not reachable
+ */
+PathResult PlannerPool::SolveOne(
+           const std::shared_ptr<const OccupancyGrid> &base,
+           const PathQuery &query) {
+    Map map(base);
+    map.SetGoal(query.goal);
+    map.SetStart(query.start);
+    DStarLitePlanner planner(&map);
+    planner.Initialize();
+    planner.ComputeShortestPath();
+
+    PathResult result;
+    result.cost = map.CurrentCellG(query.start);
+    result.reached = result.cost < map.infinity_cost;
+    if (!result.reached) return result;
+    // follow the g-values down to the goal
+    auto position = query.start;
+    result.path.push_back(position);
+    while (position != query.goal) {
+        auto next_position = planner.ComputeNextPotision(position);
+        if (next_position == position) break;
+        position = next_position;
+        result.path.push_back(position);
+    }
+    return result;
+}
+
+/**
+ * @brief Get the number of threads.
+ * @return the number of threads
+ */
+int PlannerPool::ThreadNum() const { return thread_pool.ThreadNum(); }
@@ -0,0 +1,149 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file PlannerStats.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Counters and histograms that tell what the planner did in each replan.
+ * 
+ */
+
+#include "PlannerStats.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+const int Log2Histogram::kBucketNum;
+
+/**
+ * @brief Add a value to the histogram.
+ * @param value a non-negative value, such as a latency in microseconds
+ * @return none
+ */
+void Log2Histogram::Record(const double &value) {
+    int bucket = 0;
+    if (value >= 1.0)
+        bucket = std::min(kBucketNum - 1,
+                          static_cast<int>(std::floor(std::log2(value))) + 1);
+    ++buckets[bucket];
+    ++count;
+    total += value;
+    max = std::max(max, value);
+}
+
+/**
+ * @brief Get the number of values recorded.
+ * @return the number of values
+ */
+std::uint64_t Log2Histogram::Count() const { return count; }
+
+/**
+ * @brief Get the mean of the values recorded.
+ * @return the mean, or 0 without values
+ */
+double Log2Histogram::Mean() const { return count == 0 ? 0.0 : total / count; }
+
+/**
+ * @brief Get the largest value recorded.
+ * @return the largest value
+ */
+double Log2Histogram::Max() const { return max; }
+
+/**
+ * @brief Estimate a percentile by the upper bound of its bucket.
+ * @param fraction the percentile between 0 and 1
+ * @return the estimate, never more than the largest value
+ */
+double Log2Histogram::Percentile(const double &fraction) const {
+    if (count == 0) return 0.0;
+    auto rank = static_cast<std::uint64_t>(std::ceil(fraction * count));
+    std::uint64_t seen = 0;
+    for (int k = 0; k < kBucketNum; ++k) {
+        seen += buckets[k];
+        if (seen >= std::max<std::uint64_t>(rank, 1))
+            return std::min(max, std::ldexp(1.0, k));
+    }
+    return max;
+}
+
+/**
+ * @brief Get the number of values in every bucket.
+ * @return the buckets
+ */
+const std::array<std::uint64_t, Log2Histogram::kBucketNum> &
+Log2Histogram::Buckets() const {
+    return buckets;
+}
+
+/**
+ * @brief Dump the histogram as a JSON object. Trailing empty buckets are
+ *        left out.
+ * @return the JSON text
+ */
+std::string Log2Histogram::ToJson() const {
+    std::ostringstream json;
+    json << "{\"count\": " << count << ", \"mean\": " << Mean()
+         << ", \"p50\": " << Percentile(0.5) << ", \"p90\": "
+         << Percentile(0.9) << ", \"p99\": " << Percentile(0.99)
+         << ", \"max\": " << max << ", \"buckets\": [";
+    auto used = kBucketNum;
+    while (used > 0 && buckets[used - 1] == 0) --used;
+    for (int k = 0; k < used; ++k) json << (k > 0 ? ", " : "") << buckets[k];
+    json << "]}";
+    return json.str();
+}
+
+/**
+ * @brief Dump all counters and histograms as a JSON object.
+ * @return the JSON text
+ */
+std::string PlannerStats::ToJson() const {
+    std::ostringstream json;
+    json << "{\"replans\": " << replans
+         << ", \"expansions\": " << expansions
+         << ", \"overconsistent_expansions\": " << overconsistent_expansions
+         << ", \"underconsistent_expansions\": " << underconsistent_expansions
+         << ", \"stale_key_expansions\": " << stale_key_expansions
+         << ", \"update_vertex_calls\": " << update_vertex_calls
+         << ", \"neighbor_scans\": " << neighbor_scans
+         << ", \"openlist_inserts\": " << openlist_inserts
+         << ", \"openlist_removes\": " << openlist_removes
+         << ", \"openlist_updates\": " << openlist_updates
+         << ", \"max_openlist_size\": " << max_openlist_size
+         << ", \"change_batches\": " << change_batches
+         << ", \"changed_cells\": " << changed_cells
+         << ", \"duplicate_vertices\": " << duplicate_vertices
+         << ", \"last_replan_expansions\": " << last_replan_expansions
+         << ", \"last_replan_touched_cells\": " << last_replan_touched_cells
+         << ", \"replan_latency_us\": " << replan_latency_us.ToJson()
+         << ", \"change_batch_latency_us\": "
+         << change_batch_latency_us.ToJson()
+         << ", \"touched_cells_per_replan\": "
+         << touched_cells_per_replan.ToJson() << "}";
+    return json.str();
+}
@@ -0,0 +1,381 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+/**
+ * @file RollingWindowPlanner.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class plans in a window of fixed size that follows the robot over
+ * an unbounded world.
+ * 
+ */
+
+#include "RollingWindowPlanner.h"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @brief Constructor.
+ * @param height the height of the window
+ * @param width the width of the window
+ * @return none
+ */
+RollingWindowPlanner::RollingWindowPlanner(const int &height,
+                                           const int &width)
+    : height(height), width(width),
+      margin(std::max(1, std::min(height, width) / 4)),
+      origin(std::make_pair(0, 0)),
+      robot(std::make_pair(0, 0)),
+      goal(std::make_pair(0, 0)) {
+    if (height < 3 || width < 3)
+        throw std::invalid_argument("RollingWindowPlanner: window too small");
+    known.assign(static_cast<std::size_t>(height) * width, 0);
+}
+
+/**
+ * @brief Center the window on the start, forget every cell and plan from
+ *        scratch.
+ * @param start the world position of the robot
+ * @param new_goal the world position of the goal
+ * @return none
+ */
+void RollingWindowPlanner::Initialize(const std::pair<int, int> &start,
+                                      const std::pair<int, int> &new_goal) {
+    robot.Move(start);
+    goal = new_goal;
+    origin = std::make_pair(start.first - height / 2,
+                            start.second - width / 2);
+    std::fill(known.begin(), known.end(), 0);
+    carried.clear();
+    recenter_num = 0;
+    Rebuild();
+}
+
+/**
+ * @brief Compute the shortest path from the robot, rebuilding the search
+ *        first if the window moved.
+ * @return none
+ */
+void RollingWindowPlanner::ComputeShortestPath() {
+    if (stale) Rebuild();
+    planner->ComputeShortestPath();
+}
+
+/**
+ * @brief Move the robot. Near an edge of the window, the window recenters
+ *        on it and the search is rebuilt on the next query.
+ * @param new_start the world position of the robot
+ * @return none
+ */
+void RollingWindowPlanner::MoveStart(const std::pair<int, int> &new_start) {
+    robot.Move(new_start);
+    auto local = ToWindow(new_start);
+    if (local.first < margin || local.first >= height - margin ||
+        local.second < margin || local.second >= width - margin) {
+        Recenter();
+        return;
+    }
+    if (!stale) planner->MoveStart(local);
+}
+
+/**
+ * @brief Apply a batch of changed cells in world positions. Cells outside
+ *        the window are not kept: the window only remembers what it holds.
+ * @param changes cells that became blocked or free
+ * @return if any cell of the window really changed
+ */
+bool RollingWindowPlanner::ApplyChanges(
+        const std::vector<CellChange> &changes) {
+    std::vector<CellChange> local_changes;
+    for (auto const &change : changes) {
+        if (!InWindow(change.position)) continue;
+        auto &cell = known[Slot(change.position)];
+        if ((cell != 0) == change.blocked) continue;
+        cell = change.blocked ? 1 : 0;
+        local_changes.push_back(
+            CellChange{ToWindow(change.position), change.blocked});
+        // the search heads for the goal of the window, which must stay free
+        if (!stale && change.blocked &&
+            local_changes.back().position == window_map->GetGoal())
+            stale = true;
+    }
+    if (!stale) planner->ApplyChanges(local_changes);
+    return !local_changes.empty();
+}
+
+/**
+ * @brief Find the next position of the robot.
+ * @return the world position to move to, or the robot's position if it is
+ *         at the goal or no way out of the window is known
+ */
+std::pair<int, int> RollingWindowPlanner::NextMove() {
+    if (stale) ComputeShortestPath();
+    return ToWorld(planner->NextMove());
+}
+
+/**
+ * @brief Get the world position of the robot.
+ * @return the position of the robot
+ */
+std::pair<int, int> RollingWindowPlanner::CurrentStart() const {
+    return robot.CurrentPosition();
+}
+
+/**
+ * @brief Get the world position of the goal.
+ * @return the position of the goal
+ */
+std::pair<int, int> RollingWindowPlanner::GetGoal() const {
+    return goal;
+}
+
+/**
+ * @brief Get the world position of the top-left cell of the window.
+ * @return the origin of the window
+ */
+std::pair<int, int> RollingWindowPlanner::Origin() const {
+    return origin;
+}
+
+/**
+ * @brief Check if a world position is inside the window.
+ * @param position the world position
+ * @return true if inside and false if not
+ */
+bool RollingWindowPlanner::InWindow(
+        const std::pair<int, int> &position) const {
+    auto local = ToWindow(position);
+    return local.first >= 0 && local.first < height &&
+           local.second >= 0 && local.second < width;
+}
+
+/**
+ * @brief Check if a world position is a known obstacle. Cells outside the
+ *        window are unknown and so never are.
+ * @param position the world position
+ * @return true if a known obstacle
+ */
+bool RollingWindowPlanner::KnownObstacle(
+        const std::pair<int, int> &position) const {
+    return InWindow(position) && known[Slot(position)] != 0;
+}
+
+/**
+ * @brief Get how many times the window has recentered since Initialize.
+ * @return the number of recenters
+ */
+int RollingWindowPlanner::RecenterNum() const {
+    return recenter_num;
+}
+
+/**
+ * @brief Get the map of the window, in window positions, as of the last
+ *        rebuild.
+ * @return the map of the window
+ */
+const Map &RollingWindowPlanner::Window() const {
+    return *window_map;
+}
+
+/**
+ * @brief Get the slot of a world position in the ring buffer, which stays
+ *        the same as long as the position is inside the window.
+ * @param position the world position
+ * @return the slot in the ring buffer
+ */
+int RollingWindowPlanner::Slot(const std::pair<int, int> &position) const {
+    auto row = (position.first % height + height) % height;
+    auto col = (position.second % width + width) % width;
+    return row * width + col;
+}
+
+/**
+ * @brief Center the window on the robot. Only the slots of the cells that
+ *        come into the window are cleared; they are the slots of the cells
+ *        that left it.
+ * @return none
+ */
+void RollingWindowPlanner::Recenter() {
+    auto position = robot.CurrentPosition();
+    auto new_origin = std::make_pair(position.first - height / 2,
+                                     position.second - width / 2);
+    CarryFrontier(new_origin);
+    // columns of the new window that the old one did not have
+    auto entering_begin = new_origin.second;
+    auto entering_end = new_origin.second + width;
+    if (new_origin.second > origin.second)
+        entering_begin = std::max(entering_begin, origin.second + width);
+    else
+        entering_end = std::min(entering_end, origin.second);
+    for (int i = new_origin.first; i < new_origin.first + height; ++i) {
+        if (i < origin.first || i >= origin.first + height) {
+            // a new row takes a whole row of the ring buffer
+            auto row_begin = known.begin() + Slot(std::make_pair(i, 0));
+            std::fill(row_begin, row_begin + width, 0);
+            continue;
+        }
+        for (int j = entering_begin; j < entering_end; ++j)
+            known[Slot(std::make_pair(i, j))] = 0;
+    }
+    origin = new_origin;
+    ++recenter_num;
+    stale = true;
+}
+
+/**
+ * @brief Keep the costs to the goal that the current search gives the
+ *        cells on the edge of the next window. The search goes on until
+ *        those cells are settled, registered as robots of its fleet.
+ * @param new_origin the origin of the next window
+ * @return none
+ */
+void RollingWindowPlanner::CarryFrontier(
+        const std::pair<int, int> &new_origin) {
+    carried.clear();
+    if (stale) return;
+    auto old_origin = origin;
+    origin = new_origin;
+    std::vector<std::pair<int, int>> edge;
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            auto local = std::make_pair(i, j);
+            if (EdgeCell(local)) edge.push_back(ToWorld(local));
+        }
+    }
+    origin = old_origin;
+    for (auto const &cell : edge) {
+        if (InWindow(cell) && !KnownObstacle(cell))
+            planner->AddRobot(ToWindow(cell));
+    }
+    planner->ComputeShortestPath();
+    for (auto const &cell : edge) {
+        if (InWindow(cell) && !KnownObstacle(cell))
+            carried.push_back(FrontierCost{
+                cell, window_map->CurrentCellG(ToWindow(cell)) +
+                          goal_offset});
+    }
+    // sorted by position for the lookups of Rebuild
+    std::sort(carried.begin(), carried.end(),
+              [](const FrontierCost &a, const FrontierCost &b) {
+                  return a.position < b.position;
+              });
+}
+
+/**
+ * @brief Check if a position of the window is on its edge.
+ * @param position the position relative to the origin of the window
+ * @return true if on the edge
+ */
+bool RollingWindowPlanner::EdgeCell(const std::pair<int, int> &position) const {
+    return position.first == 0 || position.first == height - 1 ||
+           position.second == 0 || position.second == width - 1;
+}
+
+/**
+ * @brief Build the search of the window from the known obstacles. With the
+ *        goal outside, the free cells on the edge of the window become the
+ *        frontier: the one closest to the goal is the goal of the window
+ *        and the others cost their extra distance to the goal. Cells the
+ *        last window could not lead to the goal are left out.
+ * @return none
+ */
+void RollingWindowPlanner::Rebuild() {
+    planner.reset();
+    window_map.reset(new Map(height, width));
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            auto local = std::make_pair(i, j);
+            if (known[Slot(ToWorld(local))] != 0)
+                window_map->UpdateStatusCode(window_map->CellIndex(local),
+                                             Map::kObstacle);
+        }
+    }
+    auto start = ToWindow(robot.CurrentPosition());
+    auto window_goal = start;
+    std::vector<FrontierCost> frontier;
+    goal_offset = 0.0;
+    if (InWindow(goal)) {
+        window_goal = ToWindow(goal);
+    } else {
+        auto local_goal = ToWindow(goal);
+        for (int i = 0; i < height; ++i) {
+            for (int j = 0; j < width; ++j) {
+                auto cell = std::make_pair(i, j);
+                if (!EdgeCell(cell) ||
+                    window_map->Blocked(window_map->CellIndex(cell)))
+                    continue;
+                auto cost = window_map->ComputeHeuristic(cell, local_goal);
+                auto found = std::lower_bound(
+                    carried.begin(), carried.end(), ToWorld(cell),
+                    [](const FrontierCost &a, const std::pair<int, int> &b) {
+                        return a.position < b;
+                    });
+                if (found != carried.end() && found->position == ToWorld(cell))
+                    cost = std::max(cost, found->cost);
+                if (cost < window_map->infinity_cost)
+                    frontier.push_back(FrontierCost{cell, cost});
+            }
+        }
+        if (!frontier.empty()) {
+            auto closest = *std::min_element(
+                frontier.begin(), frontier.end(),
+                [](const FrontierCost &a, const FrontierCost &b) {
+                    return a.cost < b.cost;
+                });
+            window_goal = closest.position;
+            goal_offset = closest.cost;
+            for (auto &cell : frontier) cell.cost -= closest.cost;
+        }
+    }
+    window_map->SetGoal(window_goal);
+    window_map->SetStart(start);
+    planner.reset(new DStarLitePlanner(window_map.get()));
+    planner->SetFrontier(frontier);
+    planner->Initialize();
+    stale = false;
+}
+
+/**
+ * @brief Convert a world position to a position in the window.
+ * @param position the world position
+ * @return the position relative to the origin of the window
+ */
+std::pair<int, int> RollingWindowPlanner::ToWindow(
+        const std::pair<int, int> &position) const {
+    return std::make_pair(position.first - origin.first,
+                          position.second - origin.second);
+}
+
+/**
+ * @brief Convert a position in the window to a world position.
+ * @param position the position relative to the origin of the window
+ * @return the world position
+ */
+std::pair<int, int> RollingWindowPlanner::ToWorld(
+        const std::pair<int, int> &position) const {
+    return std::make_pair(position.first + origin.first,
+                          position.second + origin.second);
+}
@@ -0,0 +1,179 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file Snapshot.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This file writes snapshots section by section and maps them back for
+ * reading.
+ * 
+ */
+
+#include "Snapshot.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+const char kMagic[8] = {'D', 'S', 'L', 'S', 'N', 'A', 'P', '\0'};
+const std::uint32_t kVersion = 1;
+}  // namespace
+
+/**
+ * @brief Constructor, starts a snapshot after room for its header.
+ * @param path the file to write
+ * @return none
+ */
+SnapshotWriter::SnapshotWriter(const std::string &path)
+    : path(path), temporary_path(path + ".partial"),
+      file(temporary_path, std::ios::binary | std::ios::trunc) {
+    if (!file) throw std::runtime_error("Snapshot: cannot write " + path);
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.header_size = sizeof(SnapshotHeader);
+    Append(&header, sizeof(header), 1);
+}
+
+/**
+ * @brief Get the header, which is written last by Finish.
+ * @return the header
+ */
+SnapshotHeader &SnapshotWriter::Header() { return header; }
+
+/**
+ * @brief Append a section.
+ * @param data the bytes of the section
+ * @param size the number of bytes
+ * @param alignment the alignment of the section in the file
+ * @return the offset of the section
+ */
+std::uint64_t SnapshotWriter::Append(const void *data,
+                                     const std::size_t &size,
+                                     const std::size_t &alignment) {
+    Align(alignment);
+    auto section = offset;
+    file.write(static_cast<const char *>(data), size);
+    offset += size;
+    return section;
+}
+
+/**
+ * @brief Append an occupancy grid as a grid file, aligned so that
+ *        OccupancyGrid::Open maps it in place.
+ * @param grid the grid
+ * @return the offset of the section
+ */
+std::uint64_t SnapshotWriter::AppendGrid(const OccupancyGrid &grid) {
+    Align(static_cast<std::size_t>(sysconf(_SC_PAGESIZE)));
+    auto section = offset;
+    grid.Write(&file);
+    offset = static_cast<std::uint64_t>(file.tellp());
+    return section;
+}
+
+/**
+ * @brief Write the header and replace the file at the path with the
+ *        snapshot.
+ * @return none
+ */
+void SnapshotWriter::Finish() {
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.close();
+    if (!file || std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+        std::remove(temporary_path.c_str());
+        throw std::runtime_error("Snapshot: cannot write " + path);
+    }
+}
+
+/**
+ * @brief Pad the file with zeros up to a multiple of the alignment.
+ * @param alignment the alignment
+ * @return none
+ */
+void SnapshotWriter::Align(const std::size_t &alignment) {
+    static const char kZeros[64] = {};
+    auto padding = (alignment - offset % alignment) % alignment;
+    offset += padding;
+    for (; padding > 0; padding -= std::min<std::size_t>(padding, 64))
+        file.write(kZeros, std::min<std::size_t>(padding, 64));
+}
+
+/**
+ * @brief Constructor, maps a snapshot privately and checks its header.
+ * Changes made to borrowed pages stay in this process.
+ * @param path the file to read
+ * @return none
+ */
+SnapshotReader::SnapshotReader(const std::string &path) : path(path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Snapshot: cannot open " + path);
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 ||
+        static_cast<std::size_t>(file_stat.st_size) <
+            sizeof(SnapshotHeader)) {
+        close(fd);
+        throw std::runtime_error("Snapshot: truncated file " + path);
+    }
+    size = static_cast<std::size_t>(file_stat.st_size);
+    void *base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                      fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        throw std::runtime_error("Snapshot: cannot map " + path);
+    auto mapped_size = size;
+    memory.reset(base, [mapped_size](void *mapped) {
+        munmap(mapped, mapped_size);
+    });
+
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+        throw std::runtime_error("Snapshot: not a snapshot " + path);
+    if (header.version != kVersion)
+        throw std::runtime_error("Snapshot: unsupported version " + path);
+    if (header.header_size != sizeof(SnapshotHeader) || header.height <= 0 ||
+        header.width <= 0)
+        throw std::runtime_error("Snapshot: corrupt header " + path);
+}
+
+/**
+ * @brief Get the header.
+ * @return the header
+ */
+const SnapshotHeader &SnapshotReader::Header() const { return header; }
+
+/**
+ * @brief Get the path of the snapshot, for mapping its grids.
+ * @return the path
+ */
+const std::string &SnapshotReader::Path() const { return path; }
@@ -0,0 +1,180 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file ThreadPool.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class runs tasks on a fixed number of threads with one queue per
+ * thread and work stealing.
+ * 
+ */
+
+#include "ThreadPool.h"
+#include <stdexcept>
+
+/**
+ * @brief Constructor, starts the threads.
+ * @param thread_num the number of threads, at least one
+ * @return none
+ */
+ThreadPool::ThreadPool(const int &thread_num) {
+    if (thread_num < 1)
+        throw std::invalid_argument("ThreadPool: no thread");
+    for (int i = 0; i < thread_num; ++i)
+        queues.emplace_back(new TaskQueue);
+    for (int i = 0; i < thread_num; ++i)
+        threads.emplace_back(&ThreadPool::Run, this, i);
+}
+
+/**
+ * @brief Destructor, finishes the queued tasks and joins the threads.
+ * @return none
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        stopping = true;
+    }
+    task_ready.notify_all();
+    for (auto &thread : threads) thread.join();
+}
+
+/**
+ * @brief Queue a task; the queues are filled in turn.
+ * @param task the task to run
+ * @return none
+ */
+void ThreadPool::Submit(const std::function<void()> &task) {
+    auto queue_index = next_queue.fetch_add(1) % queues.size();
+    unfinished_num.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queues[queue_index]->mutex);
+        queues[queue_index]->tasks.push_back(task);
+    }
+    // Counted only once it is in a queue, so a claim always finds it. A
+    // thread going to sleep counts itself idle before it looks at the
+    // queued tasks, so either it sees this task or this sees it idle
+    queued_num.fetch_add(1);
+    if (idle_num.load() > 0) {
+        // taken so the notification cannot slip in before the thread waits
+        std::lock_guard<std::mutex> lock(state_mutex);
+        task_ready.notify_one();
+    }
+}
+
+/**
+ * @brief Wait until every submitted task has finished.
+ * @return none, rethrows the first exception of a task
+ */
+void ThreadPool::Wait() {
+    {
+        std::unique_lock<std::mutex> lock(state_mutex);
+        all_done.wait(lock, [this] { return unfinished_num.load() == 0; });
+    }
+    std::lock_guard<std::mutex> lock(error_mutex);
+    if (first_error) {
+        auto error = first_error;
+        first_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * @brief Get the number of threads.
+ * @return the number of threads
+ */
+int ThreadPool::ThreadNum() const { return static_cast<int>(threads.size()); }
+
+/**
+ * @brief The loop of a thread: claim a task, take it and run it.
+ * @param thread_id the index of the thread and of its own queue
+ * @return none
+ */
+void ThreadPool::Run(const int &thread_id) {
+    while (true) {
+        if (!ClaimTask()) {
+            std::unique_lock<std::mutex> lock(state_mutex);
+            idle_num.fetch_add(1);
+            task_ready.wait(lock, [this] {
+                return stopping || queued_num.load() > 0;
+            });
+            idle_num.fetch_sub(1);
+            // the queued tasks are finished before the pool stops
+            if (stopping && queued_num.load() == 0) return;
+            continue;
+        }
+        auto task = TakeTask(thread_id);
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!first_error) first_error = std::current_exception();
+        }
+        if (unfinished_num.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(state_mutex);
+            all_done.notify_all();
+        }
+    }
+}
+
+/**
+ * @brief Claim one of the queued tasks without taking any lock.
+ * @return true if a task was claimed, false if none is queued
+ */
+bool ThreadPool::ClaimTask() {
+    auto queued = queued_num.load();
+    while (queued > 0) {
+        if (queued_num.compare_exchange_weak(queued, queued - 1))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Take a claimed task: the newest of the own queue, or else the
+ *        oldest of another queue.
+ * @param thread_id the index of the thread and of its own queue
+ * @return the task
+ */
+std::function<void()> ThreadPool::TakeTask(const int &thread_id) {
+    auto queue_num = queues.size();
+    for (std::size_t offset = 0;; offset = (offset + 1) % queue_num) {
+        auto &queue = *queues[(thread_id + offset) % queue_num];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        std::function<void()> task;
+        if (offset == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        return task;
+    }
+}
@@ -0,0 +1,737 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file main.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This program measures the planner on procedural maps. For every layout
+ * and size it plans from the top-left corner to the bottom-right corner,
+ * moves the robot along the path, discovers hidden obstacles on the way and
+ * replans. Results go to the standard output as CSV or JSON. Expanded cells
+ * and heap operations need the library built with DSTARLITE_STATS. With
+ * --planner=hierarchical the walk uses HierarchicalPlanner, whose expanded
+ * nodes are entrances of clusters rather than cells; with --planner=bucket
+ * it is the flat planner on a BucketOpenList instead of the binary heap.
+ * --cost=float|fixed stores the g-values and rhs-values of the flat planner
+ * as floats or FixedCost instead of doubles, and --connectivity=4|16 moves
+ * it to four or sixteen neighbors instead of eight.
+ *
+ * With --map-file the map is read from a Moving AI .map file or mapped from
+ * a binary occupancy grid instead; --scen then runs every query of a Moving
+ * AI .scen file on it, otherwise the corners are used as above.
+ *
+ * With --queries it instead measures throughput: that many random queries
+ * on each generated map, answered by a PlannerPool of every thread count.
+ *
+ * With --trace it replays an event trace (see EventTrace.h) through the
+ * flat or bucket planner as fast as it goes, and prints the latency of the
+ * changes and the replan of every event.
+ *
+ * Usage: planner-bench [--maps=random,maze,rooms,warehouse]
+ *                      [--sizes=64,256,1024] [--hidden=0.05] [--seed=808]
+ *                      [--max-steps=0] [--sensor-radius=1]
+ *                      [--planner=flat|bucket|hierarchical]
+ *                      [--cluster-size=32] [--cost=double|float|fixed]
+ *                      [--connectivity=4|8|16]
+ *                      [--format=csv|json]
+ *                      [--map-file=arena.map [--scen=arena.map.scen]]
+ *                      [--queries=0 [--threads=1,2,4,8]]
+ *                      [--trace=incident.trace]
+ * 
+ */
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "DStarLitePlanner.h"
+#include "EventTrace.h"
+#include "HierarchicalPlanner.h"
+#include "Map.h"
+#include "MapGenerator.h"
+#include "MovingAiImporter.h"
+#include "OccupancyGrid.h"
+#include "PlannerPool.h"
+
+struct BenchOptions {
+    std::vector<std::string> maps = {"random", "maze", "rooms", "warehouse"};
+    std::vector<int> sizes = {64, 256, 1024};
+    double hidden_density = 0.05;
+    unsigned int seed = 808;
+    // 0 lets the robot walk until it reaches the goal or gets stuck
+    long max_steps = 0;
+    // cells sensed around the robot in each direction
+    int sensor_radius = 1;
+    std::string planner = "flat";
+    int cluster_size = 32;
+    // type of the g-values and rhs-values of the flat planner
+    std::string cost = "double";
+    // neighbors of a cell for the flat planner
+    int connectivity = 8;
+    std::string format = "csv";
+    std::string map_file;
+    std::string scenario_file;
+    // 0 runs the walks above instead of the throughput of queries
+    int queries = 0;
+    std::vector<int> threads = {1, 2, 4, 8};
+    // replays this trace instead when set
+    std::string trace_file;
+};
+
+struct BenchResult {
+    std::string map_kind;
+    int size;
+    double initial_plan_ms;
+    std::size_t replans;
+    double replan_p50_us;
+    double replan_p90_us;
+    double replan_p99_us;
+    double replan_max_us;
+    std::size_t cells_expanded;
+    std::size_t heap_operations;
+    long steps;
+    bool reached;
+    long peak_rss_kb;
+    std::string planner_stats_json;
+};
+
+struct ThroughputResult {
+    std::string map_kind;
+    int size;
+    int threads;
+    std::size_t queries;
+    std::size_t reached;
+    double seconds;
+    double queries_per_second;
+};
+
+bool ParseOptions(int, char **, BenchOptions *);
+std::vector<ThroughputResult> RunThroughput(const std::string &, const int &,
+                                            const BenchOptions &);
+void PrintThroughput(const std::vector<ThroughputResult> &,
+                     const std::string &);
+BenchResult RunScenario(const std::string &, const int &,
+                        const BenchOptions &);
+bool RunMapFile(const BenchOptions &, std::vector<BenchResult> *);
+bool RunTrace(const BenchOptions &);
+void PrintReplay(const std::vector<ReplayRecord> &, const std::string &);
+BenchResult RunOnMap(Map *, const std::pair<int, int> &,
+                     const std::pair<int, int> &, const BenchOptions &);
+template <typename CostType>
+BenchResult RunWithCostType(const Map &, const BenchOptions &);
+template <typename MapType>
+BenchResult RunWithMapType(const Map &, const BenchOptions &);
+template <typename MapType>
+BenchResult RunFlat(MapType *, const BenchOptions &);
+template <class Planner, class MapType>
+BenchResult Walk(Planner *, MapType *, const BenchOptions &);
+double Percentile(const std::vector<double> &, const double &);
+long PeakRssKb();
+void PrintCsv(const std::vector<BenchResult> &);
+void PrintJson(const std::vector<BenchResult> &);
+
+int main(int argc, char **argv) {
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, &options)) return 1;
+
+    if (!options.trace_file.empty()) return RunTrace(options) ? 0 : 1;
+
+    if (options.queries > 0) {
+        std::vector<ThroughputResult> throughput_results;
+        for (auto const &kind : options.maps) {
+            for (auto const &size : options.sizes) {
+                auto map_results = RunThroughput(kind, size, options);
+                throughput_results.insert(throughput_results.end(),
+                                          map_results.begin(),
+                                          map_results.end());
+            }
+        }
+        PrintThroughput(throughput_results, options.format);
+        return 0;
+    }
+
+    std::vector<BenchResult> results;
+    if (!options.map_file.empty()) {
+        if (!RunMapFile(options, &results)) return 1;
+    } else {
+        for (auto const &kind : options.maps) {
+            for (auto const &size : options.sizes) {
+                results.push_back(RunScenario(kind, size, options));
+            }
+        }
+    }
+
+    if (options.format == "json")
+        PrintJson(results);
+    else
+        PrintCsv(results);
+    return 0;
+}
+
+/**
+ * @brief Read the command line options.
+ * @param argc the number of arguments
+ * @param argv the arguments
+ * @param options_ptr the pointer of the options to fill
+ * @return false if an option is not valid
+ */
+bool ParseOptions(int argc, char **argv, BenchOptions *options_ptr) {
+    MapGenerator probe(0);
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        auto equal_sign = argument.find('=');
+        auto name = argument.substr(0, equal_sign);
+        auto value = equal_sign == std::string::npos
+                     ? "" : argument.substr(equal_sign + 1);
+        std::vector<std::string> items;
+        std::stringstream value_stream(value);
+        for (std::string item; std::getline(value_stream, item, ',');)
+            items.push_back(item);
+
+        if (name == "--maps") {
+            for (auto const &item : items) {
+                Map probe_map(1, 1);
+                if (!probe.Generate(&probe_map, item)) {
+                    std::cerr << "unknown map kind: " << item << std::endl;
+                    return false;
+                }
+            }
+            options_ptr->maps = items;
+        } else if (name == "--sizes") {
+            options_ptr->sizes.clear();
+            for (auto const &item : items)
+                options_ptr->sizes.push_back(std::atoi(item.c_str()));
+        } else if (name == "--hidden") {
+            options_ptr->hidden_density = std::atof(value.c_str());
+        } else if (name == "--seed") {
+            options_ptr->seed = std::strtoul(value.c_str(), nullptr, 10);
+        } else if (name == "--max-steps") {
+            options_ptr->max_steps = std::atol(value.c_str());
+        } else if (name == "--sensor-radius" &&
+                   std::atoi(value.c_str()) >= 0) {
+            options_ptr->sensor_radius = std::atoi(value.c_str());
+        } else if (name == "--planner" &&
+                   (value == "flat" || value == "bucket" ||
+                    value == "hierarchical")) {
+            options_ptr->planner = value;
+        } else if (name == "--cluster-size" && std::atoi(value.c_str()) > 1) {
+            options_ptr->cluster_size = std::atoi(value.c_str());
+        } else if (name == "--cost" && (value == "double" ||
+                   value == "float" || value == "fixed")) {
+            options_ptr->cost = value;
+        } else if (name == "--connectivity" &&
+                   (value == "4" || value == "8" || value == "16")) {
+            options_ptr->connectivity = std::atoi(value.c_str());
+        } else if (name == "--format" && (value == "csv" || value == "json")) {
+            options_ptr->format = value;
+        } else if (name == "--queries") {
+            options_ptr->queries = std::atoi(value.c_str());
+        } else if (name == "--threads") {
+            options_ptr->threads.clear();
+            for (auto const &item : items) {
+                if (std::atoi(item.c_str()) < 1) {
+                    std::cerr << "bad thread count: " << item << std::endl;
+                    return false;
+                }
+                options_ptr->threads.push_back(std::atoi(item.c_str()));
+            }
+        } else if (name == "--map-file" && !value.empty()) {
+            options_ptr->map_file = value;
+        } else if (name == "--scen" && !value.empty()) {
+            options_ptr->scenario_file = value;
+        } else if (name == "--trace" && !value.empty()) {
+            options_ptr->trace_file = value;
+        } else {
+            std::cerr << "unknown option: " << argument << std::endl;
+            return false;
+        }
+    }
+    if (!options_ptr->scenario_file.empty() && options_ptr->map_file.empty()) {
+        std::cerr << "--scen needs --map-file" << std::endl;
+        return false;
+    }
+    if (!options_ptr->trace_file.empty() &&
+        options_ptr->planner == "hierarchical") {
+        std::cerr << "--trace needs --planner=flat or bucket" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Plan, walk and replan on one generated map.
+ * @param kind the layout of the map
+ * @param size the height and the width of the map
+ * @param options the options of the benchmark
+ * @return the measurements
+ */
+BenchResult RunScenario(const std::string &kind, const int &size,
+                        const BenchOptions &options) {
+    // Setting the environment
+    Map map(size, size);
+    MapGenerator generator(options.seed);
+    generator.Generate(&map, kind);
+    auto result = RunOnMap(&map, std::make_pair(0, 0),
+                           std::make_pair(size - 1, size - 1), options);
+    result.map_kind = kind;
+    return result;
+}
+
+/**
+ * @brief Plan, walk and replan on the map of --map-file, once per query of
+ * --scen or once from corner to corner.
+ * @param options the options of the benchmark
+ * @param results_ptr the pointer of the measurements to append to
+ * @return false if a file cannot be read
+ */
+bool RunMapFile(const BenchOptions &options,
+                std::vector<BenchResult> *results_ptr) {
+    auto const &path = options.map_file;
+    bool text_map = path.size() > 4 && path.substr(path.size() - 4) == ".map";
+    try {
+        // text maps stream into memory once; binary grids are mapped
+        auto grid = text_map ? MovingAiImporter::ReadMap(path)
+                             : OccupancyGrid::Open(path);
+        auto size = grid.GetSize();
+        if (options.scenario_file.empty()) {
+            Map map(std::move(grid));
+            auto result = RunOnMap(&map, std::make_pair(0, 0),
+                                   std::make_pair(size.first - 1,
+                                                  size.second - 1), options);
+            result.map_kind = path;
+            results_ptr->push_back(result);
+            return true;
+        }
+        std::ifstream scenario_input(options.scenario_file);
+        if (!scenario_input)
+            throw std::runtime_error("cannot open " + options.scenario_file);
+        MovingAiScenarioReader reader(scenario_input);
+        MovingAiScenario scenario;
+        for (int query = 0; reader.Next(&scenario); ++query) {
+            if (scenario.map_size != size)
+                throw std::runtime_error("scenario does not fit the map");
+            // every query gets its own copy of the obstacles
+            Map map(grid);
+            auto result = RunOnMap(&map, scenario.start, scenario.goal,
+                                   options);
+            result.map_kind = path + "#" + std::to_string(query);
+            results_ptr->push_back(result);
+        }
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Replay the trace of --trace and print one record per event.
+ * @param options the options of the benchmark
+ * @return false if the trace or its map cannot be read
+ */
+bool RunTrace(const BenchOptions &options) {
+    try {
+        auto trace = EventTrace::Read(options.trace_file);
+        Map map(trace.LoadObstacles());
+        std::vector<ReplayRecord> records;
+        if (options.planner == "bucket") {
+            BucketDStarLitePlanner planner(&map);
+            records = ReplayTrace(trace, &planner, &map);
+        } else {
+            DStarLitePlanner planner(&map);
+            records = ReplayTrace(trace, &planner, &map);
+        }
+        PrintReplay(records, options.format);
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Plan, walk and replan on one map with the planner of the options.
+ * @param map_ptr the pointer of the map, obstacles already set
+ * @param start the position of the robot
+ * @param goal the position of the goal
+ * @param options the options of the benchmark
+ * @return the measurements, without the name of the map
+ */
+BenchResult RunOnMap(Map *map_ptr, const std::pair<int, int> &start,
+                     const std::pair<int, int> &goal,
+                     const BenchOptions &options) {
+    MapGenerator generator(options.seed);
+    generator.AddHiddenObstacles(map_ptr, options.hidden_density);
+    generator.ClearArea(map_ptr, start, 1);
+    generator.ClearArea(map_ptr, goal, 1);
+    map_ptr->SetGoal(goal);
+    map_ptr->SetStart(start);
+
+    if (options.planner == "hierarchical") {
+        HierarchicalPlanner planner(map_ptr, options.cluster_size);
+        return Walk(&planner, map_ptr, options);
+    }
+    if (options.cost == "float")
+        return RunWithCostType<float>(*map_ptr, options);
+    if (options.cost == "fixed")
+        return RunWithCostType<FixedCost>(*map_ptr, options);
+    if (options.connectivity != 8)
+        return RunWithCostType<double>(*map_ptr, options);
+    return RunFlat(map_ptr, options);
+}
+
+/**
+ * @brief Walk with the flat planner on the cost type and the connectivity
+ *        of the options.
+ * @param map the map, start, goal and hidden obstacles already set
+ * @param options the options of the benchmark
+ * @return the measurements, without the name of the map
+ */
+template <typename CostType>
+BenchResult RunWithCostType(const Map &map, const BenchOptions &options) {
+    if (options.connectivity == 4)
+        return RunWithMapType<BasicMap<CostType, FourConnected>>(map, options);
+    if (options.connectivity == 16)
+        return RunWithMapType<BasicMap<CostType, SixteenConnected>>(map,
+                                                                   options);
+    return RunWithMapType<BasicMap<CostType>>(map, options);
+}
+
+/**
+ * @brief Walk with the flat planner on a copy of the map of another type.
+ *        A map of the same border shares the obstacles instead of copying
+ *        them; the map itself is used when its type is already the one.
+ * @param map the map, start, goal and hidden obstacles already set
+ * @param options the options of the benchmark
+ * @return the measurements, without the name of the map
+ */
+template <typename MapType>
+BenchResult RunWithMapType(const Map &map, const BenchOptions &options) {
+    auto size = map.GetSize();
+    bool shared = MapType::kPadding == Map::kPadding;
+    std::unique_ptr<MapType> copy_ptr;
+    if (shared)
+        copy_ptr.reset(new MapType(map.SharedOccupancy()));
+    else
+        copy_ptr.reset(new MapType(size.first, size.second));
+    for (int i = 0; i < size.first; ++i) {
+        for (int j = 0; j < size.second; ++j) {
+            auto position = std::make_pair(i, j);
+            auto status = map.CurrentStatusCode(map.CellIndex(position));
+            if (status == Map::kUnknown ||
+                (!shared && status == Map::kObstacle))
+                copy_ptr->UpdateStatusCode(
+                    copy_ptr->CellIndex(position),
+                    static_cast<typename MapType::Status>(status));
+        }
+    }
+    copy_ptr->SetGoal(map.GetGoal());
+    copy_ptr->SetStart(map.GetStart());
+    return RunFlat(copy_ptr.get(), options);
+}
+
+/**
+ * @brief Walk with the flat planner on the open list of the options.
+ * @param map_ptr the pointer of the map, start and goal already set
+ * @param options the options of the benchmark
+ * @return the measurements, without the name of the map
+ */
+template <typename MapType>
+BenchResult RunFlat(MapType *map_ptr, const BenchOptions &options) {
+    if (options.planner == "bucket") {
+        BasicDStarLitePlanner<BucketOpenList, MapType> planner(map_ptr);
+        return Walk(&planner, map_ptr, options);
+    }
+    BasicDStarLitePlanner<OpenList, MapType> planner(map_ptr);
+    return Walk(&planner, map_ptr, options);
+}
+
+/**
+ * @brief Plan, walk the robot to the goal and replan on every discovery.
+ * @param planner_ptr the pointer of a planner of the map, not initialized
+ * @param map_ptr the pointer of the map, start and goal already set
+ * @param options the options of the benchmark
+ * @return the measurements, without the name of the map
+ */
+template <class Planner, class MapType>
+BenchResult Walk(Planner *planner_ptr, MapType *map_ptr,
+                 const BenchOptions &options) {
+    using Clock = std::chrono::steady_clock;
+    auto &planner = *planner_ptr;
+    auto goal = map_ptr->GetGoal();
+
+    // Compute shortest path in the beginning
+    planner.SetSensorRadius(options.sensor_radius);
+    auto begin_time = Clock::now();
+    planner.Initialize();
+    planner.ComputeShortestPath();
+    std::chrono::duration<double, std::milli> initial_time =
+        Clock::now() - begin_time;
+
+    // Keep moving until reach the goal, replanning on every discovery
+    std::vector<double> replan_us;
+    long steps = 0;
+    while (planner.CurrentStart() != goal &&
+           (options.max_steps <= 0 || steps < options.max_steps)) {
+        auto next_position = planner.NextMove();
+        if (next_position == planner.CurrentStart()) break;
+        planner.MoveStart(next_position);
+        ++steps;
+        if (planner.DetectHiddenObstacle(next_position)) {
+            auto replan_begin = Clock::now();
+            planner.ComputeShortestPath();
+            std::chrono::duration<double, std::micro> replan_time =
+                Clock::now() - replan_begin;
+            replan_us.push_back(replan_time.count());
+        }
+    }
+    std::sort(replan_us.begin(), replan_us.end());
+
+    BenchResult result;
+    result.size = map_ptr->GetSize().first;
+    result.initial_plan_ms = initial_time.count();
+    result.replans = replan_us.size();
+    result.replan_p50_us = Percentile(replan_us, 0.50);
+    result.replan_p90_us = Percentile(replan_us, 0.90);
+    result.replan_p99_us = Percentile(replan_us, 0.99);
+    result.replan_max_us = replan_us.empty() ? 0.0 : replan_us.back();
+    auto const &stats = planner.Stats();
+    result.cells_expanded = stats.expansions;
+    result.heap_operations = stats.openlist_inserts + stats.openlist_removes +
+                             stats.openlist_updates;
+    result.steps = steps;
+    result.reached = planner.CurrentStart() == goal;
+    result.peak_rss_kb = PeakRssKb();
+    result.planner_stats_json = stats.ToJson();
+    return result;
+}
+
+/**
+ * @brief Answer random queries on one generated map with every thread count.
+ * @param kind the layout of the map
+ * @param size the height and the width of the map
+ * @param options the options of the benchmark
+ * @return the measurements, one per thread count
+ */
+std::vector<ThroughputResult> RunThroughput(const std::string &kind,
+                                            const int &size,
+                                            const BenchOptions &options) {
+    using Clock = std::chrono::steady_clock;
+
+    Map map(size, size);
+    MapGenerator generator(options.seed);
+    generator.Generate(&map, kind);
+    auto base = map.SharedOccupancy();
+
+    // random pairs of free cells
+    std::mt19937 random_engine(options.seed);
+    std::uniform_int_distribution<int> coordinate(0, size - 1);
+    std::vector<PathQuery> queries;
+    for (int attempt = 0; static_cast<int>(queries.size()) < options.queries &&
+                          attempt < options.queries * 100; ++attempt) {
+        auto start = std::make_pair(coordinate(random_engine),
+                                    coordinate(random_engine));
+        auto goal = std::make_pair(coordinate(random_engine),
+                                   coordinate(random_engine));
+        if (!base->Test(start) && !base->Test(goal))
+            queries.push_back(PathQuery{start, goal});
+    }
+
+    std::vector<ThroughputResult> results;
+    for (auto const &thread_num : options.threads) {
+        PlannerPool pool(base, thread_num);
+        auto begin_time = Clock::now();
+        auto paths = pool.Solve(queries);
+        std::chrono::duration<double> solve_time = Clock::now() - begin_time;
+
+        ThroughputResult result;
+        result.map_kind = kind;
+        result.size = size;
+        result.threads = thread_num;
+        result.queries = queries.size();
+        result.reached = std::count_if(
+            paths.begin(), paths.end(),
+            [](const PathResult &path) { return path.reached; });
+        result.seconds = solve_time.count();
+        result.queries_per_second = queries.size() / solve_time.count();
+        results.push_back(result);
+    }
+    return results;
+}
+
+/**
+ * @brief Get a percentile of sorted samples (nearest rank).
+ * @param sorted_samples the samples in increasing order
+ * @param fraction the percentile between 0 and 1
+ * @return the sample at the percentile, or 0 without samples
+ */
+double Percentile(const std::vector<double> &sorted_samples,
+                  const double &fraction) {
+    if (sorted_samples.empty()) return 0.0;
+    auto rank = static_cast<std::size_t>(fraction * sorted_samples.size());
+    return sorted_samples[std::min(rank, sorted_samples.size() - 1)];
+}
+
+/**
+ * @brief Get the peak resident set size of the process so far.
+ * @return the peak resident set size in kilobytes
+ */
+long PeakRssKb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/**
+ * @brief Print the throughput results, one line or object per thread count.
+ * @param results the measurements
+ * @param format csv or json
+ * @return none
+ */
+void PrintThroughput(const std::vector<ThroughputResult> &results,
+                     const std::string &format) {
+    if (format != "json")
+        std::cout << "map,size,threads,queries,reached,seconds,"
+                  << "queries_per_second" << std::endl;
+    else
+        std::cout << "[" << std::endl;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        auto const &result = results[i];
+        if (format != "json") {
+            std::cout << result.map_kind << "," << result.size << ","
+                      << result.threads << "," << result.queries << ","
+                      << result.reached << "," << result.seconds << ","
+                      << result.queries_per_second << std::endl;
+            continue;
+        }
+        std::cout << "  {\"map\": \"" << result.map_kind << "\", "
+                  << "\"size\": " << result.size << ", "
+                  << "\"threads\": " << result.threads << ", "
+                  << "\"queries\": " << result.queries << ", "
+                  << "\"reached\": " << result.reached << ", "
+                  << "\"seconds\": " << result.seconds << ", "
+                  << "\"queries_per_second\": " << result.queries_per_second
+                  << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    if (format == "json") std::cout << "]" << std::endl;
+}
+
+/**
+ * @brief Print the records of a replay, one line or object per event.
+ * @param records the records
+ * @param format csv or json
+ * @return none
+ */
+void PrintReplay(const std::vector<ReplayRecord> &records,
+                 const std::string &format) {
+    if (format != "json")
+        std::cout << "time_us,changed_cells,latency_us,cells_expanded,"
+                  << "path_cost" << std::endl;
+    else
+        std::cout << "[" << std::endl;
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        auto const &record = records[i];
+        if (format != "json") {
+            std::cout << record.time_us << "," << record.changed_cells << ","
+                      << record.latency_us << "," << record.expansions << ","
+                      << record.path_cost << std::endl;
+            continue;
+        }
+        // JSON has no infinity
+        std::cout << "  {\"time_us\": " << record.time_us << ", "
+                  << "\"changed_cells\": " << record.changed_cells << ", "
+                  << "\"latency_us\": " << record.latency_us << ", "
+                  << "\"cells_expanded\": " << record.expansions << ", "
+                  << "\"path_cost\": ";
+        if (std::isinf(record.path_cost))
+            std::cout << "null";
+        else
+            std::cout << record.path_cost;
+        std::cout << "}" << (i + 1 < records.size() ? "," : "") << std::endl;
+    }
+    if (format == "json") std::cout << "]" << std::endl;
+}
+
+/**
+ * @brief Print the results as CSV, one line per map.
+ * @param results the measurements
+ * @return none
+ */
+void PrintCsv(const std::vector<BenchResult> &results) {
+    std::cout << "map,size,initial_plan_ms,replans,replan_p50_us,"
+              << "replan_p90_us,replan_p99_us,replan_max_us,cells_expanded,"
+              << "heap_operations,steps,reached,peak_rss_kb" << std::endl;
+    for (auto const &result : results) {
+        std::cout << result.map_kind << "," << result.size << ","
+                  << result.initial_plan_ms << "," << result.replans << ","
+                  << result.replan_p50_us << "," << result.replan_p90_us << ","
+                  << result.replan_p99_us << "," << result.replan_max_us << ","
+                  << result.cells_expanded << "," << result.heap_operations
+                  << "," << result.steps << "," << result.reached << ","
+                  << result.peak_rss_kb << std::endl;
+    }
+}
+
+/**
+ * @brief Print the results as a JSON array, one object per map.
+ * @param results the measurements
+ * @return none
+ */
+void PrintJson(const std::vector<BenchResult> &results) {
+    std::cout << "[" << std::endl;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        auto const &result = results[i];
+        std::cout << "  {\"map\": \"" << result.map_kind << "\", "
+                  << "\"size\": " << result.size << ", "
+                  << "\"initial_plan_ms\": " << result.initial_plan_ms << ", "
+                  << "\"replans\": " << result.replans << ", "
+                  << "\"replan_p50_us\": " << result.replan_p50_us << ", "
+                  << "\"replan_p90_us\": " << result.replan_p90_us << ", "
+                  << "\"replan_p99_us\": " << result.replan_p99_us << ", "
+                  << "\"replan_max_us\": " << result.replan_max_us << ", "
+                  << "\"cells_expanded\": " << result.cells_expanded << ", "
+                  << "\"heap_operations\": " << result.heap_operations << ", "
+                  << "\"steps\": " << result.steps << ", "
+                  << "\"reached\": " << (result.reached ? "true" : "false")
+                  << ", \"peak_rss_kb\": " << result.peak_rss_kb
+                  << ", \"planner_stats\": " << result.planner_stats_json << "}"
+                  << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    std::cout << "]" << std::endl;
+}
@@ -0,0 +1,116 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+/**
+ * @file AnytimeDStarPlanner.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class plans with Anytime D*: each pass searches with the heuristic
+ * inflated by epsilon, which finds a path after far fewer expansions, and
+ * the cost of the path it finds is at most epsilon times the optimal cost.
+ * Passes follow a schedule of decreasing epsilon down to 1, where the path
+ * is optimal. A pass reuses the work of the last one: cells that became
+ * inconsistent after they were expanded in a pass wait in an inconsistent
+ * list, and only they and the open list are searched again. When the map
+ * changes, the schedule starts over from its first epsilon.
+ * 
+ */
+
+#ifndef INCLUDE_ANYTIMEDSTARPLANNER_H_
+#define INCLUDE_ANYTIMEDSTARPLANNER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "DStarLitePlanner.h"
+#include "Map.h"
+#include "OpenList.h"
+#include "PagedArray.h"
+
+// one pass of the schedule
+struct AnytimeIteration {
+    double epsilon;
+    std::size_t expansions;
+    double time_us;
+    // g-value of the start, at most epsilon times the optimal cost
+    double path_cost;
+};
+
+class AnytimeDStarPlanner {
+ public:
+    explicit AnytimeDStarPlanner(Map *);
+
+    // planning
+    void SetEpsilonSchedule(const std::vector<double> &);
+    const std::vector<double> &EpsilonSchedule() const;
+    void Initialize();
+    bool ImprovePath();
+    void ComputeShortestPath();
+    void ComputeShortestPath(const std::chrono::steady_clock::time_point &);
+
+    // moving and sensing
+    void MoveStart(const std::pair<int, int> &);
+    bool ApplyChanges(const std::vector<CellChange> &);
+
+    // next-move query
+    std::pair<int, int> NextMove();
+
+    // get method
+    double Epsilon() const;
+    bool Optimal() const;
+    std::pair<int, int> CurrentStart() const;
+    const std::vector<AnytimeIteration> &Iterations() const;
+
+ private:
+    using Neighbor = Map::Neighbor;
+
+    void UpdateState(const int &);
+    void PreparePass();
+
+    Map *map_ptr;
+    OpenList openlist;
+    std::pair<int, int> start;
+    std::vector<double> schedule;
+    // position in the schedule of the next pass
+    std::size_t schedule_step = 0;
+    // epsilon of the pass searching or last finished
+    double epsilon;
+    // epsilon the path of the last finished pass is bounded by
+    double bound_epsilon;
+    // number of the pass; a cell expanded as overconsistent in this pass
+    // carries it and is closed
+    std::uint32_t pass = 0;
+    PagedArray<std::uint32_t> closed_pass;
+    // cells that became inconsistent after they were closed
+    std::vector<int> inconsistent;
+    std::vector<int> affected_vertices;
+    std::vector<AnytimeIteration> iterations;
+    // the last pass ran at the final epsilon and nothing changed since
+    bool optimal = false;
+};
+
+#endif  // INCLUDE_ANYTIMEDSTARPLANNER_H_
@@ -0,0 +1,114 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file BucketOpenList.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * An open list with the interface of OpenList that files nodes into buckets
+ * by the first component of their key, kResolution buckets per unit of
+ * cost. Grid costs are small multiples of 0.5, so a bucket holds few
+ * distinct keys; each bucket is a small indexed heap on the full key, which
+ * keeps the order exact for any key. D* Lite's keys are not monotone (the
+ * key of a node may drop below the top, and km moves them all), so the
+ * cursor on the lowest non-empty bucket moves back down when such a key
+ * arrives. Keys too large or not finite share an overflow heap kept apart
+ * from the regular buckets, so they never allocate the buckets below them.
+ * 
+ */
+
+#ifndef INCLUDE_BUCKETOPENLIST_H_
+#define INCLUDE_BUCKETOPENLIST_H_
+
+#include <tuple>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include "Key.h"
+#include "PagedArray.h"
+
+class BucketOpenList {
+ public:
+    // buckets per unit of cost and the number of regular buckets
+    static constexpr int kResolution = 2;
+    static constexpr int kMaxBucketNum = 1 << 20;
+    // the bucket index of the overflow heap
+    static constexpr int kOverflowBucket = kMaxBucketNum;
+
+    BucketOpenList() = default;
+    explicit BucketOpenList(const int &, const int &);
+    void Insert(const Key &, const std::pair<int, int> &);
+    void Insert(const double &, const std::pair<int, int> &);
+    void UpdateKey(const Key &, const std::pair<int, int> &);
+    void UpdateKey(const double &, const std::pair<int, int> &);
+    void Remove(const std::pair<int, int> &);
+    std::pair<Key, std::pair<int, int>> Top() const;
+    std::pair<Key, std::pair<int, int>> Pop();
+    bool Find(const std::pair<int, int> &) const;
+    bool Empty() const;
+    std::size_t Size() const;
+    std::size_t BucketNum() const;
+    std::vector<std::pair<Key, std::pair<int, int>>> Nodes() const;
+
+ private:
+    using Node = std::tuple<Key, int, int>;
+    // bucket and slot in the bucket's heap of a node
+    struct Location {
+        int bucket;
+        int slot;
+        bool operator==(const Location &other) const {
+            return bucket == other.bucket && slot == other.slot;
+        }
+    };
+
+    static int BucketOf(const Key &);
+    std::vector<Node> &Heap(const int &);
+    const std::vector<Node> &Heap(const int &) const;
+    Location LocationOf(const std::pair<int, int> &) const;
+    void SetLocation(const std::pair<int, int> &, const Location &);
+    void ClearLocation(const std::pair<int, int> &);
+    void Add(const Node &);
+    void Take(const Location &);
+    void SkipEmptyBuckets();
+    void Place(const int &, const Node &, const int &);
+    void SiftUp(const int &, int);
+    void SiftDown(const int &, int);
+
+    std::vector<std::vector<Node>> buckets;
+    std::vector<Node> overflow;
+    // no bucket below min_bucket holds a node; kOverflowBucket when only
+    // the overflow heap does
+    int min_bucket = 0;
+    std::size_t node_num = 0;
+    // location of each node: a paged table when the size of the map is
+    // known, a hash table otherwise
+    int grid_width = 0;
+    PagedArray<Location> dense_location;
+    std::unordered_map<long long, Location> sparse_location;
+};
+
+#endif  // INCLUDE_BUCKETOPENLIST_H_
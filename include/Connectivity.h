@@ -0,0 +1,135 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file Connectivity.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Compile-time policies for the moves between cells of a grid. A policy
+ * gives the number of neighbors, the row and column offset and the cost of
+ * each move, and the width of the obstacle border that keeps every move
+ * from a cell of the map inside the padded grid. Slot k of a policy is a
+ * constant expression, so loops over the neighbors unroll completely.
+ * The heuristic of the map is built from the transitional, diagonal and
+ * knight costs, so it stays consistent with the moves of every policy.
+ * A move that jumps passes over two cells, one sharing an edge and one
+ * sharing a corner with the cell it leaves, and is only allowed when both
+ * are free.
+ * 
+ */
+
+#ifndef INCLUDE_CONNECTIVITY_H_
+#define INCLUDE_CONNECTIVITY_H_
+
+// moves to the four cells sharing an edge
+struct FourConnected {
+    static constexpr int kNeighborNum = 4;
+    static constexpr int kPadding = 1;
+    static constexpr double kTransitionalCost = 1.0;
+    // no diagonal move: crossing a corner takes two transitional moves
+    static constexpr double kDiagonalCost = 2.0;
+    // no knight move either: it takes three transitional moves
+    static constexpr double kKnightCost = 3 * kTransitionalCost;
+
+    static constexpr int Row(const int &slot) {
+        constexpr int kRows[kNeighborNum] = {-1, 0, 0, 1};
+        return kRows[slot];
+    }
+    static constexpr int Col(const int &slot) {
+        constexpr int kCols[kNeighborNum] = {0, -1, 1, 0};
+        return kCols[slot];
+    }
+    static constexpr double Cost(const int &) { return kTransitionalCost; }
+    static constexpr bool Jumps(const int &) { return false; }
+    static constexpr int PassRow(const int &) { return 0; }
+    static constexpr int PassCol(const int &) { return 0; }
+};
+
+// moves to the eight cells sharing an edge or a corner
+struct EightConnected {
+    static constexpr int kNeighborNum = 8;
+    static constexpr int kPadding = 1;
+    static constexpr double kTransitionalCost = 1.0;
+    static constexpr double kDiagonalCost = 2.5;
+    // no knight move: it takes three transitional moves
+    static constexpr double kKnightCost = 3 * kTransitionalCost;
+
+    static constexpr int Row(const int &slot) {
+        constexpr int kRows[kNeighborNum] = {-1, -1, -1, 0, 0, 1, 1, 1};
+        return kRows[slot];
+    }
+    static constexpr int Col(const int &slot) {
+        constexpr int kCols[kNeighborNum] = {-1, 0, 1, -1, 1, -1, 0, 1};
+        return kCols[slot];
+    }
+    static constexpr double Cost(const int &slot) {
+        return Row(slot) != 0 && Col(slot) != 0 ? kDiagonalCost
+                                                : kTransitionalCost;
+    }
+    static constexpr bool Jumps(const int &) { return false; }
+    static constexpr int PassRow(const int &) { return 0; }
+    static constexpr int PassCol(const int &) { return 0; }
+};
+
+// the eight moves above and the eight knight moves, two cells away, so the
+// border is two cells wide
+struct SixteenConnected {
+    static constexpr int kNeighborNum = 16;
+    static constexpr int kPadding = 2;
+    static constexpr double kTransitionalCost = 1.0;
+    static constexpr double kDiagonalCost = 2.5;
+    // a knight move costs its length, sqrt(5), rounded up to a quarter so
+    // that sums of costs stay exact in every cost type; that is still less
+    // than the three transitional moves around it, so it shortens paths
+    static constexpr double kKnightCost = 2.25 * kTransitionalCost;
+
+    static constexpr int Row(const int &slot) {
+        constexpr int kRows[kNeighborNum] = {-2, -2, -1, -1, -1, -1, -1, 0,
+                                             0, 1, 1, 1, 1, 1, 2, 2};
+        return kRows[slot];
+    }
+    static constexpr int Col(const int &slot) {
+        constexpr int kCols[kNeighborNum] = {-1, 1, -2, -1, 0, 1, 2, -1,
+                                             1, -2, -1, 0, 1, 2, -1, 1};
+        return kCols[slot];
+    }
+    static constexpr double Cost(const int &slot) {
+        return Jumps(slot) ? kKnightCost
+                           : Row(slot) != 0 && Col(slot) != 0
+                                 ? kDiagonalCost
+                                 : kTransitionalCost;
+    }
+    static constexpr bool Jumps(const int &slot) {
+        return Row(slot) * Row(slot) + Col(slot) * Col(slot) == 5;
+    }
+    // the cell sharing an edge that a knight move passes over; the cell
+    // sharing a corner is the rest of the move
+    static constexpr int PassRow(const int &slot) { return Row(slot) / 2; }
+    static constexpr int PassCol(const int &slot) { return Col(slot) / 2; }
+};
+
+#endif  // INCLUDE_CONNECTIVITY_H_
@@ -0,0 +1,85 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file Cost.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * The types that g-values and rhs-values can be stored in: double, float or
+ * FixedCost, an unsigned fixed-point count of 1/16 of a unit of cost. Each
+ * has a true infinity that sums saturate at, so no path is too long to be
+ * told from an unreachable cell. Costs of one type are compared exactly;
+ * keys are still built in double from ToDouble.
+ * 
+ */
+
+#ifndef INCLUDE_COST_H_
+#define INCLUDE_COST_H_
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// fixed-point cost, in 1/16 of a unit
+using FixedCost = std::uint32_t;
+
+template <typename CostType>
+struct CostTraits {
+    static constexpr CostType Infinity() {
+        return std::numeric_limits<CostType>::infinity();
+    }
+    static CostType FromDouble(const double &value) {
+        return static_cast<CostType>(value);
+    }
+    static double ToDouble(const CostType &value) { return value; }
+    // infinity plus anything stays infinity
+    static CostType Add(const CostType &a, const CostType &b) { return a + b; }
+};
+
+template <>
+struct CostTraits<FixedCost> {
+    static constexpr int kScale = 16;
+    static constexpr FixedCost Infinity() {
+        return std::numeric_limits<FixedCost>::max();
+    }
+    static FixedCost FromDouble(const double &value) {
+        if (!(value < Infinity() / static_cast<double>(kScale)))
+            return Infinity();
+        return static_cast<FixedCost>(std::lround(value * kScale));
+    }
+    static double ToDouble(const FixedCost &value) {
+        return value == Infinity()
+                   ? std::numeric_limits<double>::infinity()
+                   : static_cast<double>(value) / kScale;
+    }
+    // saturates at infinity instead of wrapping around
+    static FixedCost Add(const FixedCost &a, const FixedCost &b) {
+        return a > Infinity() - b ? Infinity() : a + b;
+    }
+};
+
+#endif  // INCLUDE_COST_H_
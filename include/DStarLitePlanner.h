@@ -0,0 +1,198 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file DStarLitePlanner.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class performs the D* Lite algorithm on a map: it computes the
+ * shortest path from the goal, repairs it incrementally when cells of the
+ * map change and tells where the robot, or each robot of a fleet, should
+ * move next. The open list and the map are template parameters; their
+ * combinations are instantiated in DStarLitePlanner.cpp.
+ * 
+ */
+
+#ifndef INCLUDE_DSTARLITEPLANNER_H_
+#define INCLUDE_DSTARLITEPLANNER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+#include "Map.h"
+#include "OpenList.h"
+#include "BucketOpenList.h"
+#include "PlannerObserver.h"
+#include "PlannerStats.h"
+#include "Robot.h"
+
+// A cell with a known cost to the goal beyond what the map holds, such as a
+// cell on the edge of a window whose goal lies outside.
+struct FrontierCost {
+    std::pair<int, int> position;
+    double cost;
+};
+
+// Limits of one ComputeShortestPath; the defaults are no limits.
+struct SearchBudget {
+    // 0 for no limit; stale keys count as expansions
+    std::size_t max_expansions = 0;
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::time_point::max();
+};
+
+// Whether ComputeShortestPath finished or ran out of budget.
+enum class SearchStatus { kConverged, kPartial };
+
+template <typename OpenListType, typename MapType = Map>
+class BasicDStarLitePlanner {
+ public:
+    using CostType = typename MapType::Cost;
+    using Neighbor = typename MapType::Neighbor;
+    using ObserverType = BasicPlannerObserver<MapType>;
+
+    explicit BasicDStarLitePlanner(MapType *);
+
+    // planning
+    void SetFrontier(const std::vector<FrontierCost> &);
+    void Initialize();
+    void ComputeShortestPath();
+    SearchStatus ComputeShortestPath(const SearchBudget &);
+    bool Converged() const;
+    void UpdateVertex(const std::pair<int, int> &);
+    void UpdateVertex(const int &);
+    CostType ComputeMinRhs(const std::pair<int, int> &);
+    CostType ComputeMinRhs(const int &);
+
+    // moving and sensing
+    void MoveStart(const std::pair<int, int> &);
+    bool ApplyChanges(const std::vector<CellChange> &);
+    bool ApplyTerrainChanges(const std::vector<TerrainChange> &);
+    bool UpdateRegionTerrain(const std::pair<int, int> &,
+                             const std::pair<int, int> &, const int &);
+    bool DetectHiddenObstacle(const std::pair<int, int> &);
+    void SetSensorRadius(const int &);
+    int SensorRadius() const;
+
+    // next-move query
+    std::pair<int, int> ComputeNextPotision(const std::pair<int, int> &);
+    std::pair<int, int> NextMove();
+
+    // fleet of robots sharing the search
+    int AddRobot(const std::pair<int, int> &);
+    void MoveRobot(const int &, const std::pair<int, int> &);
+    std::pair<int, int> RobotPosition(const int &) const;
+    int RobotNum() const;
+    std::vector<std::pair<int, int>> NextMoves();
+
+    // snapshot
+    void SaveSnapshot(const std::string &) const;
+    void LoadSnapshot(const std::string &);
+
+    // events
+    void SetObserver(ObserverType *,
+                     const ObserverOptions & = ObserverOptions());
+
+    // get method
+    std::pair<int, int> CurrentStart() const;
+    const OpenListType &CurrentOpenList() const;
+    const PlannerStats &Stats() const;
+    void ResetStats();
+
+ private:
+    void SyncStart();
+    bool Settled(const int &, const Key &) const;
+    bool RobotsSettled(const Key &);
+    bool ShouldNotify(int *, const int &) const;
+
+    MapType *map_ptr;
+    OpenListType openlist;
+    // current start of the search, which the map catches up with on change
+    std::pair<int, int> start;
+    int sensor_radius = 1;
+    std::vector<Robot> robots;
+    // robots known to be settled in the current ComputeShortestPath
+    std::size_t settled_robot_num = 0;
+    // false while a bounded search has work left
+    bool converged = true;
+    // nodes to update after a batch of changes, kept to reuse its memory
+    std::vector<int> affected_vertices;
+    // cost to the goal of each frontier cell, infinity elsewhere
+    std::vector<int> frontier;
+    PagedArray<CostType> frontier_cost;
+    PlannerStats stats;
+    // nullptr when headless
+    ObserverType *observer = nullptr;
+    ObserverOptions observer_options;
+    int replan_event_num = 0;
+    int step_event_num = 0;
+    int change_event_num = 0;
+};
+
+using DStarLitePlanner = BasicDStarLitePlanner<OpenList>;
+using BucketDStarLitePlanner = BasicDStarLitePlanner<BucketOpenList>;
+
+extern template class BasicDStarLitePlanner<
+    OpenList, BasicMap<double, FourConnected>>;
+extern template class BasicDStarLitePlanner<
+    OpenList, BasicMap<double, EightConnected>>;
+extern template class BasicDStarLitePlanner<
+    OpenList, BasicMap<double, SixteenConnected>>;
+extern template class BasicDStarLitePlanner<
+    OpenList, BasicMap<float, FourConnected>>;
+extern template class BasicDStarLitePlanner<
+    OpenList, BasicMap<float, EightConnected>>;
+extern template class BasicDStarLitePlanner<
+    OpenList, BasicMap<float, SixteenConnected>>;
+extern template class BasicDStarLitePlanner<
+    OpenList, BasicMap<FixedCost, FourConnected>>;
+extern template class BasicDStarLitePlanner<
+    OpenList, BasicMap<FixedCost, EightConnected>>;
+extern template class BasicDStarLitePlanner<
+    OpenList, BasicMap<FixedCost, SixteenConnected>>;
+extern template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<double, FourConnected>>;
+extern template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<double, EightConnected>>;
+extern template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<double, SixteenConnected>>;
+extern template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<float, FourConnected>>;
+extern template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<float, EightConnected>>;
+extern template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<float, SixteenConnected>>;
+extern template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<FixedCost, FourConnected>>;
+extern template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<FixedCost, EightConnected>>;
+extern template class BasicDStarLitePlanner<
+    BucketOpenList, BasicMap<FixedCost, SixteenConnected>>;
+
+#endif  // INCLUDE_DSTARLITEPLANNER_H_
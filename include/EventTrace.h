@@ -0,0 +1,140 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file EventTrace.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * An event trace records what a robot went through: the map, the goal, the
+ * start, then timestamped poses and cell changes. Replaying it through a
+ * planner reproduces the replans of a field run offline, as fast as the
+ * planner goes, and times each of them.
+ * Traces are text, one record per line, and lines starting with '#' are
+ * comments:
+ *
+ *     dstarlite-trace 1
+ *     size 100 120
+ *     map warehouse.map
+ *     goal 0 0
+ *     start 99 119
+ *     1500 pose 98 118
+ *     1500 block 5 5 5 6
+ *     4200 free 5 5
+ *
+ * The optional map is a Moving AI .map file or a binary occupancy grid,
+ * relative to the trace; without it the map starts free. Event lines begin
+ * with a time in microseconds, which never decreases; the lines sharing a
+ * time form one event, which moves the robot, applies the changes in order
+ * and replans once.
+ * 
+ */
+
+#ifndef INCLUDE_EVENTTRACE_H_
+#define INCLUDE_EVENTTRACE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Map.h"
+#include "OccupancyGrid.h"
+
+// What happened at one time of a trace.
+struct TraceEvent {
+    std::int64_t time_us;
+    bool moved;
+    std::pair<int, int> pose;
+    std::vector<CellChange> changes;
+};
+
+// How the planner handled one event of a trace.
+struct ReplayRecord {
+    std::int64_t time_us;
+    std::size_t changed_cells;
+    // ApplyChanges and ComputeShortestPath together
+    double latency_us;
+    std::uint64_t expansions;
+    // cost from the robot to the goal afterwards, infinity if unreachable
+    double path_cost;
+};
+
+class EventTrace {
+ public:
+    static EventTrace Read(std::istream &);
+    static EventTrace Read(const std::string &);
+    void Write(std::ostream &) const;
+    OccupancyGrid LoadObstacles() const;
+
+    std::pair<int, int> map_size;
+    // empty when the map starts free
+    std::string map_file;
+    std::pair<int, int> goal;
+    std::pair<int, int> start;
+    std::vector<TraceEvent> events;
+};
+
+/**
+ * @brief Replay a trace: plan from its start once, then for each event
+ *        move the start, apply the changes and replan, timing only the
+ *        changes and the replan.
+ * @param trace the trace
+ * @param planner_ptr the pointer of a planner of the map, not initialized
+ * @param map_ptr the pointer of the map, with the obstacles of the trace
+ * @return one record per event
+ */
+template <class Planner, class MapType>
+std::vector<ReplayRecord> ReplayTrace(const EventTrace &trace,
+                                      Planner *planner_ptr,
+                                      MapType *map_ptr) {
+    using Clock = std::chrono::steady_clock;
+    map_ptr->SetGoal(trace.goal);
+    map_ptr->SetStart(trace.start);
+    planner_ptr->Initialize();
+    planner_ptr->ComputeShortestPath();
+
+    std::vector<ReplayRecord> records;
+    records.reserve(trace.events.size());
+    for (auto const &event : trace.events) {
+        if (event.moved) planner_ptr->MoveStart(event.pose);
+        auto expansions_before = planner_ptr->Stats().expansions;
+        auto begin_time = Clock::now();
+        planner_ptr->ApplyChanges(event.changes);
+        planner_ptr->ComputeShortestPath();
+        std::chrono::duration<double, std::micro> latency =
+            Clock::now() - begin_time;
+        records.push_back(ReplayRecord{
+            event.time_us, event.changes.size(), latency.count(),
+            planner_ptr->Stats().expansions - expansions_before,
+            map_ptr->CurrentCellG(planner_ptr->CurrentStart())});
+    }
+    return records;
+}
+
+#endif  // INCLUDE_EVENTTRACE_H_
@@ -0,0 +1,151 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file HierarchicalPlanner.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class plans on an abstraction of a map in the manner of HPA*: the
+ * map is cut into square clusters, entrances are placed where free cells
+ * face each other across the border of two clusters, or touch diagonally
+ * where no other move crosses it, and the cost between every two entrances
+ * of a cluster is cached. D* Lite runs on this graph of
+ * entrances, the start and the goal; moves are refined inside the cluster
+ * of the robot. When cells change, only the clusters and borders they touch
+ * are rebuilt and their nodes updated once each, in one batch.
+ * Paths are at most slightly longer than on the map itself, since they
+ * cross clusters at entrances only.
+ * 
+ */
+
+#ifndef INCLUDE_HIERARCHICALPLANNER_H_
+#define INCLUDE_HIERARCHICALPLANNER_H_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "Map.h"
+#include "OpenList.h"
+#include "PlannerStats.h"
+
+class HierarchicalPlanner {
+ public:
+    HierarchicalPlanner(Map *, const int &);
+
+    // planning
+    void Initialize();
+    void ComputeShortestPath();
+
+    // moving and sensing
+    void MoveStart(const std::pair<int, int> &);
+    bool ApplyChanges(const std::vector<CellChange> &);
+    bool ApplyTerrainChanges(const std::vector<TerrainChange> &);
+    bool DetectHiddenObstacle(const std::pair<int, int> &);
+    void SetSensorRadius(const int &);
+
+    // path queries
+    std::pair<int, int> NextMove();
+    std::vector<std::pair<int, int>> AbstractPath() const;
+    std::vector<std::pair<int, int>> RefinePath();
+    double PathCost() const;
+
+    // get method
+    std::pair<int, int> CurrentStart() const;
+    int ClusterSize() const;
+    std::size_t AbstractNodeNum() const;
+    int LastRepairedClusterNum() const;
+    const PlannerStats &Stats() const;
+
+ private:
+    // the cost is that of the way from the node to the other one
+    struct Edge {
+        int to;
+        double cost;
+    };
+    struct Node {
+        std::pair<int, int> cell;
+        int cluster;
+        bool alive;
+        // edges to nodes of the same cluster and across a border
+        std::vector<Edge> intra;
+        std::vector<Edge> inter;
+    };
+
+    int ClusterOf(const std::pair<int, int> &) const;
+    void ClusterBounds(const int &, int *, int *, int *, int *) const;
+    int LocalIndex(const int &, const std::pair<int, int> &) const;
+    int AddNode(const std::pair<int, int> &);
+    void RemoveNode(const int &, std::vector<int> *);
+    int BorderBetween(const int &, const int &) const;
+    int BorderNeighbor(const int &) const;
+    void AddCrossing(const std::pair<int, int> &, const std::pair<int, int> &,
+                     const int &);
+    bool Squeezed(const std::pair<int, int> &,
+                  const std::pair<int, int> &) const;
+    void BuildBorder(const int &);
+    void ClearBorder(const int &, std::vector<int> *);
+    void MarkChangedCell(const std::pair<int, int> &, std::vector<int> *,
+                         std::vector<int> *);
+    bool RepairClusters(std::vector<int> *, std::vector<int> *);
+    void LocalSearch(const int &, const std::pair<int, int> &);
+    double ReverseCost(const int &, const int &, const double &) const;
+    void RebuildIntraEdges(const int &);
+    void ConnectNode(const int &);
+    std::vector<int> AbstractNodePath() const;
+    Key CalculateKey(const int &) const;
+    void UpdateVertex(const int &);
+    void UpdateVertices(std::vector<int> *);
+
+    Map *map_ptr;
+    int cluster_size;
+    int cluster_rows = 0;
+    int cluster_cols = 0;
+    std::vector<Node> nodes;
+    std::vector<int> free_ids;
+    std::vector<double> g;
+    std::vector<double> rhs;
+    // live nodes of each cluster
+    std::vector<std::vector<int>> cluster_nodes;
+    // entrance nodes of the borders of clusters, four per cluster: to the
+    // right, lower, lower-right and lower-left neighbor
+    std::vector<std::vector<int>> border_nodes;
+    int goal_node = -1;
+    int start_node = -1;
+    std::pair<int, int> start;
+    double key_modifier = 0.0;
+    int sensor_radius = 1;
+    int last_repaired_cluster_num = 0;
+    OpenList openlist;
+    // distances and parents of the last search inside a cluster, by local
+    // index, and the parents of the search from the start
+    std::vector<double> local_dist;
+    std::vector<int> local_parent;
+    std::vector<int> start_parent;
+    PlannerStats stats;
+};
+
+#endif  // INCLUDE_HIERARCHICALPLANNER_H_
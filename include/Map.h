@@ -30,26 +30,69 @@
  * @brief D* Lite Path Planning
  *
  * This class controls cells in the map and provides all infomation and 
- * all methods that related to the environment.
+ * all methods that related to the environment. Cells are stored row by row
+ * in paged arrays, padded with a border of obstacles so that neighbors never
+ * need a bounds check. The cost type and the connectivity are template
+ * parameters.
  * 
  */
 
 #ifndef INCLUDE_MAP_H_
 #define INCLUDE_MAP_H_
 
+#include <array>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <iomanip>
+#include <memory>
 #include <vector>
 #include <string>
 #include <utility>
-#include "Cell.h"
+#include "Connectivity.h"
+#include "Cost.h"
+#include "Key.h"
+#include "OccupancyGrid.h"
+#include "PagedArray.h"
 
-class Map {
+class SnapshotReader;
+class SnapshotWriter;
+
+// A cell of the map that became blocked or free.
+struct CellChange {
+    std::pair<int, int> position;
+    bool blocked;
+};
+
+// A cell of the map whose terrain became faster or slower.
+struct TerrainChange {
+    std::pair<int, int> position;
+    std::uint8_t terrain;
+};
+
+template <typename CostType, typename Connectivity = EightConnected>
+class BasicMap {
  public:
+    using Cost = CostType;
+    using ConnectivityType = Connectivity;
+
+    // status codes of a cell; codes after kRobot refer to custom marks
+    enum Status : std::uint8_t {
+        kFree = 0,
+        kObstacle,
+        kUnknown,
+        kGoal,
+        kStart,
+        kRobot
+    };
+
     // different costs
-    const double infinity_cost = 100.0;
-    const double diagonal_cost = 2.5;
-    const double transitional_cost = 1.0;
+    const CostType infinity_cost = CostTraits<CostType>::Infinity();
+    const double diagonal_cost = Connectivity::kDiagonalCost;
+    const double transitional_cost = Connectivity::kTransitionalCost;
+    const double knight_cost = Connectivity::kKnightCost;
+    // each level of terrain adds this much to the cost of entering a cell
+    const double terrain_step = 0.25 * transitional_cost;
 
     // different status marks
     const std::string robot_mark = ".";
@@ -58,18 +101,94 @@ class Map {
     const std::string obstacle_mark = "x";
     const std::string unknown_mark = "?";
 
+    // a free neighbor of a cell and the cost to move there
+    struct Neighbor {
+        int index;
+        CostType cost;
+    };
+    static constexpr int kNeighborNum = Connectivity::kNeighborNum;
+    // width of the border of obstacles around the map
+    static constexpr int kPadding = Connectivity::kPadding;
+    // whether some moves jump over cells, so that freeing a cell can open
+    // moves between its neighbors
+    static constexpr bool kJumps = Connectivity::kPadding > 1;
+
+    // iterates over the free neighbors of a cell without allocating
+    class NeighborIterator {
+     public:
+        NeighborIterator(const BasicMap *map_ptr, const int &center,
+                         const int &slot)
+            : map_ptr(map_ptr), center(center), slot(slot) { SkipBlocked(); }
+        Neighbor operator*() const {
+            auto neighbor = center + map_ptr->neighbor_offset[slot];
+            return Neighbor{neighbor, map_ptr->neighbor_cost[slot] +
+                                          map_ptr->TerrainCost(neighbor)};
+        }
+        NeighborIterator &operator++() {
+            ++slot;
+            SkipBlocked();
+            return *this;
+        }
+        bool operator!=(const NeighborIterator &other) const {
+            return slot != other.slot;
+        }
+
+     private:
+        void SkipBlocked() {
+            while (slot < kNeighborNum && !map_ptr->Passable(center, slot))
+                ++slot;
+        }
+        const BasicMap *map_ptr;
+        int center;
+        int slot;
+    };
+    class NeighborRange {
+     public:
+        NeighborRange(const BasicMap *map_ptr, const int &center)
+            : map_ptr(map_ptr), center(center) {}
+        NeighborIterator begin() const {
+            return NeighborIterator(map_ptr, center, 0);
+        }
+        NeighborIterator end() const {
+            return NeighborIterator(map_ptr, center, kNeighborNum);
+        }
+
+     private:
+        const BasicMap *map_ptr;
+        int center;
+    };
+
+    // heuristic estimating the cost between two positions
+    using HeuristicFunction =
+        std::function<double(const std::pair<int, int> &,
+                             const std::pair<int, int> &)>;
+
     // constructor and environment initializing
-    explicit Map(const int &, const int &);
+    explicit BasicMap(const int &, const int &);
+    explicit BasicMap(OccupancyGrid);
+    explicit BasicMap(std::shared_ptr<const OccupancyGrid>);
     void AddObstacle(const std::vector<std::pair<int, int>> &,
                      const std::vector<std::pair<int, int>> &);
     void SetGoal(const std::pair<int, int> &);
+    void SetStart(const std::pair<int, int> &);
+    void UpdateStart(const std::pair<int, int> &);
+    void SetHeuristic(const HeuristicFunction &);
 
     // get method
+    std::pair<int, int> GetSize() const;
     std::pair<int, int> GetGoal() const;
+    std::pair<int, int> GetStart() const;
+    double GetKeyModifier() const;
     double CurrentCellG(const std::pair<int, int> &) const;
     double CurrentCellRhs(const std::pair<int, int> &) const;
-    double CalculateCellKey(const std::pair<int, int> &) const;
+    Key CalculateCellKey(const std::pair<int, int> &) const;
+    double ComputeHeuristic(const std::pair<int, int> &,
+                            const std::pair<int, int> &) const;
     std::string CurrentCellStatus(const std::pair<int, int> &) const;
+    const OccupancyGrid &Occupancy() const;
+    std::shared_ptr<const OccupancyGrid> SharedOccupancy() const;
+    const OccupancyGrid &Hidden() const;
+    std::size_t AllocatedBytes() const;
 
     // set method
     void UpdateCellG(const std::pair<int, int> &, const double &);
@@ -79,20 +198,157 @@ class Map {
 
     double ComputeCost(const std::pair<int, int> &,
                        const std::pair<int, int> &);
+    int CurrentCellTerrain(const std::pair<int, int> &) const;
+    void UpdateCellTerrain(const std::pair<int, int> &, const int &);
+
+    // snapshot
+    void WriteSnapshot(SnapshotWriter *) const;
+    void ReadSnapshot(const SnapshotReader &);
 
     std::vector<std::pair<int, int>> FindNeighbors(const std::pair<int, int> &);
     bool Availability(const std::pair<int, int> &);
 
+    // index-based fast access; indices of the map's own cells are never on
+    // the border, so their neighbors can be read without any check
+    int CellIndex(const std::pair<int, int> &position) const {
+        return (position.first + kPadding) * row_stride + position.second +
+               kPadding;
+    }
+    std::pair<int, int> CellPosition(const int &index) const {
+        return std::make_pair(index / row_stride - kPadding,
+                              index % row_stride - kPadding);
+    }
+    NeighborRange Neighbors(const int &index) const {
+        return NeighborRange(this, index);
+    }
+    // calls visitor(Neighbor) for each free neighbor, the loop unrolled;
+    // the cost is that of the move from the cell into the neighbor
+    template <typename Visitor>
+    void ForEachNeighbor(const int &index, Visitor &&visitor) const {
+        VisitNeighbors<false>(index, visitor,
+                              std::make_integer_sequence<int, kNeighborNum>());
+    }
+    // the same neighbors, but with the cost of the move from the neighbor
+    // into the cell, which differs when their terrains differ
+    template <typename Visitor>
+    void ForEachPredecessor(const int &index, Visitor &&visitor) const {
+        VisitNeighbors<true>(index, visitor,
+                             std::make_integer_sequence<int, kNeighborNum>());
+    }
+    Key CalculateCellKey(const int &) const;
+    Key CalculateCellKey(const int &, const double &) const;
+    CostType CurrentCellG(const int &index) const { return g[index]; }
+    CostType CurrentCellRhs(const int &index) const { return rhs[index]; }
+    Status CurrentStatusCode(const int &index) const {
+        return Blocked(index) ? kObstacle : static_cast<Status>(status[index]);
+    }
+    void UpdateCellG(const int &index, const CostType &new_g) {
+        g.Set(index, new_g);
+    }
+    void UpdateCellRhs(const int &index, const CostType &new_rhs) {
+        rhs.Set(index, new_rhs);
+    }
+    void UpdateStatusCode(const int &index, const Status &new_status) {
+        if (new_status == kObstacle && !Blocked(index))
+            OwnedObstacles().Set(index);
+        else if (new_status != kObstacle && Blocked(index))
+            OwnedObstacles().Clear(index);
+        if (new_status == kUnknown)
+            hidden.Set(index);
+        else
+            hidden.Clear(index);
+        // the obstacle grid marks obstacles, so they keep the free code and
+        // leave its page untouched
+        status.Set(index, new_status == kObstacle ? kFree : new_status);
+    }
+    bool Blocked(const int &index) const { return obstacles->Test(index); }
+    std::uint8_t CurrentTerrain(const int &index) const {
+        return terrain[index];
+    }
+    void UpdateTerrain(const int &index, const std::uint8_t &new_terrain) {
+        terrain.Set(index, new_terrain);
+    }
+    // the extra cost of entering the cell for its terrain
+    CostType TerrainCost(const int &index) const {
+        return terrain_cost[terrain[index]];
+    }
+
     // print method
-    void PrintValue();
-    void PrintResult();
+    void PrintValue() const;
+    void PrintResult() const;
 
  private:
+    bool Inside(const std::pair<int, int> &) const;
+    int CheckedIndex(const std::pair<int, int> &) const;
+    std::uint8_t StatusCode(const std::string &);
+    void Initialize();
+    OccupancyGrid &OwnedObstacles();
+    // the move lands on a free cell, and a jump passes over free cells only
+    bool Passable(const int &index, const int &slot) const {
+        return !Blocked(index + neighbor_offset[slot]) &&
+               (!Connectivity::Jumps(slot) ||
+                (!Blocked(index + pass_offset[slot]) &&
+                 !Blocked(index + neighbor_offset[slot] - pass_offset[slot])));
+    }
+    template <bool kInto, typename Visitor, int... kSlots>
+    void VisitNeighbors(const int &index, Visitor &visitor,
+                        std::integer_sequence<int, kSlots...>) const {
+        // one statement per slot, expanded at compile time
+        int expanded[] = {
+            0, (VisitNeighbor<kInto, kSlots>(index, visitor), 0)...};
+        static_cast<void>(expanded);
+    }
+    template <bool kInto, int kSlot, typename Visitor>
+    void VisitNeighbor(const int &index, Visitor &visitor) const {
+        auto neighbor = index + neighbor_offset[kSlot];
+        if (Passable(index, kSlot))
+            visitor(Neighbor{neighbor,
+                             neighbor_cost[kSlot] +
+                                 TerrainCost(kInto ? index : neighbor)});
+    }
+
     std::pair<int, int> map_size;
-    std::vector<std::vector<Cell>> grid;
+    // width of a padded row
+    int row_stride;
+    // index offset and cost of the move to each neighbor
+    std::array<int, kNeighborNum> neighbor_offset;
+    std::array<CostType, kNeighborNum> neighbor_cost;
+    // index offset of the cell sharing an edge that each jump passes over
+    std::array<int, kNeighborNum> pass_offset;
+    // per-cell values, allocated a page at a time when first written
+    PagedArray<CostType> g;
+    PagedArray<CostType> rhs;
+    PagedArray<std::uint8_t> status;
+    // terrain level of each cell, 0 for the cheapest
+    PagedArray<std::uint8_t> terrain;
+    // extra cost of entering a cell, indexed by its terrain level
+    std::array<CostType, 256> terrain_cost;
+    // one bit per cell, set for obstacles and the border; written only
+    // through OwnedObstacles, which copies it first while it is shared
+    std::shared_ptr<OccupancyGrid> obstacles;
+    bool obstacles_shared = false;
+    // one bit per cell, set for hidden obstacles
+    OccupancyGrid hidden;
+    // marks of all status codes, indexed by code
+    std::vector<std::string> status_marks;
     std::pair<int, int> goal;
+    std::pair<int, int> start;
+    // km: accumulated heuristic distance the start has moved between replans
+    double key_modifier = 0.0;
+    HeuristicFunction heuristic;
 };
 
+using Map = BasicMap<double>;
+
+extern template class BasicMap<double, FourConnected>;
+extern template class BasicMap<double, EightConnected>;
+extern template class BasicMap<double, SixteenConnected>;
+extern template class BasicMap<float, FourConnected>;
+extern template class BasicMap<float, EightConnected>;
+extern template class BasicMap<float, SixteenConnected>;
+extern template class BasicMap<FixedCost, FourConnected>;
+extern template class BasicMap<FixedCost, EightConnected>;
+extern template class BasicMap<FixedCost, SixteenConnected>;
 
 #endif  // INCLUDE_MAP_H_
 
@@ -0,0 +1,68 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file MapGenerator.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class fills maps of any size with procedural obstacles: random
+ * density, mazes, rooms and doors, and warehouse aisles. It also hides
+ * obstacles for the robot to discover. Used by the benchmark and the tests.
+ * 
+ */
+
+#ifndef INCLUDE_MAPGENERATOR_H_
+#define INCLUDE_MAPGENERATOR_H_
+
+#include <random>
+#include <string>
+#include <utility>
+#include "Map.h"
+
+class MapGenerator {
+ public:
+    explicit MapGenerator(const unsigned int &);
+
+    // obstacle layouts
+    void RandomObstacles(Map *, const double &);
+    void Maze(Map *, const int &);
+    void RoomsAndDoors(Map *, const int &, const int &);
+    void WarehouseAisles(Map *, const int &, const int &);
+    bool Generate(Map *, const std::string &);
+
+    // dynamic environment
+    void AddHiddenObstacles(Map *, const double &);
+    void ClearArea(Map *, const std::pair<int, int> &, const int &);
+
+ private:
+    void Block(Map *, const int &, const int &);
+    void Free(Map *, const int &, const int &);
+
+    std::mt19937 generator;
+};
+
+#endif  // INCLUDE_MAPGENERATOR_H_
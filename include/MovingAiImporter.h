@@ -0,0 +1,73 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file MovingAiImporter.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * These classes read the grid benchmarks of the Moving AI Lab: maps in the
+ * .map text format and their scenarios in the .scen format. Both are read
+ * as streams, one line at a time, so a large map never sits in memory as
+ * text: its rows go straight into an occupancy grid.
+ * 
+ */
+
+#ifndef INCLUDE_MOVINGAIIMPORTER_H_
+#define INCLUDE_MOVINGAIIMPORTER_H_
+
+#include <istream>
+#include <string>
+#include <utility>
+#include "OccupancyGrid.h"
+
+// One query of a .scen file; positions are (row, column).
+struct MovingAiScenario {
+    int bucket;
+    std::string map_name;
+    std::pair<int, int> map_size;
+    std::pair<int, int> start;
+    std::pair<int, int> goal;
+    double optimal_length;
+};
+
+class MovingAiImporter {
+ public:
+    static OccupancyGrid ReadMap(std::istream &);
+    static OccupancyGrid ReadMap(const std::string &);
+    static bool Passable(const char &);
+};
+
+class MovingAiScenarioReader {
+ public:
+    explicit MovingAiScenarioReader(std::istream &);
+    bool Next(MovingAiScenario *);
+
+ private:
+    std::istream &input;
+};
+
+#endif  // INCLUDE_MOVINGAIIMPORTER_H_
@@ -0,0 +1,111 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file OccupancyFeed.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class shares an occupancy grid between a perception process, which
+ * writes it, and a planner, which reads it, through a POSIX shared-memory
+ * object. Neither side copies the grid: the writer sets bits in place and
+ * the reader only looks at the tiles of 64 x 64 cells marked dirty since
+ * its last poll.
+ * The object holds a header, one bit per cell in rows of 64-bit words and
+ * one dirty bit per tile. The writer changes cells, sets the dirty bits of
+ * their tiles, then bumps a sequence counter on Publish. Poll returns at
+ * once when the counter has not moved; otherwise it takes and clears the
+ * dirty bits, compares the dirty tiles with the obstacles the map knows and
+ * returns the cells that differ as one batch for ApplyChanges. A tile
+ * written again while it is being read is marked dirty again, so the reader
+ * catches up on its next poll and never misses a change.
+ * 
+ */
+
+#ifndef INCLUDE_OCCUPANCYFEED_H_
+#define INCLUDE_OCCUPANCYFEED_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Map.h"
+#include "OccupancyGrid.h"
+
+class OccupancyFeed {
+ public:
+    // cells on each side of a tile; a row of a tile is one word
+    static constexpr int kTileSize = 64;
+
+    static OccupancyFeed Create(const std::string &, const int &,
+                                const int &);
+    static OccupancyFeed Attach(const std::string &);
+    OccupancyFeed(OccupancyFeed &&) noexcept;
+    OccupancyFeed &operator=(OccupancyFeed &&) noexcept;
+    ~OccupancyFeed();
+
+    // get method
+    std::pair<int, int> GetSize() const;
+    std::uint64_t Sequence() const;
+    bool Test(const std::pair<int, int> &) const;
+
+    // writing, by perception
+    void Set(const std::pair<int, int> &, const bool &);
+    void Publish();
+
+    // reading, by the planner
+    bool Poll(const OccupancyGrid &, std::vector<CellChange> *);
+
+ private:
+    struct Header;
+
+    OccupancyFeed() = default;
+    static OccupancyFeed MapObject(const std::string &, const int &,
+                                   const std::size_t &, const bool &);
+    void Layout(const int &, const int &);
+    void Release();
+    std::atomic<std::uint64_t> &Word(const int &, const int &) const;
+
+    std::string name;
+    // the creator removes the name when it goes away
+    bool owner = false;
+    void *base = nullptr;
+    std::size_t mapped_size = 0;
+    Header *header = nullptr;
+    std::atomic<std::uint64_t> *words = nullptr;
+    std::atomic<std::uint64_t> *dirty = nullptr;
+    int height = 0;
+    int width = 0;
+    int row_words = 0;
+    int tile_cols = 0;
+    std::size_t dirty_num = 0;
+    // the sequence of the last poll
+    std::uint64_t last_sequence = 0;
+};
+
+#endif  // INCLUDE_OCCUPANCYFEED_H_
@@ -0,0 +1,129 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file OccupancyGrid.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class holds one bit per cell of a map, for example whether the cell
+ * is an obstacle. Bits follow the map's padded row-major indices, border
+ * included, so a cell index of the map is also its bit index here. The
+ * border is one cell wide unless the connectivity of the map needs more.
+ *
+ * A grid can be saved to a compact binary file and mapped back into memory
+ * without reading or copying it: the mapping is private, so changes stay in
+ * the process and never reach the file. The file stores words in the byte
+ * order of the machine that wrote it.
+ * Window queries read a whole word of 64 cells at a time and only visit the
+ * set bits, so scanning a large sensor window costs one load per 64 cells.
+ * 
+ */
+
+#ifndef INCLUDE_OCCUPANCYGRID_H_
+#define INCLUDE_OCCUPANCYGRID_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class OccupancyGrid {
+ public:
+    OccupancyGrid(const int &, const int &, const bool &border = true,
+                  const int &padding = 1);
+    OccupancyGrid(const OccupancyGrid &);
+    OccupancyGrid(OccupancyGrid &&) noexcept;
+    OccupancyGrid &operator=(const OccupancyGrid &);
+    OccupancyGrid &operator=(OccupancyGrid &&) noexcept;
+    ~OccupancyGrid();
+
+    // file
+    static OccupancyGrid Open(const std::string &,
+                              const std::size_t &offset = 0,
+                              const bool &border = true);
+    void Save(const std::string &) const;
+    void Write(std::ostream *) const;
+
+    // get method
+    std::pair<int, int> GetSize() const;
+    int Padding() const;
+    int CellIndex(const std::pair<int, int> &position) const {
+        return (position.first + padding) * row_stride + position.second +
+               padding;
+    }
+    bool Test(const int &index) const {
+        return (words[index >> 6] >> (index & 63)) & 1u;
+    }
+    bool Test(const std::pair<int, int> &position) const {
+        return Test(CellIndex(position));
+    }
+    // the 64 bits starting at a bit index, bit k of the result being bit
+    // index + k of the grid; bits past the end read as clear
+    std::uint64_t Bits(const int &index) const {
+        std::size_t word_index = index >> 6;
+        auto shift = index & 63;
+        auto low = words[word_index] >> shift;
+        if (shift == 0 || word_index + 1 >= word_num) return low;
+        return low | (words[word_index + 1] << (64 - shift));
+    }
+    bool IsMapped() const;
+    std::size_t CountSet() const;
+    const std::uint64_t *Words() const;
+    std::size_t WordNum() const;
+    void FindSetInWindow(const std::pair<int, int> &, const int &,
+                         std::vector<int> *) const;
+
+    // set method
+    void Set(const int &index) {
+        words[index >> 6] |= std::uint64_t(1) << (index & 63);
+    }
+    void Clear(const int &index) {
+        words[index >> 6] &= ~(std::uint64_t(1) << (index & 63));
+    }
+    void SetBorder();
+
+ private:
+    OccupancyGrid() = default;
+    void Release();
+    void MarkBorder(const bool &);
+
+    int height = 0;
+    int width = 0;
+    // width of the border on each side
+    int padding = 1;
+    int row_stride = 0;
+    std::size_t word_num = 0;
+    // points into owned_words, or into the mapped file
+    std::uint64_t *words = nullptr;
+    std::vector<std::uint64_t> owned_words;
+    void *mapped_base = nullptr;
+    std::size_t mapped_size = 0;
+};
+
+#endif  // INCLUDE_OCCUPANCYGRID_H_
@@ -30,6 +30,8 @@
  * @brief D* Lite Path Planning
  *
  * This class saves candidate nodes to search in minimum heap data structure.
+ * The heap is indexed: the slot of every node is tracked, so finding,
+ * re-keying and removing a node never scan the whole list.
  * 
  */
 
@@ -42,17 +44,40 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <unordered_map>
+#include "Key.h"
+#include "PagedArray.h"
 
 class OpenList {
  public:
+    OpenList() = default;
+    explicit OpenList(const int &, const int &);
+    void Insert(const Key &, const std::pair<int, int> &);
     void Insert(const double &, const std::pair<int, int> &);
+    void UpdateKey(const Key &, const std::pair<int, int> &);
     void UpdateKey(const double &, const std::pair<int, int> &);
     void Remove(const std::pair<int, int> &);
-    std::pair<double, std::pair<int, int>> Top() const;
-    std::pair<double, std::pair<int, int>> Pop();
+    std::pair<Key, std::pair<int, int>> Top() const;
+    std::pair<Key, std::pair<int, int>> Pop();
     bool Find(const std::pair<int, int> &) const;
+    bool Empty() const;
+    std::size_t Size() const;
+    std::vector<std::pair<Key, std::pair<int, int>>> Nodes() const;
+
  private:
-    std::vector<std::tuple<double, int, int>> priority_queue;
+    int SlotOf(const std::pair<int, int> &) const;
+    void SetSlot(const std::pair<int, int> &, const int &);
+    void ClearSlot(const std::pair<int, int> &);
+    void Place(const std::tuple<Key, int, int> &, const int &);
+    void SiftUp(int);
+    void SiftDown(int);
+
+    std::vector<std::tuple<Key, int, int>> priority_queue;
+    // slot of each node in priority_queue: a paged table when the size of
+    // the map is known, a hash table otherwise
+    int grid_width = 0;
+    PagedArray<int> dense_slot;
+    std::unordered_map<long long, int> sparse_slot;
 };
 
 
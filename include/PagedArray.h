@@ -0,0 +1,179 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+/**
+ * @file PagedArray.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * An array of per-cell values that only allocates the pages written with
+ * something other than the default value. Every page starts out pointing
+ * at one shared page of defaults, so a read is always two loads and never
+ * a branch; the first write of another value into a page gives it its own
+ * memory. Pages are runs of consecutive indices, so the row-major layout
+ * and the neighbor offsets of the map stay as they are, and the memory of
+ * a search grows with the rows it touches rather than the whole map.
+ * Pages may also be borrowed from memory kept alive elsewhere, such as a
+ * mapped snapshot, and are then written in place.
+ * 
+ */
+
+#ifndef INCLUDE_PAGEDARRAY_H_
+#define INCLUDE_PAGEDARRAY_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class PagedArray {
+ public:
+    // 1024 values per page
+    static constexpr int kPageBits = 10;
+    static constexpr std::size_t kPageSize = std::size_t(1) << kPageBits;
+
+    PagedArray() = default;
+    PagedArray(const PagedArray &other) { *this = other; }
+    PagedArray(PagedArray &&other) noexcept { *this = std::move(other); }
+    ~PagedArray() { Release(); }
+    PagedArray &operator=(const PagedArray &other) {
+        if (this == &other) return *this;
+        Assign(other.size, other.default_value);
+        for (std::size_t page = 0; page < pages.size(); ++page) {
+            if (!other.Owned(page)) continue;
+            Materialize(page);
+            std::copy(other.pages[page], other.pages[page] + kPageSize,
+                      pages[page]);
+        }
+        return *this;
+    }
+    PagedArray &operator=(PagedArray &&other) noexcept {
+        if (this == &other) return *this;
+        Release();
+        size = other.size;
+        default_value = other.default_value;
+        // moving keeps the buffers, so the pointers to them stay valid
+        default_page = std::move(other.default_page);
+        pages = std::move(other.pages);
+        owned_page_num = other.owned_page_num;
+        borrowed_begin = other.borrowed_begin;
+        borrowed_end = other.borrowed_end;
+        borrowed_memory = std::move(other.borrowed_memory);
+        other.pages.clear();
+        other.owned_page_num = 0;
+        return *this;
+    }
+
+    // all values become the default; every owned page is released
+    void Assign(const std::size_t &new_size, const T &value) {
+        Release();
+        size = new_size;
+        default_value = value;
+        default_page.reset(new T[kPageSize]);
+        std::fill(default_page.get(), default_page.get() + kPageSize, value);
+        pages.assign((new_size + kPageSize - 1) >> kPageBits,
+                     default_page.get());
+    }
+    const T &operator[](const std::size_t &index) const {
+        return pages[index >> kPageBits][index & (kPageSize - 1)];
+    }
+    // writing the default value into an untouched page allocates nothing
+    void Set(const std::size_t &index, const T &value) {
+        auto page = index >> kPageBits;
+        if (!Owned(page)) {
+            if (value == default_value) return;
+            Materialize(page);
+        }
+        pages[page][index & (kPageSize - 1)] = value;
+    }
+    std::size_t Size() const { return size; }
+    // values actually allocated, a multiple of the page size
+    std::size_t AllocatedSize() const { return owned_page_num * kPageSize; }
+    // the pages holding values other than the default, in order
+    std::vector<std::uint64_t> AllocatedPages() const {
+        std::vector<std::uint64_t> page_ids;
+        for (std::size_t page = 0; page < pages.size(); ++page) {
+            if (Owned(page)) page_ids.push_back(page);
+        }
+        return page_ids;
+    }
+    const T *Page(const std::size_t &page) const { return pages[page]; }
+    // use consecutive pages of memory that memory keeps alive as the given
+    // pages, after Assign
+    void BorrowPages(const std::uint64_t *page_ids, const std::size_t &num,
+                     T *first, std::shared_ptr<void> memory) {
+        borrowed_begin = first;
+        borrowed_end = first + num * kPageSize;
+        borrowed_memory = std::move(memory);
+        for (std::size_t k = 0; k < num; ++k) {
+            if (!Owned(page_ids[k]))
+                ++owned_page_num;
+            else if (!Borrowed(page_ids[k]))
+                delete[] pages[page_ids[k]];
+            pages[page_ids[k]] = first + k * kPageSize;
+        }
+    }
+
+ private:
+    bool Owned(const std::size_t &page) const {
+        return pages[page] != default_page.get();
+    }
+    void Materialize(const std::size_t &page) {
+        pages[page] = new T[kPageSize];
+        std::copy(default_page.get(), default_page.get() + kPageSize,
+                  pages[page]);
+        ++owned_page_num;
+    }
+    bool Borrowed(const std::size_t &page) const {
+        return pages[page] >= borrowed_begin && pages[page] < borrowed_end;
+    }
+    void Release() {
+        for (std::size_t page = 0; page < pages.size(); ++page) {
+            if (Owned(page) && !Borrowed(page)) delete[] pages[page];
+        }
+        pages.clear();
+        owned_page_num = 0;
+        borrowed_begin = nullptr;
+        borrowed_end = nullptr;
+        borrowed_memory.reset();
+    }
+
+    std::size_t size = 0;
+    T default_value = T();
+    // a page of defaults shared by every page not written yet
+    std::unique_ptr<T[]> default_page;
+    // the page each index reads from: its own, or the page of defaults
+    std::vector<T *> pages;
+    std::size_t owned_page_num = 0;
+    // pages borrowed from memory that borrowed_memory keeps alive
+    T *borrowed_begin = nullptr;
+    T *borrowed_end = nullptr;
+    std::shared_ptr<void> borrowed_memory;
+};
+
+#endif  // INCLUDE_PAGEDARRAY_H_
@@ -0,0 +1,67 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file PlannerObserver.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This interface receives the events of a planner: a replan is done, the
+ * robot took a step, obstacles were discovered. A planner without an
+ * observer runs headless and does no work for events at all.
+ * PlannerObserver watches planners on a Map; planners on other map types
+ * take a BasicPlannerObserver of their own map type.
+ * 
+ */
+
+#ifndef INCLUDE_PLANNEROBSERVER_H_
+#define INCLUDE_PLANNEROBSERVER_H_
+
+#include <utility>
+#include <vector>
+#include "Map.h"
+
+template <typename MapType>
+class BasicPlannerObserver {
+ public:
+    virtual ~BasicPlannerObserver() = default;
+    virtual void OnReplan(const MapType &, const std::pair<int, int> &) {}
+    virtual void OnStep(const MapType &, const std::pair<int, int> &) {}
+    virtual void OnObstacleDiscovered(const MapType &,
+                                      const std::vector<CellChange> &) {}
+};
+
+using PlannerObserver = BasicPlannerObserver<Map>;
+
+// How often the observer hears of each kind of event: every n-th event is
+// passed on, and 0 passes none of them.
+struct ObserverOptions {
+    int replan_every = 1;
+    int step_every = 1;
+    int change_every = 1;
+};
+
+#endif  // INCLUDE_PLANNEROBSERVER_H_
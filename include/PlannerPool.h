@@ -0,0 +1,74 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file PlannerPool.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class answers many start-goal queries on one map at the same time.
+ * The obstacles are shared read-only by all queries; every query gets its
+ * own Map of search values and its own planner, run on a ThreadPool.
+ * 
+ */
+
+#ifndef INCLUDE_PLANNERPOOL_H_
+#define INCLUDE_PLANNERPOOL_H_
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include "OccupancyGrid.h"
+#include "ThreadPool.h"
+
+// A start and a goal to connect.
+struct PathQuery {
+    std::pair<int, int> start;
+    std::pair<int, int> goal;
+};
+
+// The shortest path of a query, from the start to the goal.
+struct PathResult {
+    bool reached;
+    double cost;
+    std::vector<std::pair<int, int>> path;
+};
+
+class PlannerPool {
+ public:
+    PlannerPool(std::shared_ptr<const OccupancyGrid>, const int &);
+
+    std::vector<PathResult> Solve(const std::vector<PathQuery> &);
+    static PathResult SolveOne(const std::shared_ptr<const OccupancyGrid> &,
+                               const PathQuery &);
+    int ThreadNum() const;
+
+ private:
+    std::shared_ptr<const OccupancyGrid> base;
+    ThreadPool thread_pool;
+};
+
+#endif  // INCLUDE_PLANNERPOOL_H_
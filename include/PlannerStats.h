@@ -0,0 +1,108 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file PlannerStats.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Counters and histograms that tell what the planner did in each replan.
+ * They are only collected when the library is built with DSTARLITE_STATS;
+ * otherwise every counting statement compiles to nothing and all values
+ * stay zero.
+ * 
+ */
+
+#ifndef INCLUDE_PLANNERSTATS_H_
+#define INCLUDE_PLANNERSTATS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef DSTARLITE_STATS
+#define DSTARLITE_STAT(statement) statement
+#else
+#define DSTARLITE_STAT(statement)
+#endif
+
+// Histogram with power-of-two buckets: bucket 0 holds values below 1,
+// bucket k holds values in [2^(k-1), 2^k).
+class Log2Histogram {
+ public:
+    static const int kBucketNum = 40;
+
+    void Record(const double &);
+    std::uint64_t Count() const;
+    double Mean() const;
+    double Max() const;
+    double Percentile(const double &) const;
+    const std::array<std::uint64_t, kBucketNum> &Buckets() const;
+    std::string ToJson() const;
+
+ private:
+    std::array<std::uint64_t, kBucketNum> buckets = {};
+    std::uint64_t count = 0;
+    double total = 0.0;
+    double max = 0.0;
+};
+
+struct PlannerStats {
+    // search
+    std::uint64_t replans = 0;
+    std::uint64_t expansions = 0;
+    std::uint64_t overconsistent_expansions = 0;
+    std::uint64_t underconsistent_expansions = 0;
+    std::uint64_t stale_key_expansions = 0;
+    std::uint64_t update_vertex_calls = 0;
+    std::uint64_t neighbor_scans = 0;
+
+    // open list
+    std::uint64_t openlist_inserts = 0;
+    std::uint64_t openlist_removes = 0;
+    std::uint64_t openlist_updates = 0;
+    std::size_t max_openlist_size = 0;
+
+    // changes of the map
+    std::uint64_t change_batches = 0;
+    std::uint64_t changed_cells = 0;
+    // nodes affected by several changes of a batch but updated once
+    std::uint64_t duplicate_vertices = 0;
+
+    // the last replan
+    std::uint64_t last_replan_expansions = 0;
+    std::uint64_t last_replan_touched_cells = 0;
+
+    // per replan and per batch of changes
+    Log2Histogram replan_latency_us;
+    Log2Histogram change_batch_latency_us;
+    Log2Histogram touched_cells_per_replan;
+
+    std::string ToJson() const;
+};
+
+#endif  // INCLUDE_PLANNERSTATS_H_
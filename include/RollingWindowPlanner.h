@@ -0,0 +1,114 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+/**
+ * @file RollingWindowPlanner.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class plans in a window of fixed size that follows the robot over
+ * an unbounded world. Positions are world positions and may be negative.
+ * What the robot learnt about the cells of the window is kept in a ring
+ * buffer indexed by world position modulo the size of the window, so when
+ * the window moves, the cells leaving it are recycled for the cells coming
+ * in without moving any other cell. The window recenters on the robot once
+ * it comes within a quarter of the window of an edge; its search is then
+ * rebuilt, and D* Lite repairs it incrementally until the next recenter.
+ * A goal outside the window is reached through the free cells on the edge
+ * of the window, each with a frontier cost to the goal. An edge cell that
+ * was inside the window before it moved keeps the cost the old search gave
+ * it, which remembers the obstacles the window has since dropped; a new
+ * cell gets the octile distance, as cells outside are assumed free.
+ * Memory depends on the size of the window only, however far the robot
+ * travels.
+ * 
+ */
+
+#ifndef INCLUDE_ROLLINGWINDOWPLANNER_H_
+#define INCLUDE_ROLLINGWINDOWPLANNER_H_
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "DStarLitePlanner.h"
+#include "Map.h"
+#include "Robot.h"
+
+class RollingWindowPlanner {
+ public:
+    RollingWindowPlanner(const int &, const int &);
+
+    // planning
+    void Initialize(const std::pair<int, int> &, const std::pair<int, int> &);
+    void ComputeShortestPath();
+
+    // moving and sensing
+    void MoveStart(const std::pair<int, int> &);
+    bool ApplyChanges(const std::vector<CellChange> &);
+
+    // next-move query
+    std::pair<int, int> NextMove();
+
+    // get method
+    std::pair<int, int> CurrentStart() const;
+    std::pair<int, int> GetGoal() const;
+    std::pair<int, int> Origin() const;
+    bool InWindow(const std::pair<int, int> &) const;
+    bool KnownObstacle(const std::pair<int, int> &) const;
+    int RecenterNum() const;
+    const Map &Window() const;
+
+ private:
+    int Slot(const std::pair<int, int> &) const;
+    void Recenter();
+    void Rebuild();
+    std::pair<int, int> ToWindow(const std::pair<int, int> &) const;
+    std::pair<int, int> ToWorld(const std::pair<int, int> &) const;
+    void CarryFrontier(const std::pair<int, int> &);
+    bool EdgeCell(const std::pair<int, int> &) const;
+
+    int height;
+    int width;
+    // cells the robot keeps from the edges before the window recenters
+    int margin;
+    // world position of the top-left cell of the window
+    std::pair<int, int> origin;
+    // one byte per cell of the window, set for known obstacles
+    std::vector<std::uint8_t> known;
+    Robot robot;
+    std::pair<int, int> goal;
+    std::unique_ptr<Map> window_map;
+    std::unique_ptr<DStarLitePlanner> planner;
+    // cost from the goal of the window to the real goal
+    double goal_offset = 0.0;
+    // costs of edge cells carried over from the last window, by position
+    std::vector<FrontierCost> carried;
+    // the search must be rebuilt before the next query
+    bool stale = true;
+    int recenter_num = 0;
+};
+
+#endif  // INCLUDE_ROLLINGWINDOWPLANNER_H_
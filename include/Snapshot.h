@@ -0,0 +1,215 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file Snapshot.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * A snapshot is a binary file holding the whole state of a planner: the
+ * obstacle and hidden grids, the pages of g-values, rhs-values, status codes
+ * and terrain written so far, the open list, the goal, the start and km.
+ * Restoring it resumes the search where it stopped instead of planning
+ * again from scratch.
+ * Sections follow a fixed header at offsets aligned to a cache line; the
+ * grids are complete grid files (see OccupancyGrid.h) at offsets aligned to
+ * a memory page, so they are mapped in place. The reader maps the whole
+ * file privately and the paged arrays of the map borrow their pages from
+ * the mapping: loading copies nothing per cell, and pages are only read
+ * from disk when the search touches them. Like grid files, snapshots are
+ * in the byte order of the machine that wrote them; the header records the
+ * cost type and the connectivity of the map, which must match on load.
+ * 
+ */
+
+#ifndef INCLUDE_SNAPSHOT_H_
+#define INCLUDE_SNAPSHOT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "OccupancyGrid.h"
+#include "PagedArray.h"
+
+// fixed-size header at the start of a snapshot
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t header_size;
+    // type of the map
+    std::uint32_t cost_size;
+    std::uint32_t cost_is_integer;
+    std::int32_t neighbor_num;
+    std::int32_t padding;
+    std::int32_t height;
+    std::int32_t width;
+    // state of the map
+    std::int32_t goal[2];
+    std::int32_t map_start[2];
+    double key_modifier;
+    // state of the planner
+    std::int32_t planner_start[2];
+    std::int32_t sensor_radius;
+    // 1 if the last search finished; 0, the safe reading, in older files
+    std::uint32_t converged;
+    // offsets of the sections, and their lengths in records
+    std::uint64_t obstacles_offset;
+    std::uint64_t hidden_offset;
+    std::uint64_t g_offset;
+    std::uint64_t rhs_offset;
+    std::uint64_t status_offset;
+    std::uint64_t terrain_offset;
+    std::uint64_t marks_offset;
+    std::uint64_t marks_size;
+    std::uint64_t open_offset;
+    std::uint64_t open_num;
+    std::uint64_t robots_offset;
+    std::uint64_t robot_num;
+    std::uint64_t frontier_offset;
+    std::uint64_t frontier_num;
+    std::uint8_t reserved[64];
+};
+static_assert(sizeof(SnapshotHeader) == 256, "unexpected header layout");
+
+// a node of the open list
+struct SnapshotNode {
+    double key[2];
+    std::int32_t position[2];
+    std::uint64_t reserved;
+};
+static_assert(sizeof(SnapshotNode) == 32, "unexpected node layout");
+
+// a frontier cell and its cost to the goal
+struct SnapshotFrontier {
+    double cost;
+    std::int32_t position[2];
+};
+static_assert(sizeof(SnapshotFrontier) == 16, "unexpected frontier layout");
+
+class SnapshotWriter {
+ public:
+    explicit SnapshotWriter(const std::string &);
+    SnapshotHeader &Header();
+    std::uint64_t Append(const void *, const std::size_t &,
+                         const std::size_t &alignment = 64);
+    std::uint64_t AppendGrid(const OccupancyGrid &);
+    template <typename T>
+    std::uint64_t AppendPages(const PagedArray<T> &);
+    void Finish();
+
+ private:
+    void Align(const std::size_t &);
+
+    // the snapshot is written next to the path and renamed over it by
+    // Finish, so an interrupted write never leaves a broken file behind
+    std::string path;
+    std::string temporary_path;
+    std::ofstream file;
+    SnapshotHeader header;
+    std::uint64_t offset = 0;
+};
+
+class SnapshotReader {
+ public:
+    explicit SnapshotReader(const std::string &);
+    const SnapshotHeader &Header() const;
+    const std::string &Path() const;
+    template <typename T>
+    T *At(const std::uint64_t &, const std::uint64_t &) const;
+    template <typename T>
+    void BorrowPages(const std::uint64_t &, PagedArray<T> *) const;
+
+ private:
+    std::string path;
+    // the private mapping of the whole file
+    std::shared_ptr<void> memory;
+    std::size_t size = 0;
+    SnapshotHeader header;
+};
+
+/**
+ * @brief Append the allocated pages of a paged array: their number, the
+ *        offset of the first one, their indices, then the pages themselves.
+ * @param values the paged array
+ * @return the offset of the section
+ */
+template <typename T>
+std::uint64_t SnapshotWriter::AppendPages(const PagedArray<T> &values) {
+    auto page_ids = values.AllocatedPages();
+    Align(64);
+    std::uint64_t head[2] = {page_ids.size(), 0};
+    auto section = offset;
+    head[1] = (section + sizeof(head) + page_ids.size() * 8 + 63) / 64 * 64;
+    Append(head, sizeof(head));
+    Append(page_ids.data(), page_ids.size() * 8, 8);
+    for (auto const &page : page_ids)
+        Append(values.Page(page), PagedArray<T>::kPageSize * sizeof(T));
+    return section;
+}
+
+/**
+ * @brief Get the records of a section of the mapping, checking that they
+ *        lie inside the file.
+ * @param record_offset where the records start
+ * @param num the number of records
+ * @return the first record
+ */
+template <typename T>
+T *SnapshotReader::At(const std::uint64_t &record_offset,
+                      const std::uint64_t &num) const {
+    if (record_offset % alignof(T) != 0 || record_offset > size ||
+        num > (size - record_offset) / sizeof(T))
+        throw std::runtime_error("Snapshot: corrupt section in " + path);
+    return reinterpret_cast<T *>(static_cast<char *>(memory.get()) +
+                                 record_offset);
+}
+
+/**
+ * @brief Let a paged array, already sized, use the pages of a section in
+ *        place. The array keeps the mapping alive.
+ * @param section the offset of the section written by AppendPages
+ * @param values the paged array
+ * @return none
+ */
+template <typename T>
+void SnapshotReader::BorrowPages(const std::uint64_t &section,
+                                 PagedArray<T> *values) const {
+    auto head = At<std::uint64_t>(section, 2);
+    auto page_ids = At<std::uint64_t>(section + 16, head[0]);
+    auto page_num = (values->Size() + PagedArray<T>::kPageSize - 1) /
+                    PagedArray<T>::kPageSize;
+    for (std::uint64_t k = 0; k < head[0]; ++k) {
+        if (page_ids[k] >= page_num)
+            throw std::runtime_error("Snapshot: corrupt pages in " + path);
+    }
+    auto first = At<T>(head[1], head[0] * PagedArray<T>::kPageSize);
+    values->BorrowPages(page_ids, head[0], first, memory);
+}
+
+#endif  // INCLUDE_SNAPSHOT_H_
@@ -0,0 +1,94 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file ThreadPool.h
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * This class runs tasks on a fixed number of threads. Every thread has its
+ * own queue: it takes its newest task first and, once its queue is empty,
+ * steals the oldest task of another thread, so uneven tasks still keep all
+ * threads busy. Each queue has its own lock and the counters are atomic;
+ * the pool's mutex is only taken to sleep and to wake a sleeping thread.
+ * 
+ */
+
+#ifndef INCLUDE_THREADPOOL_H_
+#define INCLUDE_THREADPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+ public:
+    explicit ThreadPool(const int &);
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ~ThreadPool();
+
+    void Submit(const std::function<void()> &);
+    void Wait();
+    int ThreadNum() const;
+
+ private:
+    struct TaskQueue {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+    };
+
+    void Run(const int &);
+    bool ClaimTask();
+    std::function<void()> TakeTask(const int &);
+
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    std::vector<std::thread> threads;
+    // tasks in the queues, not yet claimed by a thread
+    std::atomic<std::size_t> queued_num{0};
+    // tasks submitted and not yet finished
+    std::atomic<std::size_t> unfinished_num{0};
+    std::atomic<std::size_t> next_queue{0};
+    // threads asleep or about to sleep; only then is a wake-up needed
+    std::atomic<int> idle_num{0};
+    // guards sleeping and waking, and stopping
+    std::mutex state_mutex;
+    std::condition_variable task_ready;
+    std::condition_variable all_done;
+    bool stopping = false;
+    // the first exception thrown by a task, rethrown by Wait
+    std::mutex error_mutex;
+    std::exception_ptr first_error;
+};
+
+#endif  // INCLUDE_THREADPOOL_H_
@@ -0,0 +1,200 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+/**
+ * @file AnytimeDStarPlannerTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for the "AnytimeDStarPlanner" class
+ * 
+ */
+
+#include "AnytimeDStarPlanner.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "DStarLitePlanner.h"
+#include "MapGenerator.h"
+
+namespace {
+const std::pair<int, int> kStart = std::make_pair(2, 2);
+const std::pair<int, int> kGoal = std::make_pair(57, 55);
+
+void BuildMap(Map *map_ptr) {
+    MapGenerator generator(7);
+    generator.RandomObstacles(map_ptr, 0.3);
+    generator.ClearArea(map_ptr, kStart, 1);
+    generator.ClearArea(map_ptr, kGoal, 1);
+    map_ptr->SetStart(kStart);
+    map_ptr->SetGoal(kGoal);
+}
+
+// cost of the shortest path on the same map with the changes applied
+double OptimalCost(const std::vector<CellChange> &changes,
+                   const std::pair<int, int> &start) {
+    Map map_test(60, 60);
+    BuildMap(&map_test);
+    DStarLitePlanner planner_test(&map_test);
+    planner_test.ApplyChanges(changes);
+    planner_test.Initialize();
+    planner_test.MoveStart(start);
+    planner_test.ComputeShortestPath();
+    return map_test.CurrentCellG(start);
+}
+
+// cost of the path found by following the smallest cost plus g-value
+double FollowedCost(const Map &map_test, std::pair<int, int> position) {
+    double cost = 0.0;
+    for (int step = 0; step < 1000 && position != map_test.GetGoal();
+         ++step) {
+        auto next_index = -1;
+        auto next_cost = std::numeric_limits<double>::infinity();
+        auto move_cost = 0.0;
+        map_test.ForEachNeighbor(
+            map_test.CellIndex(position), [&](const Map::Neighbor &neighbor) {
+                auto total = neighbor.cost +
+                             map_test.CurrentCellG(neighbor.index);
+                if (total < next_cost) {
+                    next_cost = total;
+                    next_index = neighbor.index;
+                    move_cost = neighbor.cost;
+                }
+            });
+        if (next_index < 0) break;
+        cost += move_cost;
+        position = map_test.CellPosition(next_index);
+    }
+    if (position != map_test.GetGoal())
+        return std::numeric_limits<double>::infinity();
+    return cost;
+}
+}  // namespace
+
+TEST(AnytimeDStarPlannerTest, testEachPassWithinEpsilon) {
+    auto optimal_cost = OptimalCost({}, kStart);
+    ASSERT_LT(optimal_cost, std::numeric_limits<double>::infinity());
+
+    Map map_test(60, 60);
+    BuildMap(&map_test);
+    AnytimeDStarPlanner planner_test(&map_test);
+    planner_test.Initialize();
+    EXPECT_EQ(planner_test.Epsilon(), std::numeric_limits<double>::infinity());
+    while (planner_test.ImprovePath()) {
+        auto epsilon = planner_test.Epsilon();
+        auto path_cost = planner_test.Iterations().back().path_cost;
+        EXPECT_GE(path_cost, optimal_cost - 1e-9);
+        EXPECT_LE(path_cost, epsilon * optimal_cost + 1e-9);
+        EXPECT_LE(FollowedCost(map_test, kStart),
+                  epsilon * optimal_cost + 1e-9);
+    }
+    EXPECT_TRUE(planner_test.Optimal());
+    EXPECT_FALSE(planner_test.ImprovePath());
+
+    auto const &iterations = planner_test.Iterations();
+    auto const &schedule = planner_test.EpsilonSchedule();
+    ASSERT_EQ(iterations.size(), schedule.size());
+    for (std::size_t i = 0; i < iterations.size(); ++i)
+        EXPECT_EQ(iterations[i].epsilon, schedule[i]);
+    EXPECT_DOUBLE_EQ(iterations.back().path_cost, optimal_cost);
+    EXPECT_DOUBLE_EQ(FollowedCost(map_test, kStart), optimal_cost);
+
+    // The inflated first pass expands fewer cells than an optimal search
+    Map optimal_map(60, 60);
+    BuildMap(&optimal_map);
+    AnytimeDStarPlanner optimal_planner(&optimal_map);
+    optimal_planner.SetEpsilonSchedule({1.0});
+    optimal_planner.Initialize();
+    optimal_planner.ComputeShortestPath();
+    ASSERT_EQ(optimal_planner.Iterations().size(), 1u);
+    EXPECT_DOUBLE_EQ(optimal_planner.Iterations()[0].path_cost, optimal_cost);
+    EXPECT_LT(iterations[0].expansions,
+              optimal_planner.Iterations()[0].expansions);
+}
+
+TEST(AnytimeDStarPlannerTest, testRepairAfterChanges) {
+    Map map_test(60, 60);
+    BuildMap(&map_test);
+    AnytimeDStarPlanner planner_test(&map_test);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+    ASSERT_TRUE(planner_test.Optimal());
+
+    // Move along the path, then wall off part of the way
+    for (int i = 0; i < 5; ++i)
+        planner_test.MoveStart(planner_test.NextMove());
+    auto start = planner_test.CurrentStart();
+    EXPECT_FALSE(planner_test.Optimal());
+    std::vector<CellChange> changes;
+    for (int row = 10; row < 50; ++row) {
+        auto cell = std::make_pair(row, 30);
+        if (!map_test.Blocked(map_test.CellIndex(cell)))
+            changes.push_back({cell, true});
+    }
+    EXPECT_TRUE(planner_test.ApplyChanges(changes));
+    EXPECT_FALSE(planner_test.ApplyChanges(changes));
+    EXPECT_EQ(planner_test.Epsilon(), std::numeric_limits<double>::infinity());
+
+    auto optimal_cost = OptimalCost(changes, start);
+    ASSERT_TRUE(planner_test.ImprovePath());
+    auto const &schedule = planner_test.EpsilonSchedule();
+    EXPECT_EQ(planner_test.Epsilon(), schedule.front());
+    EXPECT_LE(planner_test.Iterations().back().path_cost,
+              schedule.front() * optimal_cost + 1e-9);
+    planner_test.ComputeShortestPath();
+    EXPECT_TRUE(planner_test.Optimal());
+    EXPECT_DOUBLE_EQ(map_test.CurrentCellG(start), optimal_cost);
+    EXPECT_DOUBLE_EQ(FollowedCost(map_test, start), optimal_cost);
+}
+
+TEST(AnytimeDStarPlannerTest, testDeadlineRunsOnePass) {
+    Map map_test(60, 60);
+    BuildMap(&map_test);
+    AnytimeDStarPlanner planner_test(&map_test);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath(std::chrono::steady_clock::now());
+    EXPECT_EQ(planner_test.Iterations().size(), 1u);
+    EXPECT_NE(planner_test.NextMove(), kStart);
+    planner_test.ComputeShortestPath(
+        std::chrono::steady_clock::time_point::max());
+    EXPECT_TRUE(planner_test.Optimal());
+}
+
+TEST(AnytimeDStarPlannerTest, testScheduleValidation) {
+    Map map_test(10, 10);
+    AnytimeDStarPlanner planner_test(&map_test);
+    EXPECT_THROW(planner_test.SetEpsilonSchedule({}), std::invalid_argument);
+    EXPECT_THROW(planner_test.SetEpsilonSchedule({2.0, 1.5}),
+                 std::invalid_argument);
+    EXPECT_THROW(planner_test.SetEpsilonSchedule({2.0, 3.0, 1.0}),
+                 std::invalid_argument);
+    EXPECT_THROW(planner_test.SetEpsilonSchedule({2.0, 2.0, 1.0}),
+                 std::invalid_argument);
+    planner_test.SetEpsilonSchedule({4.0, 1.0});
+    EXPECT_EQ(planner_test.EpsilonSchedule(), std::vector<double>({4.0, 1.0}));
+}
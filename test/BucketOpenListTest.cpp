@@ -0,0 +1,185 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file BucketOpenListTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for the "BucketOpenList" class
+ * 
+ */
+
+#include "BucketOpenList.h"
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <vector>
+#include "DStarLitePlanner.h"
+#include "OpenList.h"
+
+TEST(BucketOpenListTest, testBucketOpenList) {
+    BucketOpenList openlist_test;
+    auto first_node = std::make_pair(3, 2);
+    auto second_node = std::make_pair(4, 5);
+    auto third_node = std::make_pair(6, 0);
+    openlist_test.Insert(0.7, first_node);
+    openlist_test.Insert(1.5, second_node);
+    openlist_test.Insert(0.5, third_node);
+
+    EXPECT_EQ(openlist_test.Top().second, third_node);
+    EXPECT_EQ(openlist_test.Pop().second, third_node);
+    EXPECT_EQ(openlist_test.Top().second, first_node);
+    openlist_test.UpdateKey(3.3, first_node);
+    EXPECT_EQ(openlist_test.Top().second, second_node);
+    EXPECT_FALSE(openlist_test.Find(third_node));
+    EXPECT_TRUE(openlist_test.Find(first_node));
+
+    // a key below the top moves the cursor back down, and keys that are
+    // too large or not finite still come out last
+    openlist_test.Insert(std::numeric_limits<double>::infinity(),
+                         third_node);
+    openlist_test.Insert(1.0e9, std::make_pair(7, 7));
+    openlist_test.UpdateKey(0.0, first_node);
+    EXPECT_EQ(openlist_test.Pop().second, first_node);
+    EXPECT_EQ(openlist_test.Pop().second, second_node);
+    EXPECT_EQ(openlist_test.Pop().second, std::make_pair(7, 7));
+    EXPECT_EQ(openlist_test.Pop().second, third_node);
+    EXPECT_TRUE(openlist_test.Empty());
+}
+
+TEST(BucketOpenListTest, testOverflowKeysAllocateNoBuckets) {
+    BucketOpenList openlist_test;
+    auto limit = 1.0 * BucketOpenList::kMaxBucketNum /
+                 BucketOpenList::kResolution;
+    openlist_test.Insert(limit, std::make_pair(1, 1));
+    openlist_test.Insert(std::numeric_limits<double>::infinity(),
+                         std::make_pair(2, 2));
+    openlist_test.Insert(limit * 4, std::make_pair(3, 3));
+    // keys past the limit only fill the overflow heap, kept in order
+    EXPECT_EQ(openlist_test.BucketNum(), 0u);
+    EXPECT_EQ(openlist_test.Top().second, std::make_pair(1, 1));
+
+    // a regular key comes out first and only allocates the buckets below it
+    openlist_test.Insert(2.5, std::make_pair(4, 4));
+    EXPECT_EQ(openlist_test.BucketNum(), 6u);
+    EXPECT_EQ(openlist_test.Pop().second, std::make_pair(4, 4));
+    EXPECT_EQ(openlist_test.Pop().second, std::make_pair(1, 1));
+
+    // a node re-keyed out of the overflow heap comes back to the buckets
+    openlist_test.UpdateKey(1.0, std::make_pair(2, 2));
+    EXPECT_EQ(openlist_test.Pop().second, std::make_pair(2, 2));
+    EXPECT_EQ(openlist_test.Pop().second, std::make_pair(3, 3));
+    EXPECT_TRUE(openlist_test.Empty());
+    EXPECT_EQ(openlist_test.BucketNum(), 6u);
+}
+
+TEST(BucketOpenListTest, testMatchesBinaryHeap) {
+    // random inserts, re-keys up and down and removes, dense and sparse
+    std::mt19937 generator(1515);
+    std::uniform_int_distribution<int> coordinate(0, 19);
+    std::uniform_int_distribution<int> half_cost(0, 120);
+    std::uniform_int_distribution<int> operation(0, 9);
+    for (int dense = 0; dense < 2; ++dense) {
+        OpenList heap_test;
+        BucketOpenList bucket_test;
+        if (dense == 1) {
+            heap_test = OpenList(20, 20);
+            bucket_test = BucketOpenList(20, 20);
+        }
+        for (int step = 0; step < 5000; ++step) {
+            auto node = std::make_pair(coordinate(generator),
+                                       coordinate(generator));
+            auto cost = 0.5 * half_cost(generator);
+            auto key = std::make_pair(cost + 0.5 * half_cost(generator),
+                                      cost);
+            auto kind = operation(generator);
+            if (kind < 5) {
+                heap_test.Insert(key, node);
+                bucket_test.Insert(key, node);
+            } else if (kind < 7) {
+                heap_test.UpdateKey(key, node);
+                bucket_test.UpdateKey(key, node);
+            } else if (kind < 9) {
+                heap_test.Remove(node);
+                bucket_test.Remove(node);
+            } else if (!heap_test.Empty()) {
+                ASSERT_EQ(bucket_test.Pop(), heap_test.Pop());
+            }
+            ASSERT_EQ(bucket_test.Size(), heap_test.Size());
+            ASSERT_EQ(bucket_test.Find(node), heap_test.Find(node));
+            if (!heap_test.Empty()) {
+                ASSERT_EQ(bucket_test.Top(), heap_test.Top());
+            }
+        }
+        while (!heap_test.Empty()) {
+            ASSERT_EQ(bucket_test.Pop(), heap_test.Pop());
+        }
+        EXPECT_TRUE(bucket_test.Empty());
+    }
+}
+
+TEST(BucketOpenListTest, testPlannerMatchesBinaryHeap) {
+    // the same walk through the same changes with either open list
+    std::mt19937 generator(2015);
+    std::uniform_int_distribution<int> coordinate(0, 15);
+    auto goal = std::make_pair(0, 0);
+    Map heap_map(16, 16);
+    Map bucket_map(16, 16);
+    for (auto map_ptr : {&heap_map, &bucket_map}) {
+        map_ptr->SetGoal(goal);
+        map_ptr->SetStart(std::make_pair(15, 15));
+    }
+    DStarLitePlanner heap_planner(&heap_map);
+    BucketDStarLitePlanner bucket_planner(&bucket_map);
+    heap_planner.Initialize();
+    bucket_planner.Initialize();
+    heap_planner.ComputeShortestPath();
+    bucket_planner.ComputeShortestPath();
+
+    for (int step = 0; step < 40; ++step) {
+        if (heap_planner.CurrentStart() == goal) break;
+        std::vector<CellChange> changes;
+        for (int i = 0; i < 3; ++i) {
+            auto cell = std::make_pair(coordinate(generator),
+                                       coordinate(generator));
+            if (cell == goal || cell == heap_planner.CurrentStart()) continue;
+            changes.push_back(CellChange{cell, step % 4 != 3});
+        }
+        heap_planner.ApplyChanges(changes);
+        bucket_planner.ApplyChanges(changes);
+        heap_planner.MoveStart(heap_planner.NextMove());
+        bucket_planner.MoveStart(bucket_planner.NextMove());
+        ASSERT_EQ(bucket_planner.CurrentStart(), heap_planner.CurrentStart());
+        auto start = heap_planner.CurrentStart();
+        EXPECT_EQ(bucket_map.CurrentCellG(start),
+                  heap_map.CurrentCellG(start));
+    }
+#ifdef DSTARLITE_STATS
+    EXPECT_EQ(bucket_planner.Stats().expansions,
+              heap_planner.Stats().expansions);
+#endif
+}
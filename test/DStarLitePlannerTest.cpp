@@ -0,0 +1,475 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file DStarLitePlannerTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for the "DStarLitePlanner" class
+ * 
+ */
+
+#include "DStarLitePlanner.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+TEST(DStarLitePlannerTest, testPlannerDemo) {
+    // the map of the demo
+    Map map_test(4, 5);
+    std::vector<std::pair<int, int>> obstacles_for_test = {
+        std::make_pair(1, 1), std::make_pair(0, 2), std::make_pair(1, 2)};
+    std::vector<std::pair<int, int>> unknown_for_test = {std::make_pair(2, 2)};
+    map_test.AddObstacle(obstacles_for_test, unknown_for_test);
+    map_test.SetGoal(std::make_pair(0, 0));
+    map_test.SetStart(std::make_pair(2, 4));
+
+    DStarLitePlanner planner_test(&map_test);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(map_test.CurrentCellG(std::make_pair(2, 4)), 6.0);
+
+    // the robot discovers the hidden obstacle after the first step
+    auto next_position = planner_test.NextMove();
+    EXPECT_EQ(next_position, std::make_pair(2, 3));
+    planner_test.MoveStart(next_position);
+    EXPECT_TRUE(planner_test.DetectHiddenObstacle(next_position));
+    EXPECT_FALSE(planner_test.DetectHiddenObstacle(next_position));
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(map_test.CurrentCellG(next_position), 7.0);
+    EXPECT_EQ(map_test.CurrentCellG(std::make_pair(2, 2)),
+              map_test.infinity_cost);
+    EXPECT_FALSE(planner_test.CurrentOpenList().Find(std::make_pair(2, 2)));
+
+    // the rest of the path reaches the goal
+    int steps = 0;
+    while (planner_test.CurrentStart() != map_test.GetGoal() && steps < 20) {
+        planner_test.MoveStart(planner_test.NextMove());
+        ++steps;
+    }
+    EXPECT_EQ(planner_test.CurrentStart(), map_test.GetGoal());
+    EXPECT_EQ(steps, 7);
+}
+
+TEST(DStarLitePlannerTest, testPlannerRepairMatchesFreshSearch) {
+    std::mt19937 generator(808);
+    std::uniform_int_distribution<int> coordinate(0, 11);
+    auto goal = std::make_pair(0, 0);
+    auto start = std::make_pair(11, 11);
+
+    Map map_test(12, 12);
+    map_test.SetGoal(goal);
+    map_test.SetStart(start);
+    DStarLitePlanner planner_test(&map_test);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+
+    for (int round = 0; round < 20; ++round) {
+        // block and free a few cells, keeping the goal and the start free
+        std::vector<CellChange> changes;
+        for (int i = 0; i < 4; ++i) {
+            auto cell = std::make_pair(coordinate(generator),
+                                       coordinate(generator));
+            if (cell == goal || cell == start) continue;
+            changes.push_back(CellChange{cell, round % 3 != 2});
+        }
+        planner_test.ApplyChanges(changes);
+        planner_test.ComputeShortestPath();
+
+        // a search from scratch on the same map gives the same cost
+        Map fresh_map(12, 12);
+        for (int i = 0; i < 12; ++i) {
+            for (int j = 0; j < 12; ++j) {
+                auto cell = std::make_pair(i, j);
+                if (map_test.Blocked(map_test.CellIndex(cell)))
+                    fresh_map.UpdateStatusCode(fresh_map.CellIndex(cell),
+                                               Map::kObstacle);
+            }
+        }
+        fresh_map.SetGoal(goal);
+        fresh_map.SetStart(start);
+        DStarLitePlanner fresh_planner(&fresh_map);
+        fresh_planner.Initialize();
+        fresh_planner.ComputeShortestPath();
+        EXPECT_EQ(map_test.CurrentCellG(start), fresh_map.CurrentCellG(start));
+    }
+}
+
+namespace {
+// the cost from the start to the goal of a search from scratch on the
+// obstacles and the terrain of the given map
+double FreshSearchCost(Map *map_ptr) {
+    auto size = map_ptr->GetSize();
+    Map fresh_map(size.first, size.second);
+    for (int i = 0; i < size.first; ++i) {
+        for (int j = 0; j < size.second; ++j) {
+            auto index = map_ptr->CellIndex(std::make_pair(i, j));
+            if (map_ptr->Blocked(index))
+                fresh_map.UpdateStatusCode(index, Map::kObstacle);
+            fresh_map.UpdateTerrain(index, map_ptr->CurrentTerrain(index));
+        }
+    }
+    fresh_map.SetGoal(map_ptr->GetGoal());
+    fresh_map.SetStart(map_ptr->GetStart());
+    DStarLitePlanner fresh_planner(&fresh_map);
+    fresh_planner.Initialize();
+    fresh_planner.ComputeShortestPath();
+    return fresh_map.CurrentCellG(map_ptr->GetStart());
+}
+}  // namespace
+
+TEST(DStarLitePlannerTest, testSensorRadiusBatch) {
+    // a wall of hidden obstacles across the path, three cells from the robot
+    Map map_test(15, 15);
+    std::vector<std::pair<int, int>> unknown_for_test;
+    for (int j = 3; j < 15; ++j) unknown_for_test.push_back({10, j});
+    map_test.AddObstacle({}, unknown_for_test);
+    auto start = std::make_pair(7, 8);
+    map_test.SetGoal(std::make_pair(14, 14));
+    map_test.SetStart(start);
+
+    DStarLitePlanner planner_test(&map_test);
+    EXPECT_EQ(planner_test.SensorRadius(), 1);
+    EXPECT_THROW(planner_test.SetSensorRadius(-1), std::invalid_argument);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+    EXPECT_FALSE(planner_test.DetectHiddenObstacle(start));
+    planner_test.SetSensorRadius(3);
+    EXPECT_TRUE(planner_test.DetectHiddenObstacle(start));
+    // only the seven cells of the wall inside the window are found
+    EXPECT_EQ(map_test.Hidden().CountSet(), 5u);
+    EXPECT_EQ(map_test.CurrentCellStatus(std::make_pair(10, 11)), "x");
+    EXPECT_EQ(map_test.CurrentCellStatus(std::make_pair(10, 12)), "?");
+    planner_test.ComputeShortestPath();
+#ifdef DSTARLITE_STATS
+    EXPECT_EQ(planner_test.Stats().changed_cells, 7u);
+    EXPECT_GT(planner_test.Stats().duplicate_vertices, 0u);
+#endif
+    EXPECT_EQ(map_test.CurrentCellG(start), FreshSearchCost(&map_test));
+
+    // a batch that frees and blocks neighboring cells at once
+    std::vector<CellChange> changes = {
+        {{10, 5}, false}, {{10, 6}, false}, {{9, 6}, true}, {{11, 5}, true},
+        {{9, 9}, true}, {{10, 10}, false}, {{8, 9}, true}};
+    EXPECT_TRUE(planner_test.ApplyChanges(changes));
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(map_test.CurrentCellG(start), FreshSearchCost(&map_test));
+}
+
+TEST(DStarLitePlannerTest, testTerrainRepairMatchesFreshSearch) {
+    // a slow band across the straight way makes the robot go around it
+    Map map_test(12, 12);
+    auto start = std::make_pair(0, 5);
+    map_test.SetGoal(std::make_pair(11, 5));
+    map_test.SetStart(start);
+    DStarLitePlanner planner_test(&map_test);
+    EXPECT_THROW(planner_test.UpdateRegionTerrain({0, 0}, {1, 1}, 256),
+                 std::invalid_argument);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(map_test.CurrentCellG(start), 11.0);
+    EXPECT_TRUE(planner_test.UpdateRegionTerrain({6, -3}, {5, 10}, 40));
+    EXPECT_FALSE(planner_test.UpdateRegionTerrain({5, 0}, {6, 10}, 40));
+    planner_test.ComputeShortestPath();
+    // six columns over to the free column, eleven rows down and back
+    EXPECT_EQ(map_test.CurrentCellG(start), 6 + 11 + 6.0);
+    EXPECT_EQ(map_test.CurrentCellG(start), FreshSearchCost(&map_test));
+    EXPECT_EQ(map_test.CurrentCellTerrain(std::make_pair(5, 10)), 40);
+    EXPECT_GT(planner_test.NextMove().second, start.second);
+
+    // a change far from the path only touches the cells around it
+    planner_test.ResetStats();
+    EXPECT_TRUE(planner_test.ApplyTerrainChanges({{{11, 0}, 8}}));
+    planner_test.ComputeShortestPath();
+#ifdef DSTARLITE_STATS
+    EXPECT_LE(planner_test.Stats().update_vertex_calls, 3u);
+#endif
+
+    // random congestion rising and falling, with the goal's neighbors too
+    std::mt19937 generator(18);
+    std::uniform_int_distribution<int> cell(0, 11);
+    std::uniform_int_distribution<int> level(0, 12);
+    for (int round = 0; round < 30; ++round) {
+        auto corner = std::make_pair(cell(generator), cell(generator));
+        auto opposite_corner = std::make_pair(corner.first + 2,
+                                              corner.second + 3);
+        planner_test.UpdateRegionTerrain(corner, opposite_corner,
+                                         level(generator));
+        if (round % 5 == 4)
+            planner_test.ApplyChanges({{{cell(generator), 3}, true}});
+        planner_test.ComputeShortestPath();
+        EXPECT_EQ(map_test.CurrentCellG(start), FreshSearchCost(&map_test));
+    }
+}
+
+TEST(DStarLitePlannerTest, testFrontierCosts) {
+    // a way out on the far side of a wall costs less than going around it
+    Map map_test(6, 6);
+    std::vector<std::pair<int, int>> obstacles_for_test;
+    for (int i = 0; i < 5; ++i) obstacles_for_test.push_back({i, 2});
+    map_test.AddObstacle(obstacles_for_test, {});
+    map_test.SetGoal(std::make_pair(0, 3));
+    map_test.SetStart(std::make_pair(0, 0));
+    DStarLitePlanner planner_test(&map_test);
+    planner_test.SetFrontier({{{0, 0}, 10.0}, {{3, 0}, 0.5}, {{4, 2}, 0.0}});
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(map_test.CurrentCellG(std::make_pair(0, 0)), 3.5);
+    EXPECT_EQ(planner_test.NextMove(), std::make_pair(1, 0));
+
+    // blocking the frontier cell leaves the way around the wall
+    planner_test.ApplyChanges({{{3, 0}, true}});
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(map_test.CurrentCellG(std::make_pair(0, 0)), 10.0);
+}
+
+TEST(DStarLitePlannerTest, testFleetSharesOneSearch) {
+    // robots in every corner of a map with a wall, heading to the center
+    Map map_test(20, 20);
+    std::vector<std::pair<int, int>> obstacles_for_test;
+    for (int j = 2; j < 18; ++j) obstacles_for_test.push_back({6, j});
+    map_test.AddObstacle(obstacles_for_test, {});
+    map_test.SetGoal(std::make_pair(10, 10));
+    map_test.SetStart(std::make_pair(0, 0));
+    map_test.SetHeuristic([](const std::pair<int, int> &,
+                             const std::pair<int, int> &) { return 0.0; });
+
+    DStarLitePlanner planner_test(&map_test);
+    std::vector<std::pair<int, int>> positions = {
+        {0, 0}, {0, 19}, {19, 0}, {19, 19}, {3, 10}};
+    for (auto const &position : positions) planner_test.AddRobot(position);
+    EXPECT_EQ(planner_test.RobotNum(), 5);
+    EXPECT_THROW(planner_test.RobotPosition(5), std::out_of_range);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+
+    // every robot's cell holds its cost to the goal
+    for (auto const &position : positions) {
+        map_test.SetStart(position);
+        EXPECT_EQ(map_test.CurrentCellG(position), FreshSearchCost(&map_test));
+    }
+    map_test.SetStart(std::make_pair(0, 0));
+
+    // all robots walk to the goal, replanning once when the wall grows
+    for (int step = 0; step < 40; ++step) {
+        if (step == 3) {
+            planner_test.ApplyChanges({{{6, 1}, true}, {{6, 18}, true}});
+            planner_test.ComputeShortestPath();
+        }
+        auto next_positions = planner_test.NextMoves();
+        for (int id = 0; id < planner_test.RobotNum(); ++id)
+            planner_test.MoveRobot(id, next_positions[id]);
+    }
+    for (int id = 0; id < planner_test.RobotNum(); ++id)
+        EXPECT_EQ(planner_test.RobotPosition(id), map_test.GetGoal());
+}
+
+namespace {
+// the cost from the start to the goal of a map with a long wall, searched
+// on a map of the given type
+template <typename MapType>
+double LongPathCost() {
+    MapType map_test(120, 120);
+    std::vector<std::pair<int, int>> obstacles_for_test;
+    for (int i = 0; i < 119; ++i) obstacles_for_test.push_back({i, 60});
+    map_test.AddObstacle(obstacles_for_test, {});
+    map_test.SetGoal(std::make_pair(0, 119));
+    map_test.SetStart(std::make_pair(0, 0));
+    BasicDStarLitePlanner<OpenList, MapType> planner_test(&map_test);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+    return map_test.CurrentCellG(map_test.GetStart());
+}
+}  // namespace
+
+TEST(DStarLitePlannerTest, testLongPathWithCostTypes) {
+    // down, across and up around the wall; far beyond the old ceiling of 100
+    auto expected_cost = 3 * 119 * 1.0;
+    EXPECT_EQ(LongPathCost<Map>(), expected_cost);
+    EXPECT_EQ(LongPathCost<BasicMap<float>>(), expected_cost);
+    EXPECT_EQ(LongPathCost<BasicMap<FixedCost>>(), expected_cost);
+}
+
+TEST(DStarLitePlannerTest, testLongPathWithConnectivity) {
+    // four neighbors take the same way around the wall
+    auto around_cost = 3 * 119 * 1.0;
+    EXPECT_EQ((LongPathCost<BasicMap<double, FourConnected>>()), around_cost);
+    EXPECT_EQ((LongPathCost<BasicMap<FixedCost, FourConnected>>()),
+              around_cost);
+
+    // a knight move never jumps the wall, but it is shorter than the moves
+    // it passes over, so sixteen neighbors go around mostly by knight moves
+    auto knight_cost = 117 * SixteenConnected::kKnightCost + 6 * 1.0;
+    EXPECT_EQ((LongPathCost<BasicMap<double, SixteenConnected>>()),
+              knight_cost);
+    EXPECT_EQ((LongPathCost<BasicMap<float, SixteenConnected>>()),
+              knight_cost);
+    EXPECT_EQ((LongPathCost<BasicMap<FixedCost, SixteenConnected>>()),
+              knight_cost);
+    EXPECT_LT(knight_cost, around_cost);
+}
+
+TEST(DStarLitePlannerTest, testKnightMoveNeverJumpsWall) {
+    using SixteenMap = BasicMap<double, SixteenConnected>;
+    SixteenMap map_test(10, 10);
+    std::vector<std::pair<int, int>> wall;
+    for (int i = 0; i < 10; ++i) wall.push_back({i, 5});
+    map_test.AddObstacle(wall, {});
+    map_test.SetGoal(std::make_pair(0, 9));
+    map_test.SetStart(std::make_pair(0, 0));
+    BasicDStarLitePlanner<OpenList, SixteenMap> planner_test(&map_test);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(map_test.CurrentCellG(map_test.GetStart()),
+              map_test.infinity_cost);
+    EXPECT_EQ(map_test.ComputeCost({3, 4}, {4, 6}), map_test.infinity_cost);
+
+    // Opening two cells of the wall opens the knight moves over them too
+    planner_test.ApplyChanges({{std::make_pair(3, 5), false}});
+    EXPECT_EQ(map_test.ComputeCost({3, 4}, {4, 6}), map_test.infinity_cost);
+    planner_test.ApplyChanges({{std::make_pair(4, 5), false}});
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(map_test.ComputeCost({3, 4}, {4, 6}),
+              SixteenConnected::kKnightCost + 0.0);
+    EXPECT_EQ(map_test.CurrentCellG(map_test.GetStart()),
+              4 * SixteenConnected::kKnightCost + 3);
+}
+
+namespace {
+// the cost from the start to the goal through a gap of two cells in a wall,
+// searched on a map of the given type
+template <typename MapType>
+double GapPathCost() {
+    MapType map_test(10, 10);
+    std::vector<std::pair<int, int>> wall;
+    for (int i = 0; i < 10; ++i)
+        if (i != 3 && i != 4) wall.push_back({i, 5});
+    map_test.AddObstacle(wall, {});
+    map_test.SetGoal(std::make_pair(0, 9));
+    map_test.SetStart(std::make_pair(0, 0));
+    BasicDStarLitePlanner<OpenList, MapType> planner_test(&map_test);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+    return map_test.CurrentCellG(map_test.GetStart());
+}
+}  // namespace
+
+TEST(DStarLitePlannerTest, testSixteenConnectedBeatsEightConnected) {
+    // eight neighbors walk down to the gap and back up in transitional
+    // steps; sixteen neighbors cover most of the way in knight moves
+    auto eight_cost = GapPathCost<BasicMap<double, EightConnected>>();
+    auto sixteen_cost = GapPathCost<BasicMap<double, SixteenConnected>>();
+    EXPECT_EQ(eight_cost, 15.0);
+    EXPECT_EQ(sixteen_cost, 4 * SixteenConnected::kKnightCost + 3);
+    EXPECT_LT(sixteen_cost, eight_cost);
+    EXPECT_EQ((GapPathCost<BasicMap<FixedCost, SixteenConnected>>()),
+              sixteen_cost);
+}
+
+TEST(DStarLitePlannerTest, testSixteenConnectedRepairMatchesFreshSearch) {
+    using SixteenMap = BasicMap<double, SixteenConnected>;
+    std::mt19937 generator(17);
+    std::uniform_int_distribution<int> cell(0, 29);
+    SixteenMap map_test(30, 30);
+    map_test.SetGoal(std::make_pair(29, 29));
+    map_test.SetStart(std::make_pair(0, 0));
+    BasicDStarLitePlanner<OpenList, SixteenMap> planner_test(&map_test);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+
+    // block and free cells, then compare the repair with a search from
+    // scratch; the knight moves reach cells two rows or columns away
+    for (int round = 0; round < 10; ++round) {
+        std::vector<CellChange> changes;
+        for (int i = 0; i < 30; ++i) {
+            auto position = std::make_pair(cell(generator), cell(generator));
+            if (position == map_test.GetStart() ||
+                position == map_test.GetGoal())
+                continue;
+            changes.push_back(CellChange{position, round % 3 != 2});
+        }
+        planner_test.ApplyChanges(changes);
+        planner_test.ComputeShortestPath();
+
+        SixteenMap fresh_map(map_test.SharedOccupancy());
+        fresh_map.SetGoal(map_test.GetGoal());
+        fresh_map.SetStart(map_test.GetStart());
+        BasicDStarLitePlanner<OpenList, SixteenMap> fresh_planner(&fresh_map);
+        fresh_planner.Initialize();
+        fresh_planner.ComputeShortestPath();
+        EXPECT_EQ(map_test.CurrentCellG(map_test.GetStart()),
+                  fresh_map.CurrentCellG(fresh_map.GetStart()));
+    }
+}
+
+TEST(DStarLitePlannerTest, testBudgetedSearchResumes) {
+    // a long wall appears right after the first plan
+    Map map_test(60, 60);
+    map_test.SetGoal(std::make_pair(0, 0));
+    map_test.SetStart(std::make_pair(59, 59));
+    DStarLitePlanner planner_test(&map_test);
+    planner_test.Initialize();
+    EXPECT_EQ(planner_test.ComputeShortestPath(SearchBudget()),
+              SearchStatus::kConverged);
+    std::vector<CellChange> changes;
+    for (int j = 0; j < 59; ++j)
+        changes.push_back(CellChange{std::make_pair(30, j), true});
+    planner_test.ApplyChanges(changes);
+
+    // a handful of expansions per call, with a free next move meanwhile
+    SearchBudget budget;
+    budget.max_expansions = 50;
+    int partial_calls = 0;
+    while (planner_test.ComputeShortestPath(budget) ==
+           SearchStatus::kPartial) {
+        ++partial_calls;
+        EXPECT_FALSE(planner_test.Converged());
+        auto next_position = planner_test.NextMove();
+        EXPECT_TRUE(map_test.Availability(next_position));
+        EXPECT_NE(next_position, planner_test.CurrentStart());
+        ASSERT_LT(partial_calls, 10000);
+    }
+    EXPECT_GT(partial_calls, 5);
+    EXPECT_TRUE(planner_test.Converged());
+    EXPECT_EQ(map_test.CurrentCellG(map_test.GetStart()),
+              FreshSearchCost(&map_test));
+
+    // a deadline already past still makes progress on every call
+    planner_test.ApplyChanges({CellChange{std::make_pair(30, 59), true},
+                               CellChange{std::make_pair(30, 0), false}});
+    budget = SearchBudget();
+    budget.deadline = std::chrono::steady_clock::now();
+    partial_calls = 0;
+    while (planner_test.ComputeShortestPath(budget) ==
+           SearchStatus::kPartial)
+        ASSERT_LT(++partial_calls, 10000);
+    EXPECT_GT(partial_calls, 0);
+    EXPECT_EQ(map_test.CurrentCellG(map_test.GetStart()),
+              FreshSearchCost(&map_test));
+}
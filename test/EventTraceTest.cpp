@@ -0,0 +1,191 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file EventTraceTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for the "EventTrace" class and ReplayTrace
+ * 
+ */
+
+#include "EventTrace.h"
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "DStarLitePlanner.h"
+
+namespace {
+const char kTrace[] =
+    "# a wall appears and opens again\n"
+    "dstarlite-trace 1\n"
+    "size 20 20\n"
+    "goal 0 0\n"
+    "start 19 19\n"
+    "100 pose 18 18\n"
+    "100 block 10 0 10 1 10 2 10 3 10 4 10 5 10 6 10 7 10 8 10 9\n"
+    "100 block 10 10 10 11 10 12 10 13 10 14 10 15 10 16 10 17 10 18\n"
+    "250 pose 17 17\n"
+    "900 free 10 0\n"
+    "900 block 12 12\r\n"
+    "1200 pose 16 16\n";
+
+EventTrace ReadString(const std::string &text) {
+    std::istringstream input(text);
+    return EventTrace::Read(input);
+}
+}  // namespace
+
+TEST(EventTraceTest, testReadAndWrite) {
+    auto trace = ReadString(kTrace);
+    EXPECT_EQ(trace.map_size, std::make_pair(20, 20));
+    EXPECT_TRUE(trace.map_file.empty());
+    EXPECT_EQ(trace.goal, std::make_pair(0, 0));
+    EXPECT_EQ(trace.start, std::make_pair(19, 19));
+    ASSERT_EQ(trace.events.size(), 4u);
+    EXPECT_EQ(trace.events[0].time_us, 100);
+    EXPECT_TRUE(trace.events[0].moved);
+    EXPECT_EQ(trace.events[0].changes.size(), 19u);
+    EXPECT_FALSE(trace.events[2].moved);
+    ASSERT_EQ(trace.events[2].changes.size(), 2u);
+    EXPECT_FALSE(trace.events[2].changes[0].blocked);
+    EXPECT_TRUE(trace.events[2].changes[1].blocked);
+    EXPECT_EQ(trace.events[3].pose, std::make_pair(16, 16));
+
+    // writing and reading again gives the same trace
+    std::ostringstream output;
+    trace.Write(output);
+    auto again = ReadString(output.str());
+    ASSERT_EQ(again.events.size(), trace.events.size());
+    for (std::size_t k = 0; k < trace.events.size(); ++k) {
+        EXPECT_EQ(again.events[k].time_us, trace.events[k].time_us);
+        EXPECT_EQ(again.events[k].moved, trace.events[k].moved);
+        EXPECT_EQ(again.events[k].pose, trace.events[k].pose);
+        ASSERT_EQ(again.events[k].changes.size(),
+                  trace.events[k].changes.size());
+        for (std::size_t c = 0; c < trace.events[k].changes.size(); ++c) {
+            EXPECT_EQ(again.events[k].changes[c].position,
+                      trace.events[k].changes[c].position);
+            EXPECT_EQ(again.events[k].changes[c].blocked,
+                      trace.events[k].changes[c].blocked);
+        }
+    }
+}
+
+TEST(EventTraceTest, testRejectsBadTraces) {
+    const std::string header =
+        "dstarlite-trace 1\nsize 5 5\ngoal 0 0\nstart 4 4\n";
+    EXPECT_THROW(ReadString("dstarlite-trace 2\n"), std::runtime_error);
+    EXPECT_THROW(ReadString("size 5 5\n"), std::runtime_error);
+    EXPECT_THROW(ReadString("dstarlite-trace 1\nsize 5 5\n"),
+                 std::runtime_error);
+    EXPECT_THROW(ReadString("dstarlite-trace 1\nsize 5 5\n1 pose 1 1\n"),
+                 std::runtime_error);
+    EXPECT_THROW(ReadString(header + "1 pose 5 1\n"), std::runtime_error);
+    EXPECT_THROW(ReadString(header + "1 block\n"), std::runtime_error);
+    EXPECT_THROW(ReadString(header + "1 block 1 1 2\n"), std::runtime_error);
+    EXPECT_THROW(ReadString(header + "1 pose 1 1 1\n"), std::runtime_error);
+    EXPECT_THROW(ReadString(header + "1 jump 1 1\n"), std::runtime_error);
+    EXPECT_THROW(ReadString(header + "5 pose 1 1\n2 pose 1 2\n"),
+                 std::runtime_error);
+    EXPECT_THROW(ReadString(header + "5x pose 1 1\n"), std::runtime_error);
+    EXPECT_NO_THROW(ReadString(header + "# only a comment\n"));
+    EXPECT_THROW(EventTrace::Read("/tmp/missing.trace"), std::runtime_error);
+}
+
+TEST(EventTraceTest, testReplay) {
+    auto trace = ReadString(kTrace);
+    Map map_test(trace.LoadObstacles());
+    DStarLitePlanner planner_test(&map_test);
+    auto records = ReplayTrace(trace, &planner_test, &map_test);
+    ASSERT_EQ(records.size(), 4u);
+    EXPECT_EQ(records[0].time_us, 100);
+    EXPECT_EQ(records[0].changed_cells, 19u);
+    EXPECT_GE(records[0].latency_us, 0.0);
+#ifdef DSTARLITE_STATS
+    EXPECT_GT(records[0].expansions, 0u);
+#endif
+    EXPECT_EQ(planner_test.CurrentStart(), std::make_pair(16, 16));
+    EXPECT_FALSE(map_test.Availability(std::make_pair(12, 12)));
+
+    // the same cost as a planner that replays it with another open list,
+    // and as a search from scratch at the end
+    Map bucket_map(trace.LoadObstacles());
+    BucketDStarLitePlanner bucket_planner(&bucket_map);
+    auto bucket_records = ReplayTrace(trace, &bucket_planner, &bucket_map);
+    for (std::size_t k = 0; k < records.size(); ++k)
+        EXPECT_EQ(bucket_records[k].path_cost, records[k].path_cost);
+    Map fresh_map(20, 20);
+    for (int i = 0; i < 20; ++i) {
+        for (int j = 0; j < 20; ++j) {
+            auto cell = std::make_pair(i, j);
+            if (!map_test.Availability(cell))
+                fresh_map.UpdateCellStatus(cell, "x");
+        }
+    }
+    fresh_map.SetGoal(std::make_pair(0, 0));
+    fresh_map.SetStart(std::make_pair(16, 16));
+    DStarLitePlanner fresh_planner(&fresh_map);
+    fresh_planner.Initialize();
+    fresh_planner.ComputeShortestPath();
+    EXPECT_EQ(records.back().path_cost,
+              fresh_map.CurrentCellG(std::make_pair(16, 16)));
+}
+
+TEST(EventTraceTest, testMapFileNextToTrace) {
+    auto directory = "/tmp/trace-" + std::to_string(getpid());
+    ASSERT_EQ(mkdir(directory.c_str(), 0700), 0);
+    {
+        std::ofstream map_file(directory + "/room.map");
+        map_file << "type octile\nheight 3\nwidth 4\nmap\n"
+                 << "....\n.@@.\n....\n";
+        std::ofstream trace_file(directory + "/walk.trace");
+        trace_file << "dstarlite-trace 1\nsize 3 4\nmap room.map\n"
+                   << "goal 0 0\nstart 2 3\n10 free 1 1\n";
+    }
+    auto trace = EventTrace::Read(directory + "/walk.trace");
+    EXPECT_EQ(trace.map_file, directory + "/room.map");
+    Map map_test(trace.LoadObstacles());
+    EXPECT_FALSE(map_test.Availability(std::make_pair(1, 1)));
+    DStarLitePlanner planner_test(&map_test);
+    auto records = ReplayTrace(trace, &planner_test, &map_test);
+    ASSERT_EQ(records.size(), 1u);
+    EXPECT_TRUE(map_test.Availability(std::make_pair(1, 1)));
+    EXPECT_FALSE(map_test.Availability(std::make_pair(1, 2)));
+
+    trace.map_size = std::make_pair(4, 4);
+    EXPECT_THROW(trace.LoadObstacles(), std::runtime_error);
+    std::remove((directory + "/room.map").c_str());
+    std::remove((directory + "/walk.trace").c_str());
+    rmdir(directory.c_str());
+}
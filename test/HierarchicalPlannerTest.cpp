@@ -0,0 +1,264 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file HierarchicalPlannerTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for the "HierarchicalPlanner" class
+ * 
+ */
+
+#include "HierarchicalPlanner.h"
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "DStarLitePlanner.h"
+#include "MapGenerator.h"
+
+namespace {
+// the cost of the flat D* Lite search on the same map
+double FlatCost(const Map &map_source) {
+    Map flat_map = map_source;
+    DStarLitePlanner flat_planner(&flat_map);
+    flat_planner.Initialize();
+    flat_planner.ComputeShortestPath();
+    return flat_map.CurrentCellG(flat_map.GetStart());
+}
+
+// check that a path only steps between neighboring free cells
+void ExpectValidPath(Map *map_ptr,
+                     const std::vector<std::pair<int, int>> &path) {
+    for (std::size_t i = 0; i < path.size(); ++i) {
+        EXPECT_TRUE(map_ptr->Availability(path[i]));
+        if (i == 0) continue;
+        EXPECT_LE(std::abs(path[i].first - path[i - 1].first), 1);
+        EXPECT_LE(std::abs(path[i].second - path[i - 1].second), 1);
+        EXPECT_NE(path[i], path[i - 1]);
+    }
+}
+}  // namespace
+
+TEST(HierarchicalPlannerTest, testPathCloseToFlatSearch) {
+    Map map_test(30, 30);
+    MapGenerator generator_test(5);
+    generator_test.RandomObstacles(&map_test, 0.2);
+    generator_test.ClearArea(&map_test, std::make_pair(2, 1), 1);
+    generator_test.ClearArea(&map_test, std::make_pair(27, 26), 1);
+    map_test.SetGoal(std::make_pair(27, 26));
+    map_test.SetStart(std::make_pair(2, 1));
+    auto flat_cost = FlatCost(map_test);
+    ASSERT_LT(flat_cost, map_test.infinity_cost);
+
+    EXPECT_THROW(HierarchicalPlanner(&map_test, 1), std::invalid_argument);
+    HierarchicalPlanner planner_test(&map_test, 8);
+    EXPECT_EQ(planner_test.ClusterSize(), 8);
+    planner_test.Initialize();
+    EXPECT_GT(planner_test.AbstractNodeNum(), 2u);
+    planner_test.ComputeShortestPath();
+
+    // entrances only add detours
+    EXPECT_GE(planner_test.PathCost(), flat_cost);
+    EXPECT_LE(planner_test.PathCost(), flat_cost * 1.3);
+    auto abstract_path = planner_test.AbstractPath();
+    EXPECT_EQ(abstract_path.front(), map_test.GetStart());
+    EXPECT_EQ(abstract_path.back(), map_test.GetGoal());
+    auto path = planner_test.RefinePath();
+    EXPECT_EQ(path.front(), map_test.GetStart());
+    EXPECT_EQ(path.back(), map_test.GetGoal());
+    ExpectValidPath(&map_test, path);
+}
+
+TEST(HierarchicalPlannerTest, testRepairMatchesRebuild) {
+    Map map_test(40, 40);
+    MapGenerator generator_test(9);
+    generator_test.RoomsAndDoors(&map_test, 9, 2);
+    auto start = std::make_pair(1, 1);
+    auto goal = std::make_pair(38, 37);
+    generator_test.ClearArea(&map_test, start, 0);
+    generator_test.ClearArea(&map_test, goal, 0);
+    map_test.SetGoal(goal);
+    map_test.SetStart(start);
+    HierarchicalPlanner planner_test(&map_test, 10);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+
+    std::mt19937 random_engine(14);
+    std::uniform_int_distribution<int> coordinate(0, 39);
+    for (int round = 0; round < 15; ++round) {
+        std::vector<CellChange> changes;
+        for (int i = 0; i < 6; ++i) {
+            auto cell = std::make_pair(coordinate(random_engine),
+                                       coordinate(random_engine));
+            if (cell == start || cell == goal) continue;
+            changes.push_back(CellChange{cell, round % 3 != 2});
+        }
+        planner_test.ApplyChanges(changes);
+        EXPECT_LE(planner_test.LastRepairedClusterNum(), 6 * 4);
+        planner_test.ComputeShortestPath();
+
+        // the same abstraction built from scratch gives the same cost
+        HierarchicalPlanner fresh_planner(&map_test, 10);
+        fresh_planner.Initialize();
+        fresh_planner.ComputeShortestPath();
+        EXPECT_EQ(planner_test.PathCost(), fresh_planner.PathCost());
+        EXPECT_EQ(planner_test.AbstractNodeNum(),
+                  fresh_planner.AbstractNodeNum());
+    }
+    EXPECT_FALSE(planner_test.ApplyChanges({}));
+    EXPECT_EQ(planner_test.LastRepairedClusterNum(), 0);
+}
+
+TEST(HierarchicalPlannerTest, testDiagonalCrossingBetweenClusters) {
+    // the only way out of the upper-left cluster is the diagonal move from
+    // (3, 3) to (4, 4), through the corner where four clusters meet
+    Map map_test(8, 8);
+    std::vector<std::pair<int, int>> walls;
+    for (int i = 0; i < 4; ++i) {
+        walls.push_back(std::make_pair(4, i));
+        walls.push_back(std::make_pair(i, 4));
+    }
+    map_test.AddObstacle(walls, {});
+    auto start = std::make_pair(0, 0);
+    auto goal = std::make_pair(7, 7);
+    map_test.SetGoal(goal);
+    map_test.SetStart(start);
+    auto flat_cost = FlatCost(map_test);
+    EXPECT_EQ(flat_cost, 6 + 2.5 + 6);
+
+    HierarchicalPlanner planner_test(&map_test, 4);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(planner_test.PathCost(), flat_cost);
+    EXPECT_NE(planner_test.NextMove(), start);
+    auto path = planner_test.RefinePath();
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(path.back(), goal);
+    ExpectValidPath(&map_test, path);
+
+    // A free cell beside the corner takes over the crossing, and blocking
+    // it brings the diagonal one back
+    planner_test.ApplyChanges({CellChange{std::make_pair(3, 4), false}});
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(planner_test.PathCost(), FlatCost(map_test));
+    planner_test.ApplyChanges({CellChange{std::make_pair(3, 4), true}});
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(planner_test.PathCost(), flat_cost);
+
+    // Crossings inside a border are found too: a wall with a diagonal gap
+    // between the two upper clusters
+    Map border_map(4, 8);
+    border_map.AddObstacle({{0, 3}, {1, 3}, {2, 4}, {3, 4}}, {});
+    border_map.SetGoal(std::make_pair(0, 7));
+    border_map.SetStart(std::make_pair(0, 0));
+    HierarchicalPlanner border_planner(&border_map, 4);
+    border_planner.Initialize();
+    border_planner.ComputeShortestPath();
+    EXPECT_EQ(border_planner.PathCost(), FlatCost(border_map));
+    EXPECT_LT(border_planner.PathCost(), map_test.infinity_cost);
+
+    // Blocking the corner leaves no way at all
+    planner_test.ApplyChanges({CellChange{std::make_pair(4, 4), true}});
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(planner_test.PathCost(), map_test.infinity_cost);
+}
+
+TEST(HierarchicalPlannerTest, testTerrainCostsMatchRefinedPath) {
+    Map map_test(24, 24);
+    MapGenerator generator_test(11);
+    generator_test.RandomObstacles(&map_test, 0.1);
+    auto start = std::make_pair(1, 2);
+    auto goal = std::make_pair(22, 21);
+    generator_test.ClearArea(&map_test, start, 1);
+    generator_test.ClearArea(&map_test, goal, 1);
+    map_test.SetGoal(goal);
+    map_test.SetStart(start);
+    for (int row = 4; row < 20; ++row) {
+        for (int col = 6; col < 14; ++col)
+            map_test.UpdateCellTerrain(std::make_pair(row, col), row % 5);
+    }
+
+    // the cached costs are those of the moves the refined path takes
+    auto refined_cost = [&map_test](HierarchicalPlanner *planner_ptr) {
+        auto path = planner_ptr->RefinePath();
+        double cost = 0.0;
+        for (std::size_t i = 1; i < path.size(); ++i)
+            cost += map_test.ComputeCost(path[i - 1], path[i]);
+        return cost;
+    };
+    HierarchicalPlanner planner_test(&map_test, 6);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+    EXPECT_DOUBLE_EQ(planner_test.PathCost(), refined_cost(&planner_test));
+    EXPECT_GE(planner_test.PathCost(), FlatCost(map_test));
+
+    // A slow band across the way is repaired like a rebuild
+    std::vector<TerrainChange> changes;
+    for (int col = 0; col < 24; ++col)
+        changes.push_back(TerrainChange{std::make_pair(12, col), 20});
+    EXPECT_TRUE(planner_test.ApplyTerrainChanges(changes));
+    EXPECT_FALSE(planner_test.ApplyTerrainChanges(changes));
+    planner_test.ComputeShortestPath();
+    HierarchicalPlanner fresh_planner(&map_test, 6);
+    fresh_planner.Initialize();
+    fresh_planner.ComputeShortestPath();
+    EXPECT_DOUBLE_EQ(planner_test.PathCost(), fresh_planner.PathCost());
+    EXPECT_DOUBLE_EQ(planner_test.PathCost(), refined_cost(&planner_test));
+    EXPECT_GE(planner_test.PathCost(), FlatCost(map_test));
+}
+
+TEST(HierarchicalPlannerTest, testWalkWithHiddenObstacles) {
+    Map map_test(36, 36);
+    MapGenerator generator_test(3);
+    generator_test.WarehouseAisles(&map_test, 8, 3);
+    generator_test.AddHiddenObstacles(&map_test, 0.1);
+    auto start = std::make_pair(0, 0);
+    auto goal = std::make_pair(35, 35);
+    generator_test.ClearArea(&map_test, start, 1);
+    generator_test.ClearArea(&map_test, goal, 1);
+    map_test.SetGoal(goal);
+    map_test.SetStart(start);
+
+    HierarchicalPlanner planner_test(&map_test, 9);
+    planner_test.SetSensorRadius(2);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+    std::vector<std::pair<int, int>> walked = {start};
+    for (int step = 0; step < 300 && planner_test.CurrentStart() != goal;
+         ++step) {
+        auto next_position = planner_test.NextMove();
+        ASSERT_NE(next_position, planner_test.CurrentStart());
+        planner_test.MoveStart(next_position);
+        walked.push_back(next_position);
+        planner_test.DetectHiddenObstacle(next_position);
+        planner_test.ComputeShortestPath();
+    }
+    EXPECT_EQ(planner_test.CurrentStart(), goal);
+    ExpectValidPath(&map_test, walked);
+}
@@ -0,0 +1,114 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file MapGeneratorTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for the "MapGenerator" class
+ * 
+ */
+
+#include "MapGenerator.h"
+#include <gtest/gtest.h>
+#include <queue>
+#include <vector>
+
+namespace {
+// count free cells and the free cells reachable from the top-left corner
+std::pair<int, int> CountFreeAndReachable(Map *map_ptr) {
+    auto size = map_ptr->GetSize();
+    int free_num = 0;
+    for (int i = 0; i < size.first; ++i) {
+        for (int j = 0; j < size.second; ++j) {
+            if (map_ptr->Availability(std::make_pair(i, j))) ++free_num;
+        }
+    }
+    std::vector<bool> visited(size.first * size.second, false);
+    std::queue<std::pair<int, int>> frontier;
+    frontier.push(std::make_pair(0, 0));
+    visited[0] = true;
+    int reachable_num = 0;
+    while (!frontier.empty()) {
+        auto cell = frontier.front();
+        frontier.pop();
+        ++reachable_num;
+        for (auto const &next : map_ptr->FindNeighbors(cell)) {
+            if (visited[next.first * size.second + next.second]) continue;
+            visited[next.first * size.second + next.second] = true;
+            frontier.push(next);
+        }
+    }
+    return std::make_pair(free_num, reachable_num);
+}
+}  // namespace
+
+TEST(MapGeneratorTest, testMazeIsConnected) {
+    Map map_test(41, 53);
+    MapGenerator generator_test(7);
+    generator_test.Maze(&map_test, 2);
+    auto count = CountFreeAndReachable(&map_test);
+    EXPECT_GT(count.first, 41 * 53 / 3);
+    EXPECT_EQ(count.first, count.second);
+}
+
+TEST(MapGeneratorTest, testLayouts) {
+    // rooms: walls on every eleventh row and column, opened by doors
+    Map rooms_map(32, 32);
+    MapGenerator generator_test(11);
+    generator_test.RoomsAndDoors(&rooms_map, 10, 2);
+    EXPECT_TRUE(rooms_map.Availability(std::make_pair(5, 5)));
+    EXPECT_FALSE(rooms_map.Availability(std::make_pair(10, 10)));
+    auto count = CountFreeAndReachable(&rooms_map);
+    EXPECT_EQ(count.first, count.second);
+
+    // warehouse: shelves two cells deep between aisles three cells wide
+    Map warehouse_map(20, 30);
+    generator_test.WarehouseAisles(&warehouse_map, 5, 3);
+    EXPECT_TRUE(warehouse_map.Availability(std::make_pair(2, 4)));
+    EXPECT_FALSE(warehouse_map.Availability(std::make_pair(3, 4)));
+    EXPECT_FALSE(warehouse_map.Availability(std::make_pair(4, 7)));
+    EXPECT_TRUE(warehouse_map.Availability(std::make_pair(4, 8)));
+
+    // random obstacles and hidden obstacles only on free cells
+    Map random_map(100, 100);
+    EXPECT_TRUE(generator_test.Generate(&random_map, "random"));
+    EXPECT_FALSE(generator_test.Generate(&random_map, "volcano"));
+    auto free_num = CountFreeAndReachable(&random_map).first;
+    EXPECT_NEAR(free_num, 7500, 300);
+    generator_test.AddHiddenObstacles(&random_map, 1.0);
+    int hidden_num = 0;
+    for (int i = 0; i < 100; ++i) {
+        for (int j = 0; j < 100; ++j) {
+            if (random_map.CurrentStatusCode(random_map.CellIndex(
+                std::make_pair(i, j))) == Map::kUnknown) ++hidden_num;
+        }
+    }
+    EXPECT_EQ(hidden_num, free_num);
+    generator_test.ClearArea(&random_map, std::make_pair(0, 0), 1);
+    EXPECT_EQ(random_map.CurrentCellStatus(std::make_pair(1, 1)), " ");
+}
@@ -36,6 +36,8 @@
 #include "Map.h"
 #include "Cell.h"
 #include <gtest/gtest.h>
+#include <limits>
+#include <stdexcept>
 
 TEST(MapTest, testMapGetMethod) {
     // declare a map
@@ -52,13 +54,20 @@ TEST(MapTest, testMapGetMethod) {
     auto goal_for_test = std::make_pair(4, 2);
     map_test.SetGoal(goal_for_test);
 
+    // add start
+    auto start_for_test = std::make_pair(0, 4);
+    map_test.SetStart(start_for_test);
+
     // test map
     auto node_for_test = std::make_pair(1, 1);
     std::string status_for_test = " ";
     EXPECT_EQ(map_test.GetGoal(), goal_for_test);
-    EXPECT_EQ(map_test.CurrentCellG(node_for_test), 100.0);
-    EXPECT_EQ(map_test.CurrentCellRhs(node_for_test), 100.0);
-    EXPECT_EQ(map_test.CalculateCellKey(node_for_test), 100.0);
+    EXPECT_EQ(map_test.GetStart(), start_for_test);
+    auto infinity = std::numeric_limits<double>::infinity();
+    EXPECT_EQ(map_test.CurrentCellG(node_for_test), infinity);
+    EXPECT_EQ(map_test.CurrentCellRhs(node_for_test), infinity);
+    EXPECT_EQ(map_test.CalculateCellKey(node_for_test),
+              std::make_pair(infinity, infinity));
     EXPECT_EQ(map_test.CurrentCellStatus(node_for_test), status_for_test);
 }
 
@@ -89,7 +98,7 @@ TEST(MapTest, testMapSetMethod) {
 
     // test map
     EXPECT_EQ(map_test.CurrentCellG(node_for_test), 5566.0);
-    EXPECT_EQ(map_test.CurrentCellG(node2_for_test), 100.0);
+    EXPECT_EQ(map_test.CurrentCellG(node2_for_test), map_test.infinity_cost);
     EXPECT_EQ(map_test.CurrentCellRhs(node_for_test), 7878.0);
     EXPECT_EQ(map_test.CurrentCellStatus(node_for_test), status_for_test);
 }
@@ -112,7 +121,8 @@ TEST(MapTest, testMapOtherMethod) {
     EXPECT_EQ(map_test.FindNeighbors(node_for_test).size(), size);
     EXPECT_FALSE(map_test.Availability(std::make_pair(99, 3)));
     EXPECT_EQ(map_test.ComputeCost(node_for_test,
-                                   std::make_pair(99, 3)), 100.0);
+                                   std::make_pair(99, 3)),
+              map_test.infinity_cost);
 }
 
 TEST(MapTest, testMapPrintValue) {
@@ -124,9 +134,9 @@ TEST(MapTest, testMapPrintValue) {
     output.append("Value for shortest path:\n");
     output.append("(g, rhs): \n");
     output.append(" ---------------------------\n");
-    output.append(" | (100, 100) | (100, 100) | \n");
+    output.append(" | (inf, inf) | (inf, inf) | \n");
     output.append(" ---------------------------\n");
-    output.append(" | (100, 100) | (100, 100) | \n");
+    output.append(" | (inf, inf) | (inf, inf) | \n");
     output.append(" ---------------------------\n\n");
 
     testing::internal::CaptureStdout();
@@ -166,3 +176,233 @@ TEST(MapTest, testMapPrintResult) {
     std::string myoutput = testing::internal::GetCapturedStdout();
     EXPECT_EQ(myoutput, output);
 }
+
+
+TEST(MapTest, testMapIndexMethod) {
+    // declare a map
+    Map map_test(6, 7);
+    std::vector<std::pair<int, int>> obstacles_for_test = {};
+    std::vector<std::pair<int, int>> unknown_for_test = {};
+    obstacles_for_test.push_back(std::make_pair(2, 3));
+    unknown_for_test.push_back(std::make_pair(4, 1));
+    map_test.AddObstacle(obstacles_for_test, unknown_for_test);
+
+    // index and position are consistent
+    auto node_for_test = std::make_pair(5, 6);
+    auto index = map_test.CellIndex(node_for_test);
+    EXPECT_EQ(map_test.CellPosition(index), node_for_test);
+    EXPECT_EQ(map_test.GetSize(), std::make_pair(6, 7));
+
+    // both sets of accessors see the same cell
+    map_test.UpdateCellG(index, 3.0);
+    map_test.UpdateCellRhs(node_for_test, 4.0);
+    EXPECT_EQ(map_test.CurrentCellG(node_for_test), 3.0);
+    EXPECT_EQ(map_test.CurrentCellRhs(index), 4.0);
+
+    // status codes and marks
+    EXPECT_TRUE(map_test.Blocked(map_test.CellIndex(std::make_pair(2, 3))));
+    EXPECT_EQ(map_test.CurrentStatusCode(map_test.CellIndex(
+              std::make_pair(4, 1))), Map::kUnknown);
+    map_test.UpdateStatusCode(index, Map::kRobot);
+    EXPECT_EQ(map_test.CurrentCellStatus(node_for_test), map_test.robot_mark);
+    map_test.UpdateCellStatus(node_for_test, map_test.obstacle_mark);
+    EXPECT_TRUE(map_test.Blocked(index));
+
+    // hidden obstacles are mirrored in their own grid
+    auto hidden_index = map_test.CellIndex(std::make_pair(4, 1));
+    EXPECT_TRUE(map_test.Hidden().Test(hidden_index));
+    EXPECT_EQ(map_test.Hidden().CountSet(), 1u);
+    map_test.UpdateStatusCode(hidden_index, Map::kObstacle);
+    EXPECT_FALSE(map_test.Hidden().Test(hidden_index));
+    EXPECT_THROW(map_test.CurrentCellG(std::make_pair(6, 0)),
+                 std::out_of_range);
+}
+
+
+TEST(MapTest, testMapHeuristic) {
+    // declare a map
+    Map map_test(10, 10);
+    map_test.SetStart(std::make_pair(2, 2));
+
+    // octile distance with the cheaper of diagonal and two transitional steps
+    EXPECT_EQ(map_test.ComputeHeuristic(std::make_pair(2, 2),
+                                        std::make_pair(5, 9)), 10.0);
+    EXPECT_EQ(map_test.ComputeHeuristic(std::make_pair(5, 9),
+                                        std::make_pair(2, 2)), 10.0);
+
+    // km grows by the heuristic distance the start moves
+    map_test.UpdateStart(std::make_pair(3, 3));
+    EXPECT_EQ(map_test.GetKeyModifier(), 2.0);
+    map_test.UpdateCellRhs(std::make_pair(3, 5), 7.0);
+    EXPECT_EQ(map_test.CalculateCellKey(std::make_pair(3, 5)),
+              std::make_pair(11.0, 7.0));
+
+    // pluggable heuristic
+    map_test.SetHeuristic([](const std::pair<int, int> &,
+                             const std::pair<int, int> &) { return 0.0; });
+    EXPECT_EQ(map_test.CalculateCellKey(std::make_pair(3, 5)),
+              std::make_pair(9.0, 7.0));
+}
+
+namespace {
+// whether the default heuristic of a map of the given type charges no move
+// more than it costs, between every two cells of an empty map
+template <typename MapType>
+bool HeuristicConsistent() {
+    MapType map_test(7, 7);
+    for (int i = 0; i < 7; ++i) {
+        for (int j = 0; j < 7; ++j) {
+            auto from = std::make_pair(i, j);
+            for (auto const &next : map_test.FindNeighbors(from)) {
+                auto cost = map_test.ComputeCost(from, next);
+                for (int k = 0; k < 7; ++k) {
+                    for (int l = 0; l < 7; ++l) {
+                        auto to = std::make_pair(k, l);
+                        if (map_test.ComputeHeuristic(from, to) >
+                            cost + map_test.ComputeHeuristic(next, to))
+                            return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+}  // namespace
+
+TEST(MapTest, testSixteenConnectedHeuristic) {
+    BasicMap<double, SixteenConnected> map_test(10, 10);
+    auto knight_cost = SixteenConnected::kKnightCost + 0.0;
+
+    // a knight move is cheaper than the three transitional moves around it,
+    // and the heuristic counts the knight moves a path can take
+    EXPECT_LT(knight_cost, 3 * map_test.transitional_cost);
+    EXPECT_EQ(map_test.ComputeHeuristic(std::make_pair(0, 0),
+                                        std::make_pair(2, 1)), knight_cost);
+    EXPECT_EQ(map_test.ComputeHeuristic(std::make_pair(0, 0),
+                                        std::make_pair(3, 3)), 2 * knight_cost);
+    EXPECT_EQ(map_test.ComputeHeuristic(std::make_pair(0, 0),
+                                        std::make_pair(1, 7)), knight_cost + 5);
+
+    // the heuristic stays consistent, so the search stays optimal
+    EXPECT_TRUE((HeuristicConsistent<BasicMap<double, FourConnected>>()));
+    EXPECT_TRUE((HeuristicConsistent<BasicMap<double, EightConnected>>()));
+    EXPECT_TRUE((HeuristicConsistent<BasicMap<double, SixteenConnected>>()));
+}
+
+TEST(MapTest, testMapNeighborRange) {
+    // declare a map
+    Map map_test(3, 4);
+    std::vector<std::pair<int, int>> obstacles_for_test = {};
+    std::vector<std::pair<int, int>> unknown_for_test = {};
+    obstacles_for_test.push_back(std::make_pair(1, 1));
+    map_test.AddObstacle(obstacles_for_test, unknown_for_test);
+
+    // the corner only sees the cells inside the map and not the obstacle
+    auto corner_index = map_test.CellIndex(std::make_pair(0, 0));
+    std::vector<std::pair<int, int>> neighbors = {};
+    for (auto const &neighbor : map_test.Neighbors(corner_index)) {
+        neighbors.push_back(map_test.CellPosition(neighbor.index));
+        EXPECT_EQ(neighbor.cost, map_test.transitional_cost);
+    }
+    std::vector<std::pair<int, int>> expected_neighbors = {
+        std::make_pair(0, 1), std::make_pair(1, 0)};
+    EXPECT_EQ(neighbors, expected_neighbors);
+    EXPECT_EQ(map_test.FindNeighbors(std::make_pair(0, 0)), neighbors);
+
+    // a cell in the middle has diagonal moves too
+    auto total_cost = 0.0;
+    auto neighbor_num = 0;
+    auto middle_index = map_test.CellIndex(std::make_pair(1, 2));
+    for (auto const &neighbor : map_test.Neighbors(middle_index)) {
+        total_cost += neighbor.cost;
+        ++neighbor_num;
+    }
+    EXPECT_EQ(neighbor_num, 7);
+    EXPECT_EQ(total_cost, 3 * map_test.transitional_cost +
+                          4 * map_test.diagonal_cost);
+    EXPECT_FALSE(map_test.Availability(std::make_pair(-1, 0)));
+    EXPECT_FALSE(map_test.Availability(std::make_pair(0, 4)));
+}
+
+TEST(MapTest, testMapCostTypes) {
+    BasicMap<float> float_map(3, 3);
+    BasicMap<FixedCost> fixed_map(3, 3);
+    auto node_for_test = std::make_pair(1, 1);
+    auto index = fixed_map.CellIndex(node_for_test);
+
+    // values are stored in the cost type and read back as doubles
+    float_map.UpdateCellG(node_for_test, 2.5);
+    fixed_map.UpdateCellG(node_for_test, 2.5);
+    EXPECT_EQ(float_map.CurrentCellG(node_for_test), 2.5);
+    EXPECT_EQ(fixed_map.CurrentCellG(node_for_test), 2.5);
+    EXPECT_EQ(fixed_map.CurrentCellG(index),
+              static_cast<FixedCost>(2.5 * CostTraits<FixedCost>::kScale));
+
+    // infinity is a real infinity in every cost type
+    auto infinity = std::numeric_limits<double>::infinity();
+    EXPECT_EQ(float_map.CurrentCellRhs(node_for_test), infinity);
+    EXPECT_EQ(fixed_map.CurrentCellRhs(node_for_test), infinity);
+    EXPECT_EQ(CostTraits<FixedCost>::Add(fixed_map.infinity_cost,
+                                         fixed_map.CurrentCellG(index)),
+              fixed_map.infinity_cost);
+    EXPECT_EQ(fixed_map.CalculateCellKey(node_for_test).second, 2.5);
+}
+
+TEST(MapTest, testMapConnectivity) {
+    BasicMap<double, FourConnected> four_map(5, 5);
+    BasicMap<double, SixteenConnected> sixteen_map(5, 5);
+    auto middle = std::make_pair(2, 2);
+
+    // four neighbors share an edge with the cell
+    EXPECT_EQ(four_map.FindNeighbors(middle).size(), 4u);
+    EXPECT_EQ(four_map.FindNeighbors(std::make_pair(0, 0)).size(), 2u);
+
+    // sixteen neighbors add the knight moves at their own cost
+    auto total_cost = 0.0;
+    auto neighbor_num = 0;
+    sixteen_map.ForEachNeighbor(
+        sixteen_map.CellIndex(middle),
+        [&](const BasicMap<double, SixteenConnected>::Neighbor &neighbor) {
+            total_cost += neighbor.cost;
+            ++neighbor_num;
+        });
+    EXPECT_EQ(neighbor_num, 16);
+    EXPECT_EQ(total_cost, 4 * sixteen_map.transitional_cost +
+                          4 * sixteen_map.diagonal_cost +
+                          8 * SixteenConnected::kKnightCost);
+    // the border is two cells wide, so knight moves stay on the grid
+    EXPECT_EQ(sixteen_map.Occupancy().Padding(), 2);
+    EXPECT_EQ(sixteen_map.FindNeighbors(std::make_pair(0, 0)).size(), 5u);
+    EXPECT_EQ(sixteen_map.FindNeighbors(std::make_pair(0, 4)).size(), 5u);
+
+    // a grid with a narrower border cannot hold the moves
+    EXPECT_THROW((BasicMap<double, SixteenConnected>(OccupancyGrid(5, 5))),
+                 std::invalid_argument);
+}
+
+TEST(MapTest, testMapTerrain) {
+    Map map_test(4, 4);
+    auto cell = std::make_pair(1, 1);
+    EXPECT_EQ(map_test.CurrentCellTerrain(cell), 0);
+    EXPECT_THROW(map_test.UpdateCellTerrain(cell, 256), std::invalid_argument);
+    EXPECT_THROW(map_test.UpdateCellTerrain({4, 0}, 1), std::out_of_range);
+
+    // entering the cell costs a quarter of a transitional move per level
+    map_test.UpdateCellTerrain(cell, 8);
+    EXPECT_EQ(map_test.ComputeCost(std::make_pair(0, 1), cell), 3.0);
+    EXPECT_EQ(map_test.ComputeCost(std::make_pair(0, 0), cell), 4.5);
+    // leaving it does not, and a cell two rows away is not a neighbor
+    EXPECT_EQ(map_test.ComputeCost(cell, std::make_pair(1, 2)), 1.0);
+    EXPECT_EQ(map_test.ComputeCost(cell, std::make_pair(3, 1)),
+              map_test.infinity_cost);
+
+    // neighbors see the cost of the move in their own direction
+    auto index = map_test.CellIndex(cell);
+    map_test.ForEachNeighbor(index, [](const Map::Neighbor &neighbor) {
+        EXPECT_LE(neighbor.cost, 2.5);
+    });
+    map_test.ForEachPredecessor(index, [](const Map::Neighbor &neighbor) {
+        EXPECT_GE(neighbor.cost, 3.0);
+    });
+}
@@ -0,0 +1,84 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file MovingAiImporterTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for the "MovingAiImporter" and "MovingAiScenarioReader" classes
+ * 
+ */
+
+#include "MovingAiImporter.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+
+TEST(MovingAiImporterTest, testReadMap) {
+    std::istringstream input("type octile\r\nheight 3\r\nwidth 5\r\nmap\r\n"
+                             "..@..\r\n.TGSW\r\nO....\r\n");
+    auto grid_test = MovingAiImporter::ReadMap(input);
+    EXPECT_EQ(grid_test.GetSize(), std::make_pair(3, 5));
+    EXPECT_EQ(grid_test.CountSet(), 4u);
+    EXPECT_TRUE(grid_test.Test(std::make_pair(0, 2)));
+    EXPECT_TRUE(grid_test.Test(std::make_pair(1, 1)));
+    EXPECT_FALSE(grid_test.Test(std::make_pair(1, 2)));
+    EXPECT_FALSE(grid_test.Test(std::make_pair(1, 3)));
+    EXPECT_TRUE(grid_test.Test(std::make_pair(1, 4)));
+    EXPECT_TRUE(grid_test.Test(std::make_pair(2, 0)));
+
+    std::istringstream short_input("type octile\nheight 3\nwidth 5\nmap\n"
+                                   ".....\n");
+    EXPECT_THROW(MovingAiImporter::ReadMap(short_input), std::runtime_error);
+    std::istringstream no_header("map\n.....\n");
+    EXPECT_THROW(MovingAiImporter::ReadMap(no_header), std::runtime_error);
+}
+
+TEST(MovingAiImporterTest, testReadScenarios) {
+    std::istringstream input(
+        "version 1\n"
+        "0\tmaps/arena.map\t49\t49\t1\t11\t1\t12\t1.00000000\n"
+        "\n"
+        "3\tmaps/arena.map\t49\t49\t13\t40\t20\t2\t38.89949494\n");
+    MovingAiScenarioReader reader_test(input);
+    MovingAiScenario scenario;
+    ASSERT_TRUE(reader_test.Next(&scenario));
+    EXPECT_EQ(scenario.bucket, 0);
+    EXPECT_EQ(scenario.map_name, "maps/arena.map");
+    EXPECT_EQ(scenario.map_size, std::make_pair(49, 49));
+    EXPECT_EQ(scenario.start, std::make_pair(11, 1));
+    EXPECT_EQ(scenario.goal, std::make_pair(12, 1));
+    ASSERT_TRUE(reader_test.Next(&scenario));
+    EXPECT_EQ(scenario.start, std::make_pair(40, 13));
+    EXPECT_EQ(scenario.goal, std::make_pair(2, 20));
+    EXPECT_DOUBLE_EQ(scenario.optimal_length, 38.89949494);
+    EXPECT_FALSE(reader_test.Next(&scenario));
+
+    std::istringstream bad_input("0\tarena.map\t49\n");
+    MovingAiScenarioReader bad_reader(bad_input);
+    EXPECT_THROW(bad_reader.Next(&scenario), std::runtime_error);
+}
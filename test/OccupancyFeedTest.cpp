@@ -0,0 +1,172 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file OccupancyFeedTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for the "OccupancyFeed" class
+ * 
+ */
+
+#include "OccupancyFeed.h"
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "DStarLitePlanner.h"
+
+namespace {
+std::string FeedName(const std::string &name) {
+    return "/dstarlite-" + name + "-" + std::to_string(getpid());
+}
+}  // namespace
+
+TEST(OccupancyFeedTest, testPollPublishedChanges) {
+    auto writer = OccupancyFeed::Create(FeedName("poll"), 100, 130);
+    auto reader = OccupancyFeed::Attach(FeedName("poll"));
+    EXPECT_EQ(reader.GetSize(), std::make_pair(100, 130));
+    Map map_test(100, 130);
+    map_test.SetGoal(std::make_pair(0, 0));
+    map_test.SetStart(std::make_pair(99, 129));
+    DStarLitePlanner planner_test(&map_test);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+
+    // nothing was published yet, but a new reader checks once
+    std::vector<CellChange> changes;
+    EXPECT_TRUE(reader.Poll(map_test.Occupancy(), &changes));
+    EXPECT_TRUE(changes.empty());
+    EXPECT_FALSE(reader.Poll(map_test.Occupancy(), &changes));
+
+    writer.Set(std::make_pair(98, 128), true);
+    writer.Set(std::make_pair(99, 128), true);
+    writer.Set(std::make_pair(70, 129), true);
+    writer.Set(std::make_pair(5, 5), true);
+    EXPECT_TRUE(reader.Test(std::make_pair(5, 5)));
+    // unpublished cells wait for the next publish
+    EXPECT_FALSE(reader.Poll(map_test.Occupancy(), &changes));
+    writer.Publish();
+    EXPECT_EQ(reader.Sequence(), 1u);
+    EXPECT_TRUE(reader.Poll(map_test.Occupancy(), &changes));
+    EXPECT_EQ(changes.size(), 4u);
+    planner_test.ApplyChanges(changes);
+    planner_test.ComputeShortestPath();
+    EXPECT_FALSE(map_test.Availability(std::make_pair(70, 129)));
+    EXPECT_FALSE(reader.Poll(map_test.Occupancy(), &changes));
+
+    // setting a cell to what the map knows is no change
+    writer.Set(std::make_pair(5, 5), false);
+    writer.Set(std::make_pair(98, 128), true);
+    writer.Publish();
+    EXPECT_TRUE(reader.Poll(map_test.Occupancy(), &changes));
+    ASSERT_EQ(changes.size(), 1u);
+    EXPECT_EQ(changes[0].position, std::make_pair(5, 5));
+    EXPECT_FALSE(changes[0].blocked);
+    planner_test.ApplyChanges(changes);
+    planner_test.ComputeShortestPath();
+    EXPECT_TRUE(map_test.Availability(std::make_pair(5, 5)));
+    EXPECT_THROW(writer.Set(std::make_pair(100, 0), true), std::out_of_range);
+}
+
+TEST(OccupancyFeedTest, testReadsOnlyDirtyTiles) {
+    auto feed = OccupancyFeed::Create(FeedName("dirty"), 200, 200);
+    Map map_test(200, 200);
+    // the map disagrees with the feed in a tile that was never written
+    map_test.UpdateCellStatus(std::make_pair(10, 10), "x");
+    feed.Set(std::make_pair(150, 190), true);
+    feed.Publish();
+    std::vector<CellChange> changes;
+    EXPECT_TRUE(feed.Poll(map_test.Occupancy(), &changes));
+    ASSERT_EQ(changes.size(), 1u);
+    EXPECT_EQ(changes[0].position, std::make_pair(150, 190));
+    EXPECT_TRUE(changes[0].blocked);
+    Map other_map(200, 100);
+    EXPECT_THROW(feed.Poll(other_map.Occupancy(), &changes),
+                 std::invalid_argument);
+}
+
+TEST(OccupancyFeedTest, testConcurrentWriter) {
+    auto writer = OccupancyFeed::Create(FeedName("concurrent"), 150, 150);
+    auto reader = OccupancyFeed::Attach(FeedName("concurrent"));
+    Map map_test(150, 150);
+    map_test.SetGoal(std::make_pair(0, 0));
+    map_test.SetStart(std::make_pair(149, 149));
+    DStarLitePlanner planner_test(&map_test);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+
+    std::thread perception([&writer] {
+        std::mt19937 generator(77);
+        std::uniform_int_distribution<int> coordinate(1, 148);
+        for (int round = 0; round < 200; ++round) {
+            for (int k = 0; k < 20; ++k)
+                writer.Set(std::make_pair(coordinate(generator),
+                                          coordinate(generator)),
+                           k % 3 != 0);
+            writer.Publish();
+        }
+    });
+    std::vector<CellChange> changes;
+    while (reader.Sequence() < 200) {
+        if (reader.Poll(map_test.Occupancy(), &changes)) {
+            planner_test.ApplyChanges(changes);
+            planner_test.ComputeShortestPath();
+        }
+    }
+    perception.join();
+    // one more poll catches tiles written after the last one read them
+    if (reader.Poll(map_test.Occupancy(), &changes))
+        planner_test.ApplyChanges(changes);
+    planner_test.ComputeShortestPath();
+    for (int i = 0; i < 150; ++i) {
+        for (int j = 0; j < 150; ++j) {
+            auto cell = std::make_pair(i, j);
+            EXPECT_EQ(map_test.Availability(cell), !reader.Test(cell));
+        }
+    }
+}
+
+TEST(OccupancyFeedTest, testCreateAndAttachErrors) {
+    EXPECT_THROW(OccupancyFeed::Attach(FeedName("missing")),
+                 std::runtime_error);
+    EXPECT_THROW(OccupancyFeed::Create(FeedName("empty"), 0, 5),
+                 std::invalid_argument);
+    auto feed = OccupancyFeed::Create(FeedName("twice"), 5, 5);
+    EXPECT_THROW(OccupancyFeed::Create(FeedName("twice"), 5, 5),
+                 std::runtime_error);
+    {
+        auto moved = std::move(feed);
+        EXPECT_EQ(moved.GetSize(), std::make_pair(5, 5));
+    }
+    // the creator removed the object when it went away
+    EXPECT_THROW(OccupancyFeed::Attach(FeedName("twice")),
+                 std::runtime_error);
+}
@@ -0,0 +1,206 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file OccupancyGridTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for the "OccupancyGrid" class
+ * 
+ */
+
+#include "OccupancyGrid.h"
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Map.h"
+
+namespace {
+std::string TempPath(const std::string &name) {
+    return "/tmp/" + name + "-" + std::to_string(getpid()) + ".grid";
+}
+}  // namespace
+
+TEST(OccupancyGridTest, testSetAndBorder) {
+    OccupancyGrid grid_test(3, 70);
+    EXPECT_EQ(grid_test.GetSize(), std::make_pair(3, 70));
+    EXPECT_FALSE(grid_test.IsMapped());
+    EXPECT_EQ(grid_test.CountSet(), 0u);
+    // the border is set, the cells next to it are not
+    EXPECT_TRUE(grid_test.Test(grid_test.CellIndex(std::make_pair(-1, 5))));
+    EXPECT_TRUE(grid_test.Test(grid_test.CellIndex(std::make_pair(2, 70))));
+    EXPECT_FALSE(grid_test.Test(std::make_pair(2, 69)));
+    auto index = grid_test.CellIndex(std::make_pair(1, 62));
+    grid_test.Set(index);
+    EXPECT_TRUE(grid_test.Test(std::make_pair(1, 62)));
+    EXPECT_EQ(grid_test.CountSet(), 1u);
+    grid_test.Clear(index);
+    EXPECT_FALSE(grid_test.Test(index));
+    EXPECT_THROW(OccupancyGrid(0, 4), std::invalid_argument);
+}
+
+TEST(OccupancyGridTest, testSaveAndOpen) {
+    Map map_test(20, 33);
+    map_test.AddObstacle({{0, 0}, {7, 32}, {19, 5}}, {{3, 3}});
+    auto path = TempPath("save");
+    map_test.Occupancy().Save(path);
+
+    Map mapped_map(OccupancyGrid::Open(path));
+    EXPECT_TRUE(mapped_map.Occupancy().IsMapped());
+    EXPECT_EQ(mapped_map.GetSize(), std::make_pair(20, 33));
+    EXPECT_EQ(mapped_map.Occupancy().CountSet(), 3u);
+    EXPECT_EQ(mapped_map.CurrentCellStatus(std::make_pair(7, 32)), "x");
+    EXPECT_FALSE(mapped_map.Availability(std::make_pair(19, 5)));
+    // only obstacles are saved
+    EXPECT_EQ(mapped_map.CurrentCellStatus(std::make_pair(3, 3)), " ");
+
+    // changes stay private to the mapping
+    mapped_map.UpdateCellStatus(std::make_pair(0, 0), " ");
+    mapped_map.UpdateCellStatus(std::make_pair(1, 1), "x");
+    EXPECT_TRUE(mapped_map.Availability(std::make_pair(0, 0)));
+    auto reopened = OccupancyGrid::Open(path);
+    EXPECT_TRUE(reopened.Test(std::make_pair(0, 0)));
+    EXPECT_FALSE(reopened.Test(std::make_pair(1, 1)));
+
+    // a copy owns its words
+    OccupancyGrid copy_test(reopened);
+    EXPECT_FALSE(copy_test.IsMapped());
+    EXPECT_EQ(copy_test.CountSet(), 3u);
+    std::remove(path.c_str());
+}
+
+TEST(OccupancyGridTest, testPaddingAndSave) {
+    OccupancyGrid grid_test(4, 6, true, 2);
+    EXPECT_EQ(grid_test.Padding(), 2);
+    // every cell within two cells of the map is border
+    EXPECT_TRUE(grid_test.Test(grid_test.CellIndex(std::make_pair(-2, -2))));
+    EXPECT_TRUE(grid_test.Test(grid_test.CellIndex(std::make_pair(5, 7))));
+    EXPECT_TRUE(grid_test.Test(grid_test.CellIndex(std::make_pair(1, -2))));
+    EXPECT_FALSE(grid_test.Test(std::make_pair(3, 5)));
+    EXPECT_EQ(grid_test.CellIndex(std::make_pair(0, 0)), 2 * (6 + 4) + 2);
+    EXPECT_THROW(OccupancyGrid(4, 6, true, 0), std::invalid_argument);
+
+    // the padding is saved with the cells
+    grid_test.Set(grid_test.CellIndex(std::make_pair(3, 5)));
+    auto path = TempPath("padding");
+    grid_test.Save(path);
+    auto reopened = OccupancyGrid::Open(path);
+    EXPECT_EQ(reopened.Padding(), 2);
+    EXPECT_EQ(reopened.CountSet(), 1u);
+    EXPECT_TRUE(reopened.Test(std::make_pair(3, 5)));
+    std::remove(path.c_str());
+}
+
+TEST(OccupancyGridTest, testOpenRejectsBadFiles) {
+    EXPECT_THROW(OccupancyGrid::Open(TempPath("missing")), std::runtime_error);
+    auto path = TempPath("bad");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << std::string(80, 'z');
+    }
+    EXPECT_THROW(OccupancyGrid::Open(path), std::runtime_error);
+    OccupancyGrid(50, 50).Save(path);
+    truncate(path.c_str(), 100);
+    EXPECT_THROW(OccupancyGrid::Open(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(OccupancyGridTest, testOpenRestoresBorder) {
+    OccupancyGrid grid_test(10, 70);
+    grid_test.Set(grid_test.CellIndex(std::make_pair(4, 4)));
+    auto path = TempPath("border");
+    grid_test.Save(path);
+    {
+        // wipe the first words after the 64-byte header: the top border
+        // and the start of the first row
+        std::fstream file(path, std::ios::binary | std::ios::in |
+                                    std::ios::out);
+        file.seekp(64);
+        file << std::string(24, '\0');
+    }
+    auto reopened = OccupancyGrid::Open(path);
+    EXPECT_TRUE(reopened.Test(reopened.CellIndex(std::make_pair(-1, -1))));
+    EXPECT_TRUE(reopened.Test(reopened.CellIndex(std::make_pair(-1, 40))));
+    EXPECT_TRUE(reopened.Test(reopened.CellIndex(std::make_pair(0, -1))));
+    EXPECT_TRUE(reopened.Test(std::make_pair(4, 4)));
+    EXPECT_EQ(reopened.CountSet(), 1u);
+
+    // a grid without a border, such as the hidden cells, loses a stray one
+    OccupancyGrid bare_grid(10, 70, false);
+    bare_grid.Save(path);
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in |
+                                    std::ios::out);
+        file.seekp(64);
+        file << std::string(8, '\xff');
+    }
+    auto bare_reopened = OccupancyGrid::Open(path, 0, false);
+    EXPECT_FALSE(bare_reopened.Test(
+        bare_reopened.CellIndex(std::make_pair(-1, -1))));
+    EXPECT_EQ(bare_reopened.CountSet(), 0u);
+    std::remove(path.c_str());
+}
+
+TEST(OccupancyGridTest, testFindSetInWindow) {
+    OccupancyGrid grid_test(90, 150, false);
+    std::mt19937 random_engine(3);
+    std::bernoulli_distribution coin(0.2);
+    for (int i = 0; i < 90; ++i)
+        for (int j = 0; j < 150; ++j)
+            if (coin(random_engine))
+                grid_test.Set(grid_test.CellIndex(std::make_pair(i, j)));
+
+    // windows inside the map, across word boundaries and clipped at edges
+    const std::vector<std::pair<std::pair<int, int>, int>> windows = {
+        {{45, 75}, 1}, {{0, 0}, 3}, {{89, 149}, 2}, {{40, 63}, 40},
+        {{10, 130}, 70}, {{50, 50}, 0}, {{-5, 20}, 4}};
+    for (auto const &window : windows) {
+        std::vector<int> expected;
+        auto center = window.first;
+        auto radius = window.second;
+        for (int i = center.first - radius; i <= center.first + radius; ++i)
+            for (int j = center.second - radius;
+                 j <= center.second + radius; ++j) {
+                if (i < 0 || j < 0 || i >= 90 || j >= 150) continue;
+                auto index = grid_test.CellIndex(std::make_pair(i, j));
+                if (grid_test.Test(index)) expected.push_back(index);
+            }
+        std::vector<int> found;
+        grid_test.FindSetInWindow(center, radius, &found);
+        EXPECT_EQ(found, expected);
+    }
+
+    // the border of a grid without border stays clear
+    std::vector<int> found;
+    OccupancyGrid(4, 4, false).FindSetInWindow(std::make_pair(0, 0), 9, &found);
+    EXPECT_TRUE(found.empty());
+}
@@ -55,3 +55,45 @@ TEST(CellOpenList, testOpenList) {
     EXPECT_FALSE(openlist_test.Find(third_node));
     EXPECT_TRUE(openlist_test.Find(first_node));
 }
+
+TEST(CellOpenList, testOpenListIndexedHeap) {
+    // a dense open list for a 10 x 10 map
+    OpenList openlist_test(10, 10);
+    for (int i = 0; i < 10; ++i) {
+        for (int j = 0; j < 10; ++j)
+            openlist_test.Insert(static_cast<double>((i * 7 + j * 3) % 11),
+                                 std::make_pair(i, j));
+    }
+    EXPECT_EQ(openlist_test.Size(), 100u);
+
+    // remove a node in the middle, raise one key and lower another
+    openlist_test.Remove(std::make_pair(5, 5));
+    openlist_test.Remove(std::make_pair(5, 5));
+    openlist_test.UpdateKey(50.0, std::make_pair(0, 0));
+    openlist_test.UpdateKey(-1.0, std::make_pair(9, 9));
+    EXPECT_FALSE(openlist_test.Find(std::make_pair(5, 5)));
+    EXPECT_EQ(openlist_test.Size(), 99u);
+    EXPECT_EQ(openlist_test.Top().second, std::make_pair(9, 9));
+
+    // nodes come out in order of key
+    auto last_key = -2.0;
+    while (!openlist_test.Empty()) {
+        auto key_and_node = openlist_test.Pop();
+        EXPECT_LE(last_key, key_and_node.first.first);
+        EXPECT_FALSE(openlist_test.Find(key_and_node.second));
+        last_key = key_and_node.first.first;
+    }
+    EXPECT_EQ(last_key, 50.0);
+}
+
+TEST(CellOpenList, testOpenListTwoComponentKey) {
+    OpenList openlist_test;
+    // ties in the first component are broken by the second one
+    openlist_test.Insert(std::make_pair(4.0, 3.0), std::make_pair(0, 0));
+    openlist_test.Insert(std::make_pair(4.0, 1.0), std::make_pair(1, 1));
+    openlist_test.Insert(std::make_pair(5.0, 0.0), std::make_pair(2, 2));
+    EXPECT_EQ(openlist_test.Top().second, std::make_pair(1, 1));
+    openlist_test.UpdateKey(std::make_pair(3.0, 9.0), std::make_pair(2, 2));
+    EXPECT_EQ(openlist_test.Pop().first, std::make_pair(3.0, 9.0));
+    EXPECT_EQ(openlist_test.Pop().second, std::make_pair(1, 1));
+}
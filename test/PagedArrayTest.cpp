@@ -0,0 +1,87 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+/**
+ * @file PagedArrayTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for the "PagedArray" class
+ * 
+ */
+
+#include "PagedArray.h"
+#include <gtest/gtest.h>
+#include <limits>
+#include <utility>
+#include "DStarLitePlanner.h"
+
+TEST(PagedArrayTest, testLazyPages) {
+    PagedArray<double> array_test;
+    auto page_size = PagedArray<double>::kPageSize;
+    array_test.Assign(10 * page_size + 3, 7.0);
+    EXPECT_EQ(array_test.Size(), 10 * page_size + 3);
+    EXPECT_EQ(array_test[10 * page_size + 2], 7.0);
+    EXPECT_EQ(array_test.AllocatedSize(), 0u);
+
+    // the default value allocates nothing, any other value its page
+    array_test.Set(5, 7.0);
+    EXPECT_EQ(array_test.AllocatedSize(), 0u);
+    array_test.Set(5, 1.5);
+    array_test.Set(page_size - 1, 2.5);
+    EXPECT_EQ(array_test.AllocatedSize(), page_size);
+    EXPECT_EQ(array_test[5], 1.5);
+    EXPECT_EQ(array_test[4], 7.0);
+    array_test.Set(10 * page_size, 3.5);
+    EXPECT_EQ(array_test.AllocatedSize(), 2 * page_size);
+
+    // copies own their pages, moves take them
+    PagedArray<double> copy_test(array_test);
+    copy_test.Set(5, 0.5);
+    EXPECT_EQ(array_test[5], 1.5);
+    EXPECT_EQ(copy_test[page_size - 1], 2.5);
+    PagedArray<double> moved_test(std::move(copy_test));
+    EXPECT_EQ(moved_test[5], 0.5);
+    EXPECT_EQ(moved_test.AllocatedSize(), 2 * page_size);
+
+    // assigning again releases every page
+    array_test.Assign(3, 0.0);
+    EXPECT_EQ(array_test.AllocatedSize(), 0u);
+    EXPECT_EQ(array_test[2], 0.0);
+}
+
+TEST(PagedArrayTest, testMemoryFollowsSearch) {
+    // a short search on a huge map only touches the pages around its path
+    Map map_test(8000, 8000);
+    EXPECT_EQ(map_test.AllocatedBytes(), 0u);
+    map_test.SetGoal(std::make_pair(4000, 4050));
+    map_test.SetStart(std::make_pair(4000, 4000));
+    DStarLitePlanner planner_test(&map_test);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(map_test.CurrentCellG(map_test.GetStart()), 50.0);
+    EXPECT_GT(map_test.AllocatedBytes(), 0u);
+    EXPECT_LT(map_test.AllocatedBytes(), 1u << 20);
+}
@@ -0,0 +1,119 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file PlannerObserverTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for the "PlannerObserver" interface and the "MapPrinter" class
+ * 
+ */
+
+#include "PlannerObserver.h"
+#include "MapPrinter.h"
+#include "DStarLitePlanner.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+// remembers the events it hears of
+class RecordingObserver : public PlannerObserver {
+ public:
+    void OnReplan(const Map &, const std::pair<int, int> &start) override {
+        replans.push_back(start);
+    }
+    void OnStep(const Map &, const std::pair<int, int> &position) override {
+        steps.push_back(position);
+    }
+    void OnObstacleDiscovered(const Map &,
+                              const std::vector<CellChange> &changes) override {
+        discovered += changes.size();
+    }
+    std::vector<std::pair<int, int>> replans;
+    std::vector<std::pair<int, int>> steps;
+    std::size_t discovered = 0;
+};
+}  // namespace
+
+TEST(PlannerObserverTest, testObserverEvents) {
+    Map map_test(4, 5);
+    std::vector<std::pair<int, int>> obstacles_for_test = {};
+    std::vector<std::pair<int, int>> unknown_for_test = {
+        std::make_pair(2, 2), std::make_pair(3, 2)};
+    map_test.AddObstacle(obstacles_for_test, unknown_for_test);
+    map_test.SetGoal(std::make_pair(2, 0));
+    map_test.SetStart(std::make_pair(2, 4));
+
+    RecordingObserver observer_test;
+    ObserverOptions options_test;
+    options_test.step_every = 2;
+    DStarLitePlanner planner_test(&map_test);
+    planner_test.SetObserver(&observer_test, options_test);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(observer_test.replans.size(), 1u);
+
+    // every second step is passed on
+    planner_test.MoveStart(std::make_pair(2, 3));
+    EXPECT_TRUE(observer_test.steps.empty());
+    EXPECT_TRUE(planner_test.DetectHiddenObstacle(std::make_pair(2, 3)));
+    EXPECT_EQ(observer_test.discovered, 2u);
+    planner_test.ComputeShortestPath();
+    planner_test.MoveStart(planner_test.NextMove());
+    ASSERT_EQ(observer_test.steps.size(), 1u);
+    EXPECT_EQ(observer_test.steps.front(), planner_test.CurrentStart());
+    EXPECT_EQ(observer_test.replans.size(), 2u);
+
+    // headless: nothing is passed on any more
+    planner_test.SetObserver(nullptr);
+    planner_test.ComputeShortestPath();
+    planner_test.MoveStart(planner_test.NextMove());
+    EXPECT_EQ(observer_test.replans.size(), 2u);
+    EXPECT_EQ(observer_test.steps.size(), 1u);
+}
+
+TEST(PlannerObserverTest, testMapPrinter) {
+    Map map_test(1, 2);
+    map_test.SetGoal(std::make_pair(0, 0));
+    MapPrinter printer_test;
+
+    testing::internal::CaptureStdout();
+    printer_test.OnStep(map_test, std::make_pair(0, 1));
+    std::string step_output = testing::internal::GetCapturedStdout();
+    EXPECT_EQ(step_output, "Result: \n"
+                           "start: s goal: g robot: . obstacle: x unknown: ?\n"
+                           " ---------\n"
+                           " | g |   | \n"
+                           " ---------\n\n");
+
+    testing::internal::CaptureStdout();
+    printer_test.OnReplan(map_test, std::make_pair(0, 1));
+    std::string replan_output = testing::internal::GetCapturedStdout();
+    EXPECT_EQ(replan_output.find("Value for shortest path:"), 0u);
+    EXPECT_NE(replan_output.find(step_output), std::string::npos);
+}
@@ -0,0 +1,102 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file PlannerPoolTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for the "PlannerPool" class and for maps sharing obstacles
+ * 
+ */
+
+#include "PlannerPool.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "Map.h"
+#include "MapGenerator.h"
+
+TEST(PlannerPoolTest, testMapsShareObstacles) {
+    Map base_map(8, 8);
+    base_map.AddObstacle({{3, 3}}, {});
+    auto base = base_map.SharedOccupancy();
+
+    Map first_map(base);
+    Map second_map(base);
+    EXPECT_EQ(&first_map.Occupancy(), base.get());
+    // marks and search values do not touch the shared obstacles
+    first_map.SetGoal(std::make_pair(0, 0));
+    first_map.UpdateCellG(std::make_pair(1, 1), 5.0);
+    EXPECT_EQ(&first_map.Occupancy(), base.get());
+    EXPECT_EQ(second_map.CurrentCellG(std::make_pair(1, 1)),
+              second_map.infinity_cost);
+    // a new obstacle copies them first
+    first_map.AddObstacle({{4, 4}}, {});
+    EXPECT_NE(&first_map.Occupancy(), base.get());
+    EXPECT_FALSE(base->Test(std::make_pair(4, 4)));
+    EXPECT_FALSE(second_map.Availability(std::make_pair(3, 3)));
+    EXPECT_TRUE(second_map.Availability(std::make_pair(4, 4)));
+    // and so does the map the obstacles were taken from
+    base_map.UpdateCellStatus(std::make_pair(3, 3), " ");
+    EXPECT_TRUE(base->Test(std::make_pair(3, 3)));
+}
+
+TEST(PlannerPoolTest, testSolveMatchesSingleThread) {
+    Map base_map(40, 40);
+    MapGenerator generator_test(21);
+    generator_test.RandomObstacles(&base_map, 0.2);
+    auto base = base_map.SharedOccupancy();
+
+    std::vector<PathQuery> queries;
+    for (int i = 0; i < 40; ++i) {
+        auto start = std::make_pair(i, (i * 7) % 40);
+        auto goal = std::make_pair((i * 13 + 5) % 40, 39 - i);
+        if (base->Test(start) || base->Test(goal)) continue;
+        queries.push_back(PathQuery{start, goal});
+    }
+    PlannerPool pool_test(base, 4);
+    EXPECT_EQ(pool_test.ThreadNum(), 4);
+    auto results = pool_test.Solve(queries);
+    ASSERT_EQ(results.size(), queries.size());
+    int reached_num = 0;
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        auto expected = PlannerPool::SolveOne(base, queries[i]);
+        EXPECT_EQ(results[i].reached, expected.reached);
+        EXPECT_EQ(results[i].cost, expected.cost);
+        EXPECT_EQ(results[i].path, expected.path);
+        if (!results[i].reached) continue;
+        ++reached_num;
+        EXPECT_EQ(results[i].path.front(), queries[i].start);
+        EXPECT_EQ(results[i].path.back(), queries[i].goal);
+    }
+    EXPECT_GT(reached_num, 0);
+
+    // a bad query is reported by Solve
+    queries.push_back(PathQuery{std::make_pair(0, 0), std::make_pair(40, 0)});
+    EXPECT_THROW(pool_test.Solve(queries), std::out_of_range);
+}
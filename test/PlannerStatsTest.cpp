@@ -0,0 +1,96 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file PlannerStatsTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for the "PlannerStats" and "Log2Histogram" classes
+ * 
+ */
+
+#include "PlannerStats.h"
+#include "DStarLitePlanner.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+TEST(PlannerStatsTest, testHistogram) {
+    Log2Histogram histogram_test;
+    EXPECT_EQ(histogram_test.Percentile(0.5), 0.0);
+    histogram_test.Record(0.5);
+    histogram_test.Record(3.0);
+    histogram_test.Record(3.5);
+    histogram_test.Record(100.0);
+
+    EXPECT_EQ(histogram_test.Count(), 4u);
+    EXPECT_EQ(histogram_test.Buckets()[0], 1u);
+    EXPECT_EQ(histogram_test.Buckets()[2], 2u);
+    EXPECT_EQ(histogram_test.Buckets()[7], 1u);
+    EXPECT_EQ(histogram_test.Mean(), 26.75);
+    EXPECT_EQ(histogram_test.Max(), 100.0);
+    EXPECT_EQ(histogram_test.Percentile(0.5), 4.0);
+    EXPECT_EQ(histogram_test.Percentile(1.0), 100.0);
+    EXPECT_EQ(histogram_test.ToJson(),
+              "{\"count\": 4, \"mean\": 26.75, \"p50\": 4, \"p90\": 100, "
+              "\"p99\": 100, \"max\": 100, \"buckets\": [1, 0, 2, 0, 0, 0, "
+              "0, 1]}");
+}
+
+TEST(PlannerStatsTest, testPlannerCounters) {
+    Map map_test(10, 10);
+    map_test.SetGoal(std::make_pair(0, 0));
+    map_test.SetStart(std::make_pair(9, 9));
+    DStarLitePlanner planner_test(&map_test);
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+    std::vector<CellChange> changes = {CellChange{std::make_pair(8, 8), true}};
+    planner_test.ApplyChanges(changes);
+    planner_test.ComputeShortestPath();
+
+    auto const &stats = planner_test.Stats();
+#ifdef DSTARLITE_STATS
+    EXPECT_EQ(stats.replans, 2u);
+    EXPECT_EQ(stats.change_batches, 1u);
+    EXPECT_EQ(stats.changed_cells, 1u);
+    EXPECT_EQ(stats.expansions, stats.overconsistent_expansions +
+                                stats.underconsistent_expansions);
+    EXPECT_GT(stats.overconsistent_expansions, 0u);
+    EXPECT_GE(stats.openlist_inserts, stats.openlist_removes);
+    EXPECT_GT(stats.max_openlist_size, 0u);
+    EXPECT_GT(stats.update_vertex_calls, stats.expansions);
+    EXPECT_EQ(stats.replan_latency_us.Count(), 2u);
+    EXPECT_EQ(stats.touched_cells_per_replan.Count(), 2u);
+    EXPECT_EQ(stats.change_batch_latency_us.Count(), 1u);
+    EXPECT_NE(stats.ToJson().find("\"replans\": 2"), std::string::npos);
+#else
+    EXPECT_EQ(stats.replans, 0u);
+    EXPECT_EQ(stats.expansions, 0u);
+#endif
+    planner_test.ResetStats();
+    EXPECT_EQ(planner_test.Stats().replans, 0u);
+}
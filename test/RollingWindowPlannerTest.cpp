@@ -0,0 +1,128 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+/**
+ * @file RollingWindowPlannerTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for the "RollingWindowPlanner" class
+ * 
+ */
+
+#include "RollingWindowPlanner.h"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+// a wall across the way at column 40, longer than the window on both sides
+bool WallObstacle(const std::pair<int, int> &position) {
+    return position.second == 40 && position.first > -30 &&
+           position.first < 25;
+}
+
+bool NoObstacle(const std::pair<int, int> &) { return false; }
+
+// walk the robot to the goal, sensing the world around it every step
+int WalkToGoal(RollingWindowPlanner *planner_ptr,
+               bool (*world_obstacle)(const std::pair<int, int> &),
+               const int &max_steps) {
+    int steps = 0;
+    while (planner_ptr->CurrentStart() != planner_ptr->GetGoal() &&
+           steps < max_steps) {
+        auto position = planner_ptr->CurrentStart();
+        std::vector<CellChange> changes;
+        for (int i = -4; i <= 4; ++i) {
+            for (int j = -4; j <= 4; ++j) {
+                auto cell = std::make_pair(position.first + i,
+                                           position.second + j);
+                if (world_obstacle(cell)) changes.push_back({cell, true});
+            }
+        }
+        planner_ptr->ApplyChanges(changes);
+        planner_ptr->ComputeShortestPath();
+        auto next = planner_ptr->NextMove();
+        if (next == position) break;
+        planner_ptr->MoveStart(next);
+        ++steps;
+    }
+    return steps;
+}
+}  // namespace
+
+TEST(RollingWindowPlannerTest, testWindowFollowsRobot) {
+    EXPECT_THROW(RollingWindowPlanner(2, 10), std::invalid_argument);
+    RollingWindowPlanner planner_test(15, 15);
+    planner_test.Initialize(std::make_pair(-5, -5), std::make_pair(-5, 195));
+    EXPECT_EQ(planner_test.Origin(), std::make_pair(-12, -12));
+    EXPECT_TRUE(planner_test.InWindow(std::make_pair(2, 2)));
+    EXPECT_FALSE(planner_test.InWindow(std::make_pair(3, 2)));
+
+    // the goal is far outside, so the robot heads for the frontier
+    EXPECT_EQ(WalkToGoal(&planner_test, NoObstacle, 1000), 200);
+    EXPECT_EQ(planner_test.CurrentStart(), planner_test.GetGoal());
+    EXPECT_GT(planner_test.RecenterNum(), 20);
+    EXPECT_EQ(planner_test.Window().GetSize(), std::make_pair(15, 15));
+    EXPECT_TRUE(planner_test.InWindow(planner_test.GetGoal()));
+}
+
+TEST(RollingWindowPlannerTest, testWindowGoesAroundWall) {
+    RollingWindowPlanner planner_test(21, 21);
+    planner_test.Initialize(std::make_pair(0, 0), std::make_pair(0, 80));
+    auto steps = WalkToGoal(&planner_test, WallObstacle, 1000);
+    EXPECT_EQ(planner_test.CurrentStart(), planner_test.GetGoal());
+    // around an end of the wall and back, without turning back for good:
+    // the edge costs carried over remember the part of the wall left behind
+    EXPECT_GE(steps, 80 + 2 * 25);
+    EXPECT_LT(steps, 80 + 2 * 25 + 100);
+
+    // the wall behind is forgotten once the window has left it
+    EXPECT_FALSE(planner_test.InWindow(std::make_pair(0, 40)));
+    EXPECT_FALSE(planner_test.KnownObstacle(std::make_pair(0, 40)));
+}
+
+TEST(RollingWindowPlannerTest, testRingBufferRecyclesCells) {
+    RollingWindowPlanner planner_test(9, 9);
+    planner_test.Initialize(std::make_pair(0, 0), std::make_pair(0, 100));
+    EXPECT_TRUE(planner_test.ApplyChanges({{{2, 3}, true}, {{3, 3}, true},
+                                           {{40, 40}, true}}));
+    EXPECT_FALSE(planner_test.ApplyChanges({{{2, 3}, true}}));
+    EXPECT_TRUE(planner_test.KnownObstacle(std::make_pair(2, 3)));
+    EXPECT_FALSE(planner_test.KnownObstacle(std::make_pair(40, 40)));
+
+    // a step to the edge recenters; cells still inside are kept
+    planner_test.MoveStart(std::make_pair(0, 3));
+    EXPECT_EQ(planner_test.RecenterNum(), 1);
+    EXPECT_EQ(planner_test.Origin(), std::make_pair(-4, -1));
+    EXPECT_TRUE(planner_test.KnownObstacle(std::make_pair(3, 3)));
+    // the slot of a cell that comes in is cleared, though it shares the
+    // slot of (2, -6) that left
+    EXPECT_FALSE(planner_test.KnownObstacle(std::make_pair(2, 7)));
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(planner_test.Window().CurrentCellStatus(std::make_pair(6, 4)),
+              "x");
+}
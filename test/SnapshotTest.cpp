@@ -0,0 +1,244 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file SnapshotTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for planner snapshots
+ * 
+ */
+
+#include "Snapshot.h"
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "DStarLitePlanner.h"
+
+namespace {
+std::string TempPath(const std::string &name) {
+    return "/tmp/" + name + "-" + std::to_string(getpid()) + ".snapshot";
+}
+
+// a map with obstacles, hidden obstacles, terrain and a custom mark, whose
+// planner has moved and sensed changes it has not repaired yet
+template <typename PlannerType>
+void PrepareRun(Map *map_ptr, PlannerType *planner_ptr) {
+    std::mt19937 generator(2024);
+    std::uniform_int_distribution<int> coordinate(0, 39);
+    std::vector<std::pair<int, int>> obstacles;
+    std::vector<std::pair<int, int>> hidden;
+    for (int i = 0; i < 200; ++i) {
+        auto cell = std::make_pair(coordinate(generator),
+                                   coordinate(generator));
+        if (cell.first + cell.second < 4 || cell.first + cell.second > 74)
+            continue;
+        (i % 4 == 0 ? hidden : obstacles).push_back(cell);
+    }
+    map_ptr->AddObstacle(obstacles, hidden);
+    map_ptr->UpdateCellTerrain(std::make_pair(20, 5), 40);
+    map_ptr->UpdateCellStatus(std::make_pair(39, 0), "*");
+    map_ptr->SetGoal(std::make_pair(0, 0));
+    map_ptr->SetStart(std::make_pair(39, 39));
+    planner_ptr->SetSensorRadius(3);
+    planner_ptr->AddRobot(std::make_pair(39, 20));
+    planner_ptr->Initialize();
+    planner_ptr->ComputeShortestPath();
+    planner_ptr->MoveStart(planner_ptr->NextMove());
+    planner_ptr->ApplyChanges({CellChange{std::make_pair(30, 30), true},
+                               CellChange{std::make_pair(10, 10), true}});
+}
+
+template <typename PlannerType>
+void ExpectResumesLikeOriginal() {
+    Map map_test(40, 40);
+    PlannerType planner_test(&map_test);
+    PrepareRun(&map_test, &planner_test);
+    auto path = TempPath("resume");
+    planner_test.SaveSnapshot(path);
+
+    // any map of the same type takes the snapshot, whatever its size
+    Map loaded_map(3, 5);
+    PlannerType loaded_planner(&loaded_map);
+    loaded_planner.LoadSnapshot(path);
+    std::remove(path.c_str());
+    EXPECT_TRUE(loaded_map.Occupancy().IsMapped());
+    EXPECT_EQ(loaded_map.GetSize(), map_test.GetSize());
+    EXPECT_EQ(loaded_map.GetGoal(), map_test.GetGoal());
+    EXPECT_EQ(loaded_map.GetStart(), map_test.GetStart());
+    EXPECT_EQ(loaded_map.GetKeyModifier(), map_test.GetKeyModifier());
+    EXPECT_EQ(loaded_map.AllocatedBytes(), map_test.AllocatedBytes());
+    EXPECT_EQ(loaded_map.Hidden().CountSet(), map_test.Hidden().CountSet());
+    EXPECT_EQ(loaded_map.CurrentCellTerrain(std::make_pair(20, 5)), 40);
+    EXPECT_EQ(loaded_map.CurrentCellStatus(std::make_pair(39, 0)), "*");
+    EXPECT_EQ(loaded_planner.CurrentStart(), planner_test.CurrentStart());
+    EXPECT_EQ(loaded_planner.SensorRadius(), 3);
+    EXPECT_EQ(loaded_planner.RobotPosition(0), std::make_pair(39, 20));
+    EXPECT_EQ(loaded_planner.CurrentOpenList().Size(),
+              planner_test.CurrentOpenList().Size());
+
+    // both finish the interrupted repair the same way
+    planner_test.ComputeShortestPath();
+    loaded_planner.ComputeShortestPath();
+    for (int i = 0; i < 40; ++i) {
+        for (int j = 0; j < 40; ++j) {
+            auto cell = std::make_pair(i, j);
+            EXPECT_EQ(loaded_map.CurrentCellG(cell),
+                      map_test.CurrentCellG(cell));
+            EXPECT_EQ(loaded_map.CurrentCellRhs(cell),
+                      map_test.CurrentCellRhs(cell));
+        }
+    }
+    EXPECT_EQ(loaded_planner.NextMove(), planner_test.NextMove());
+    EXPECT_EQ(loaded_planner.NextMoves(), planner_test.NextMoves());
+}
+}  // namespace
+
+TEST(SnapshotTest, testResumeInterruptedRepair) {
+    ExpectResumesLikeOriginal<DStarLitePlanner>();
+    ExpectResumesLikeOriginal<BucketDStarLitePlanner>();
+}
+
+TEST(SnapshotTest, testWarmRestartDoesNoWork) {
+    Map map_test(40, 40);
+    DStarLitePlanner planner_test(&map_test);
+    PrepareRun(&map_test, &planner_test);
+    planner_test.ComputeShortestPath();
+    auto path = TempPath("warm");
+    planner_test.SaveSnapshot(path);
+
+    Map loaded_map(40, 40);
+    DStarLitePlanner loaded_planner(&loaded_map);
+    loaded_planner.LoadSnapshot(path);
+    loaded_planner.ComputeShortestPath();
+#ifdef DSTARLITE_STATS
+    EXPECT_EQ(loaded_planner.Stats().expansions, 0u);
+#endif
+    EXPECT_EQ(loaded_planner.NextMove(), planner_test.NextMove());
+
+    // the search goes on in the private mapping, the file never changes
+    loaded_planner.MoveStart(loaded_planner.NextMove());
+    loaded_planner.ApplyChanges({CellChange{std::make_pair(5, 5), true}});
+    loaded_planner.ComputeShortestPath();
+    Map reloaded_map(40, 40);
+    DStarLitePlanner reloaded_planner(&reloaded_map);
+    reloaded_planner.LoadSnapshot(path);
+    EXPECT_EQ(reloaded_map.GetStart(), map_test.GetStart());
+    EXPECT_TRUE(reloaded_map.Availability(std::make_pair(5, 5)));
+    EXPECT_EQ(reloaded_map.CurrentCellG(map_test.GetStart()),
+              map_test.CurrentCellG(map_test.GetStart()));
+    std::remove(path.c_str());
+}
+
+TEST(SnapshotTest, testKeepsUnfinishedSearch) {
+    Map map_test(40, 40);
+    DStarLitePlanner planner_test(&map_test);
+    PrepareRun(&map_test, &planner_test);
+    SearchBudget budget;
+    budget.max_expansions = 5;
+    ASSERT_EQ(planner_test.ComputeShortestPath(budget), SearchStatus::kPartial);
+    auto path = TempPath("partial");
+    planner_test.SaveSnapshot(path);
+
+    // a planner whose own search converged takes over the unfinished one
+    Map loaded_map(10, 10);
+    loaded_map.SetGoal(std::make_pair(0, 0));
+    loaded_map.SetStart(std::make_pair(9, 9));
+    DStarLitePlanner loaded_planner(&loaded_map);
+    loaded_planner.Initialize();
+    loaded_planner.ComputeShortestPath();
+    ASSERT_TRUE(loaded_planner.Converged());
+    loaded_planner.LoadSnapshot(path);
+    EXPECT_FALSE(loaded_planner.Converged());
+    EXPECT_EQ(loaded_planner.NextMove(), planner_test.NextMove());
+
+    planner_test.ComputeShortestPath();
+    planner_test.SaveSnapshot(path);
+    loaded_planner.LoadSnapshot(path);
+    std::remove(path.c_str());
+    EXPECT_TRUE(loaded_planner.Converged());
+    EXPECT_EQ(loaded_planner.NextMove(), planner_test.NextMove());
+}
+
+TEST(SnapshotTest, testFrontierAndCostTypes) {
+    BasicMap<FixedCost> map_test(10, 10);
+    map_test.SetGoal(std::make_pair(0, 0));
+    map_test.SetStart(std::make_pair(9, 9));
+    BasicDStarLitePlanner<OpenList, BasicMap<FixedCost>> planner_test(
+        &map_test);
+    planner_test.SetFrontier({FrontierCost{std::make_pair(9, 0), 1.5}});
+    planner_test.Initialize();
+    auto path = TempPath("fixed");
+    planner_test.SaveSnapshot(path);
+
+    BasicMap<FixedCost> loaded_map(10, 10);
+    BasicDStarLitePlanner<OpenList, BasicMap<FixedCost>> loaded_planner(
+        &loaded_map);
+    loaded_planner.LoadSnapshot(path);
+    loaded_planner.ComputeShortestPath();
+    planner_test.ComputeShortestPath();
+    EXPECT_EQ(loaded_map.CurrentCellG(std::make_pair(9, 9)), 10.5);
+    EXPECT_EQ(loaded_map.CurrentCellG(std::make_pair(9, 9)),
+              map_test.CurrentCellG(std::make_pair(9, 9)));
+
+    // another cost type or connectivity is refused
+    Map double_map(10, 10);
+    DStarLitePlanner double_planner(&double_map);
+    EXPECT_THROW(double_planner.LoadSnapshot(path), std::runtime_error);
+    BasicMap<FixedCost, FourConnected> four_map(10, 10);
+    BasicDStarLitePlanner<OpenList, BasicMap<FixedCost, FourConnected>>
+        four_planner(&four_map);
+    EXPECT_THROW(four_planner.LoadSnapshot(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(SnapshotTest, testRejectsBadFiles) {
+    Map map_test(10, 10);
+    DStarLitePlanner planner_test(&map_test);
+    EXPECT_THROW(planner_test.LoadSnapshot(TempPath("missing")),
+                 std::runtime_error);
+    auto path = TempPath("bad");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << std::string(300, 'z');
+    }
+    EXPECT_THROW(planner_test.LoadSnapshot(path), std::runtime_error);
+
+    map_test.SetGoal(std::make_pair(0, 0));
+    map_test.SetStart(std::make_pair(9, 9));
+    planner_test.Initialize();
+    planner_test.ComputeShortestPath();
+    planner_test.SaveSnapshot(path);
+    truncate(path.c_str(), 2000);
+    EXPECT_THROW(planner_test.LoadSnapshot(path), std::runtime_error);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,99 @@
+/**
+ * MIT Licence
+ * Copyright (c) 2018 Yu-Kai Wang
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ */
+
+/**
+ * @file ThreadPoolTest.cpp
+ * @author Yu-Kai Wang
+ * @copyright MIT License
+ *
+ * @brief D* Lite Path Planning
+ *
+ * Test cases for the "ThreadPool" class
+ * 
+ */
+
+#include "ThreadPool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(ThreadPoolTest, testRunsEveryTask) {
+    ThreadPool pool_test(4);
+    EXPECT_EQ(pool_test.ThreadNum(), 4);
+    std::vector<int> done(1000, 0);
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < 1000; ++i)
+            pool_test.Submit([&done, i] { ++done[i]; });
+        pool_test.Wait();
+    }
+    for (auto const &count : done) EXPECT_EQ(count, 2);
+    EXPECT_THROW(ThreadPool(0), std::invalid_argument);
+}
+
+TEST(ThreadPoolTest, testStealsFromBusyThreads) {
+    // every fourth task is slow; the others are stolen around it
+    ThreadPool pool_test(4);
+    std::atomic<int> finished(0);
+    for (int i = 0; i < 40; ++i) {
+        pool_test.Submit([&finished, i] {
+            if (i % 4 == 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            ++finished;
+        });
+    }
+    pool_test.Wait();
+    EXPECT_EQ(finished.load(), 40);
+}
+
+TEST(ThreadPoolTest, testRethrowsTaskError) {
+    ThreadPool pool_test(2);
+    std::atomic<int> finished(0);
+    pool_test.Submit([] { throw std::runtime_error("broken task"); });
+    for (int i = 0; i < 10; ++i) pool_test.Submit([&finished] { ++finished; });
+    EXPECT_THROW(pool_test.Wait(), std::runtime_error);
+    EXPECT_EQ(finished.load(), 10);
+    // the error is reported once
+    pool_test.Submit([&finished] { ++finished; });
+    pool_test.Wait();
+    EXPECT_EQ(finished.load(), 11);
+}
+
+TEST(ThreadPoolTest, testConcurrentSubmitters) {
+    // submitters and workers only meet at the queue of each task
+    ThreadPool pool_test(3);
+    std::atomic<int> finished(0);
+    std::vector<std::thread> submitters;
+    for (int s = 0; s < 4; ++s) {
+        submitters.emplace_back([&pool_test, &finished] {
+            for (int i = 0; i < 500; ++i)
+                pool_test.Submit([&finished] { ++finished; });
+        });
+    }
+    for (auto &submitter : submitters) submitter.join();
+    pool_test.Wait();
+    EXPECT_EQ(finished.load(), 4 * 500);
+}